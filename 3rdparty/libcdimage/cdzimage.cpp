@@ -0,0 +1,249 @@
+#include "cdzimage.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <zlib.h>
+
+CdzImage::CdzImage()
+{
+    std::memset(&header, 0, sizeof(header));
+    inflater = nullptr;
+    useCounter = 0;
+    cacheHits = 0;
+    cacheMisses = 0;
+}
+
+CdzImage::~CdzImage()
+{
+    close();
+}
+
+bool CdzImage::open(const std::string& fileName)
+{
+    close();
+
+    image.open(fileName, std::ios::binary | std::ios::in);
+    if (!image.is_open() || image.fail())
+        return false;
+
+    image.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(image.tellg());
+    image.seekg(0, std::ios::beg);
+
+    // Hunks larger than the writer ever makes are refused, they would only size the cache from untrusted data
+    image.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (image.fail() ||
+        std::memcmp(header.magic, cdz_magic, sizeof(cdz_magic)) != 0 ||
+        header.version != cdz_version ||
+        header.hunkSectors == 0 ||
+        header.hunkSectors > cdz_hunk_sectors ||
+        header.hunkCount != (header.sectorCount + header.hunkSectors - 1) / header.hunkSectors)
+    {
+        close();
+        return false;
+    }
+
+    // The index has to fit in the file before it is allocated
+    uint64_t dataStart = sizeof(header) + (static_cast<uint64_t>(header.hunkCount) + 1) * sizeof(uint64_t);
+    if (dataStart > fileSize)
+    {
+        close();
+        return false;
+    }
+
+    // Offsets are sorted, every hunk lies within the file when the first and last ones do
+    hunkOffsets.resize(static_cast<size_t>(header.hunkCount) + 1);
+    image.read(reinterpret_cast<char*>(hunkOffsets.data()), hunkOffsets.size() * sizeof(uint64_t));
+    if (image.fail() || !std::is_sorted(hunkOffsets.begin(), hunkOffsets.end()) ||
+        hunkOffsets.front() < dataStart || hunkOffsets.back() > fileSize)
+    {
+        close();
+        return false;
+    }
+
+    z_stream* stream = new z_stream{};
+    if (inflateInit(stream) != Z_OK)
+    {
+        delete stream;
+        close();
+        return false;
+    }
+    inflater = stream;
+
+    hunkSlots.assign(header.hunkCount, -1);
+    cache.resize(std::min<size_t>(cdz_cache_hunks, header.hunkCount));
+    for (auto& entry : cache)
+    {
+        entry.hunk = 0;
+        entry.lastUse = 0;
+        entry.data.reserve(static_cast<size_t>(header.hunkSectors) * sector_size);
+    }
+    return true;
+}
+
+void CdzImage::close()
+{
+    if (inflater != nullptr)
+    {
+        inflateEnd(static_cast<z_stream*>(inflater));
+        delete static_cast<z_stream*>(inflater);
+        inflater = nullptr;
+    }
+
+    if (image.is_open())
+        image.close();
+    image.clear();
+
+    std::memset(&header, 0, sizeof(header));
+    hunkOffsets.clear();
+    hunkSlots.clear();
+    cache.clear();
+    useCounter = 0;
+    cacheHits = 0;
+    cacheMisses = 0;
+}
+
+bool CdzImage::loadHunk(uint32_t hunk, std::vector<uint8_t>& data)
+{
+    uint32_t firstSector = hunk * header.hunkSectors;
+    size_t rawSize = static_cast<size_t>(std::min(header.hunkSectors, header.sectorCount - firstSector)) * sector_size;
+    uint64_t storedSize = hunkOffsets[hunk + 1] - hunkOffsets[hunk];
+    if (storedSize == 0 || storedSize > rawSize + rawSize / 2)
+        return false;
+
+    data.resize(rawSize);
+
+    // Incompressible hunks are stored as they are and read straight into the cache
+    image.clear();
+    image.seekg(static_cast<std::streamoff>(hunkOffsets[hunk]), std::ios::beg);
+    if (storedSize == rawSize)
+    {
+        image.read(reinterpret_cast<char*>(data.data()), rawSize);
+        return !image.fail();
+    }
+
+    compressed.resize(storedSize);
+    image.read(reinterpret_cast<char*>(compressed.data()), storedSize);
+    if (image.fail())
+        return false;
+
+    z_stream* stream = static_cast<z_stream*>(inflater);
+    inflateReset(stream);
+    stream->next_in = compressed.data();
+    stream->avail_in = static_cast<uInt>(storedSize);
+    stream->next_out = data.data();
+    stream->avail_out = static_cast<uInt>(rawSize);
+
+    return inflate(stream, Z_FINISH) == Z_STREAM_END && stream->avail_out == 0;
+}
+
+std::span<const uint8_t> CdzImage::readSector(uint32_t index)
+{
+    if (index >= header.sectorCount)
+        return {};
+
+    uint32_t hunk = index / header.hunkSectors;
+    int16_t slot = hunkSlots[hunk];
+
+    if (slot >= 0)
+    {
+        cacheHits++;
+    }
+    else
+    {
+        cacheMisses++;
+
+        // Replace the least recently used entry, empty entries have never been used
+        slot = 0;
+        for (int16_t i = 1; i < static_cast<int16_t>(cache.size()); i++)
+        {
+            if (cache[i].lastUse < cache[slot].lastUse)
+                slot = i;
+        }
+
+        CacheEntry& entry = cache[slot];
+        if (entry.lastUse != 0)
+            hunkSlots[entry.hunk] = -1;
+        entry.lastUse = 0;
+
+        if (!loadHunk(hunk, entry.data))
+            return {};
+
+        entry.hunk = hunk;
+        hunkSlots[hunk] = slot;
+    }
+
+    CacheEntry& entry = cache[slot];
+    entry.lastUse = ++useCounter;
+
+    size_t offset = static_cast<size_t>(index - hunk * header.hunkSectors) * sector_size;
+    return std::span<const uint8_t>(entry.data.data() + offset, sector_size);
+}
+
+bool CdzImage::convert(const std::string& sourceFile, const std::string& cdzFile, int level)
+{
+    // Resolve the raw image the same way CdImage::openImage does
+    std::string binFile = sourceFile;
+    size_t dotPos = sourceFile.find_last_of('.');
+    if (dotPos != std::string::npos && sourceFile.substr(dotPos + 1) == "cue")
+        binFile = sourceFile.substr(0, dotPos) + ".bin";
+
+    std::ifstream source(binFile, std::ios::binary | std::ios::in);
+    if (!source.is_open())
+        return false;
+
+    source.seekg(0, std::ios::end);
+    uint64_t sourceSize = static_cast<uint64_t>(source.tellg());
+    source.seekg(0, std::ios::beg);
+
+    CdzHeader cdzHeader;
+    std::memset(&cdzHeader, 0, sizeof(cdzHeader));
+    std::memcpy(cdzHeader.magic, cdz_magic, sizeof(cdz_magic));
+    cdzHeader.version = cdz_version;
+    cdzHeader.sectorCount = static_cast<uint32_t>(sourceSize / sector_size);
+    cdzHeader.hunkSectors = cdz_hunk_sectors;
+    cdzHeader.hunkCount = (cdzHeader.sectorCount + cdz_hunk_sectors - 1) / cdz_hunk_sectors;
+    if (cdzHeader.sectorCount == 0)
+        return false;
+
+    std::ofstream output(cdzFile, std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!output.is_open())
+        return false;
+
+    // The index is written again once all the hunk sizes are known
+    std::vector<uint64_t> offsets(static_cast<size_t>(cdzHeader.hunkCount) + 1);
+    offsets[0] = sizeof(cdzHeader) + offsets.size() * sizeof(uint64_t);
+    output.write(reinterpret_cast<const char*>(&cdzHeader), sizeof(cdzHeader));
+    output.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    std::vector<uint8_t> raw(static_cast<size_t>(cdz_hunk_sectors) * sector_size);
+    std::vector<uint8_t> packed(compressBound(static_cast<uLong>(raw.size())));
+
+    for (uint32_t hunk = 0; hunk < cdzHeader.hunkCount; hunk++)
+    {
+        uint32_t sectors = std::min<uint32_t>(cdz_hunk_sectors, cdzHeader.sectorCount - hunk * cdz_hunk_sectors);
+        size_t rawSize = static_cast<size_t>(sectors) * sector_size;
+
+        source.read(reinterpret_cast<char*>(raw.data()), rawSize);
+        if (source.fail())
+            return false;
+
+        uLongf packedSize = static_cast<uLongf>(packed.size());
+        bool deflated = compress2(packed.data(), &packedSize, raw.data(), static_cast<uLong>(rawSize), level) == Z_OK;
+
+        // Keep the raw sectors when deflate doesn't gain anything, the reader tells them apart by size
+        if (deflated && packedSize < rawSize)
+            output.write(reinterpret_cast<const char*>(packed.data()), packedSize);
+        else
+            output.write(reinterpret_cast<const char*>(raw.data()), rawSize);
+
+        offsets[hunk + 1] = offsets[hunk] + ((deflated && packedSize < rawSize) ? packedSize : rawSize);
+    }
+
+    output.seekp(sizeof(cdzHeader), std::ios::beg);
+    output.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    output.close();
+
+    return !output.fail();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <span>
+#include <vector>
+
+#include "libcdimage.h"
+
+// Block compressed image (.cdz). Sectors are grouped in hunks of cdz_hunk_sectors raw sectors,
+// each hunk is deflated on its own so any sector can be reached by decompressing a single hunk.
+//
+// Layout, all fields little endian:
+//   CdzHeader
+//   uint64_t hunk offsets [hunkCount + 1], the last one is the end of the data
+//   hunk data, a hunk whose stored size equals its raw size is not compressed
+constexpr char cdz_magic[4] = { 'C', 'D', 'Z', '1' };
+constexpr auto cdz_version = 1;
+constexpr auto cdz_hunk_sectors = 8;        // 18816 bytes, inflated in a few tens of microseconds
+constexpr auto cdz_cache_hunks = 16;        // Decompressed hunks kept by each reader
+
+struct CdzHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sectorCount;
+    uint32_t hunkSectors;
+    uint32_t hunkCount;
+    uint32_t reserved;
+};
+
+class CdzImage
+{
+public:
+    CdzImage();
+    ~CdzImage();
+
+    CdzImage(const CdzImage&) = delete;
+    CdzImage& operator=(const CdzImage&) = delete;
+
+    bool open(const std::string& fileName);
+    void close();
+    bool isOpen() const { return image.is_open(); }
+
+    // Sector view into the hunk cache, valid until the next call. Empty past the end or on a corrupted hunk
+    std::span<const uint8_t> readSector(uint32_t index);
+
+    uint32_t getSectorCount() const { return header.sectorCount; }
+    uint64_t getCacheHits() const { return cacheHits; }
+    uint64_t getCacheMisses() const { return cacheMisses; }
+
+    // Compress a raw image, a .cue is resolved to the .bin with the same name like CdImage::openImage does
+    static bool convert(const std::string& sourceFile, const std::string& cdzFile, int level = 9);
+
+private:
+    // Decompressed hunk, the least recently used one is replaced on a miss
+    struct CacheEntry {
+        uint32_t hunk;
+        uint64_t lastUse;
+        std::vector<uint8_t> data;
+    };
+
+    bool loadHunk(uint32_t hunk, std::vector<uint8_t>& data);
+
+    std::ifstream image;
+    CdzHeader header;
+    std::vector<uint64_t> hunkOffsets;      // Hunk index, hunk of a sector is index / hunkSectors
+    std::vector<int16_t> hunkSlots;         // Cache entry holding each hunk, -1 when not cached
+    std::vector<CacheEntry> cache;
+    std::vector<uint8_t> compressed;        // Staging buffer of the stored hunk
+    void* inflater;                         // z_stream, reset for every hunk instead of allocated again
+    uint64_t useCounter;
+    uint64_t cacheHits;
+    uint64_t cacheMisses;
+};
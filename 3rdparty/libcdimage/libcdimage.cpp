@@ -1,9 +1,33 @@
 #include "libcdimage.h"
+#include "cdzimage.h"
+
+#include <algorithm>
+
+#if defined(PLATFORM_WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 CdImage::CdImage()
 {
+    mappedData = nullptr;
+    mappedSize = 0;
+#if defined(PLATFORM_WINDOWS)
+    mappingHandle = nullptr;
+#endif
+    sectorCount = 0;
     sectorOffset = 0;
     sectorTarget = 0;
+    readIndex = 0;
+    prefetchStop = false;
+    prefetchStart = 0;
+    prefetchCount = 0;
+    prefetchHits = 0;
+    prefetchMisses = 0;
     sectorInfo.mm = 0;
     sectorInfo.ss = 0;
     sectorInfo.ff = 0;
@@ -29,37 +53,101 @@ uint32_t CdImage::calculateLBA(uint8_t mm, uint8_t ss, uint8_t ff)
 
 bool CdImage::readSectorHeader()
 {
-    char header[sector_header_size];
-    char subheader[sector_subheader_size];
-
-    image.seekg(0, std::ios::beg);
-    image.read(header, sector_header_size);
-    
-    if (image.fail() || image.gcount() != sector_header_size)
+    std::span<const uint8_t> sector = sectorAt(0);
+    if (sector.empty())
         return false;
 
     // Extract header information
-    sectorInfo.mm = header[12];
-    sectorInfo.ss = header[13];
-    sectorInfo.ff = header[14];
-    sectorInfo.mode = header[15];
-    sectorInfo.lba = calculateLBA(bcdToDecimal(sectorInfo.mm), 
-                                   bcdToDecimal(sectorInfo.ss), 
+    sectorInfo.mm = sector[12];
+    sectorInfo.ss = sector[13];
+    sectorInfo.ff = sector[14];
+    sectorInfo.mode = sector[15];
+    sectorInfo.lba = calculateLBA(bcdToDecimal(sectorInfo.mm),
+                                   bcdToDecimal(sectorInfo.ss),
                                    bcdToDecimal(sectorInfo.ff));
     sectorOffset = sectorInfo.lba;
 
-    // Read subheader for Mode 2 detection
-    image.read(subheader, sector_subheader_size);
-    
-    if (image.fail() || image.gcount() != sector_subheader_size)
+    // Subheader for Mode 2 detection
+    uint8_t subMode = sector[sector_header_size + 2];
+    sectorInfo.form = (subMode & 0x20) ? 2 : 1;
+
+    return true;
+}
+
+bool CdImage::mapImage(const std::string& imageFile)
+{
+#if defined(PLATFORM_WINDOWS)
+    HANDLE file = CreateFileA(imageFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
         return false;
 
-    uint8_t subMode = static_cast<uint8_t>(subheader[2]);
-    sectorInfo.form = (subMode & 0x20) ? 2 : 1;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The mapping keeps the file open on its own
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mappingHandle == nullptr)
+        return false;
 
+    mappedData = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (mappedData == nullptr)
+    {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+        return false;
+    }
+    mappedSize = static_cast<uint64_t>(size.QuadPart);
+#else
+    int file = open(imageFile.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    // The mapping keeps the file open on its own
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+        return false;
+
+    // Sectors are mostly read in sequence, let the kernel read ahead
+    madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    mappedData = static_cast<const uint8_t*>(data);
+    mappedSize = static_cast<uint64_t>(info.st_size);
+#endif
+
+    sectorCount = static_cast<uint32_t>(mappedSize / sector_size);
     return true;
 }
 
+void CdImage::unmapImage()
+{
+    if (mappedData == nullptr)
+        return;
+
+#if defined(PLATFORM_WINDOWS)
+    UnmapViewOfFile(mappedData);
+    CloseHandle(mappingHandle);
+    mappingHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(mappedData), static_cast<size_t>(mappedSize));
+#endif
+
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
 bool CdImage::openImage(const std::string& fileName)
 {
     // Close any previously open image
@@ -75,19 +163,36 @@ bool CdImage::openImage(const std::string& fileName)
 
     // Determine actual image file to open
     std::string imageFile;
-    
+
     if (extension == "cue")
         imageFile = baseName + ".bin";
-    else if (extension == "bin" || extension == "img")
+    else if (extension == "bin" || extension == "img" || extension == "cdz")
         imageFile = fileName;
     else
         return false; // Unsupported format
 
-    // Open the image file
-    image.open(imageFile, std::ios::binary | std::ios::in);
-    
-    if (!image.is_open() || image.fail())
-        return false;
+    if (extension == "cdz")
+    {
+        compressedImage = std::make_unique<CdzImage>();
+        if (!compressedImage->open(imageFile))
+        {
+            compressedImage.reset();
+            return false;
+        }
+        sectorCount = compressedImage->getSectorCount();
+    }
+    // Map the image file, fall back to stream reads if the OS refuses
+    else if (!mapImage(imageFile))
+    {
+        image.open(imageFile, std::ios::binary | std::ios::in);
+
+        if (!image.is_open() || image.fail())
+            return false;
+
+        image.seekg(0, std::ios::end);
+        sectorCount = static_cast<uint32_t>(static_cast<uint64_t>(image.tellg()) / sector_size);
+        image.seekg(0, std::ios::beg);
+    }
 
     // Read and parse first sector header
     if (!readSectorHeader())
@@ -96,12 +201,21 @@ bool CdImage::openImage(const std::string& fileName)
         return false;
     }
 
+    readIndex = 0;
     this->fileName = imageFile;
+
+    startPrefetch();
     return true;
 }
 
 bool CdImage::closeImage()
 {
+    // The read-ahead thread uses the mapping
+    stopPrefetch();
+    unmapImage();
+    compressedImage.reset();
+    sectorCount = 0;
+
     if (image.is_open())
     {
         image.close();
@@ -118,42 +232,243 @@ void CdImage::setLocation(uint8_t min, uint8_t sec, uint8_t frac)
 
     // Calculate target LBA
     uint32_t targetLBA = calculateLBA(minDec, secDec, fracDec);
-    
+
     // Calculate actual sector position
     sectorTarget = targetLBA;
+
+    // A read usually follows, start fetching the target
+    if (sectorCount != 0)
+        prefetchFrom(sectorTarget - sectorOffset);
 }
 
 bool CdImage::seekSector()
 {
-    if (!image.is_open())
+    if (sectorCount == 0)
         return false;
 
-    // Calculate file position based on target sector and offset
-    uint32_t sectorIndex = sectorTarget - sectorOffset;
-    std::streampos position = static_cast<std::streampos>(sectorIndex) * sector_size;
+    // Sector position based on target sector and offset
+    readIndex = sectorTarget - sectorOffset;
+    prefetchFrom(readIndex);
 
-    image.seekg(position, std::ios::beg);
-    
-    return !image.fail();
+    return readIndex < sectorCount;
 }
 
-int CdImage::readSector(char* buf)
+uint32_t CdImage::getReadSector()
 {
-    if (!image.is_open() || buf == nullptr)
-        return 0;
+    if (sectorCount == 0)
+        return sectorTarget;
+
+    return sectorOffset + readIndex;
+}
+
+bool CdImage::setReadSector(uint32_t target, uint32_t sector)
+{
+    sectorTarget = target;
+
+    if (sectorCount == 0)
+        return false;
+
+    readIndex = sector - sectorOffset;
+    prefetchFrom(readIndex);
+
+    return readIndex < sectorCount;
+}
+
+std::span<const uint8_t> CdImage::sectorAt(uint32_t index)
+{
+    if (index >= sectorCount)
+        return {};
+
+    if (mappedData != nullptr)
+        return std::span<const uint8_t>(mappedData + static_cast<uint64_t>(index) * sector_size, sector_size);
 
-    // Read full sector into temporary buffer
-    char sectorData[sector_size];
-    
-    image.read(sectorData, sector_size);
-    
-    if (image.fail())
+    if (compressedImage != nullptr)
+        return compressedImage->readSector(index);
+
+    // Clear any end of file condition left by the previous read
+    image.clear();
+    image.seekg(static_cast<std::streampos>(index) * sector_size, std::ios::beg);
+    image.read(reinterpret_cast<char*>(sectorBuffer), sector_size);
+
+    if (image.fail() || image.gcount() != sector_size)
+        return {};
+
+    return std::span<const uint8_t>(sectorBuffer, sector_size);
+}
+
+std::span<const uint8_t> CdImage::readSectorRaw()
+{
+    // Read the sector inline only when the read-ahead thread is behind
+    std::span<const uint8_t> sector = prefetchedSector(readIndex);
+    if (sector.empty())
+        sector = sectorAt(readIndex);
+
+    if (!sector.empty())
+        readIndex++;
+
+    return sector;
+}
+
+std::span<const uint8_t> CdImage::getSectorRaw(uint32_t lba)
+{
+    return sectorAt(lba - sectorOffset);
+}
+
+void CdImage::startPrefetch()
+{
+    prefetchStop = false;
+    prefetchStart = 0;
+    prefetchCount = 0;
+    prefetchHits = 0;
+    prefetchMisses = 0;
+
+    if (mappedData == nullptr)
+        prefetchSlots.resize(static_cast<size_t>(prefetch_sectors) * sector_size);
+
+    prefetchThread = std::thread(&CdImage::prefetchLoop, this);
+}
+
+void CdImage::stopPrefetch()
+{
+    if (!prefetchThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+        prefetchStop = true;
+    }
+    prefetchWake.notify_one();
+    prefetchThread.join();
+
+    prefetchSlots.clear();
+    prefetchSlots.shrink_to_fit();
+}
+
+void CdImage::prefetchFrom(uint32_t index)
+{
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+
+        // Sectors already fetched after the new position are kept
+        if (index >= prefetchStart && index < prefetchStart + prefetchCount)
+        {
+            prefetchCount -= index - prefetchStart;
+            prefetchStart = index;
+            return;
+        }
+
+        prefetchStart = index;
+        prefetchCount = 0;
+    }
+    prefetchWake.notify_one();
+}
+
+std::span<const uint8_t> CdImage::prefetchedSector(uint32_t index)
+{
+    if (!prefetchThread.joinable() || index >= sectorCount)
+        return {};
+
+    bool hit;
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex);
+
+        hit = index >= prefetchStart && index < prefetchStart + prefetchCount;
+
+        // Slots are handed back to the read-ahead thread right away, the sector is moved to the buffer of
+        // the emulation thread. A copy in memory is nothing compared to the read it replaces.
+        if (hit && mappedData == nullptr)
+        {
+            const uint8_t* slot = prefetchSlots.data() + static_cast<size_t>(index % prefetch_sectors) * sector_size;
+            std::copy(slot, slot + sector_size, sectorBuffer);
+        }
+
+        // Sectors up to the requested one are released. On a miss the caller reads it inline, keep fetching after it
+        prefetchCount = hit ? prefetchCount - (index + 1 - prefetchStart) : 0;
+        prefetchStart = index + 1;
+    }
+    prefetchWake.notify_one();
+
+    if (!hit)
+    {
+        prefetchMisses.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    prefetchHits.fetch_add(1, std::memory_order_relaxed);
+
+    if (mappedData != nullptr)
+        return std::span<const uint8_t>(mappedData + static_cast<uint64_t>(index) * sector_size, sector_size);
+
+    return std::span<const uint8_t>(sectorBuffer, sector_size);
+}
+
+void CdImage::prefetchLoop()
+{
+    // Stream reads go through a private file handle, the one of the emulation thread is never shared.
+    // Compressed images get a reader of their own too, with its own hunk cache
+    std::ifstream file;
+    CdzImage reader;
+    if (compressedImage != nullptr)
+        reader.open(fileName);
+    else if (mappedData == nullptr)
+        file.open(fileName, std::ios::binary | std::ios::in);
+
+    std::unique_lock<std::mutex> lock(prefetchMutex);
+
+    while (!prefetchStop)
+    {
+        uint32_t target = prefetchStart + prefetchCount;
+        if (prefetchCount >= prefetch_sectors || target >= sectorCount)
+        {
+            prefetchWake.wait(lock);
+            continue;
+        }
+        lock.unlock();
+
+        // The slot of the target is not in the window, nobody else is using it
+        bool fetched = true;
+        if (mappedData != nullptr)
+        {
+            // Fault in the pages of the sector, the mapping itself is the buffer
+            const volatile uint8_t* data = mappedData + static_cast<uint64_t>(target) * sector_size;
+            uint8_t sink = 0;
+            for (int i = 0; i < sector_size; i += 1024)
+                sink ^= data[i];
+            sink ^= data[sector_size - 1];
+            (void)sink;
+        }
+        else if (compressedImage != nullptr)
+        {
+            std::span<const uint8_t> sector = reader.readSector(target);
+            std::copy(sector.begin(), sector.end(), prefetchSlots.data() + static_cast<size_t>(target % prefetch_sectors) * sector_size);
+            fetched = !sector.empty();
+        }
+        else
+        {
+            file.clear();
+            file.seekg(static_cast<std::streampos>(target) * sector_size, std::ios::beg);
+            file.read(reinterpret_cast<char*>(prefetchSlots.data() + static_cast<size_t>(target % prefetch_sectors) * sector_size), sector_size);
+            fetched = !file.fail() && file.gcount() == sector_size;
+        }
+
+        lock.lock();
+
+        // Drop the sector if the window moved while it was being read
+        if (fetched && target == prefetchStart + prefetchCount)
+            prefetchCount++;
+        else if (!fetched)
+            prefetchWake.wait(lock);
+    }
+}
+
+int CdImage::readSector(char* buf)
+{
+    if (buf == nullptr)
         return 0;
 
-    int bytesRead = static_cast<int>(image.gcount());
-    
     //if read less than full sector, return 0
-    if (bytesRead < sector_size)
+    std::span<const uint8_t> sector = readSectorRaw();
+    if (sector.empty())
         return 0;
 
     // Determine payload offset based on mode
@@ -170,8 +485,8 @@ int CdImage::readSector(char* buf)
     }
 
     // Copy exactly sector_payload_size bytes
-    std::copy(sectorData + payloadOffset, 
-              sectorData + payloadOffset + sector_payload_size, 
+    std::copy(sector.begin() + payloadOffset,
+              sector.begin() + payloadOffset + sector_payload_size,
               buf);
 
     return sector_payload_size;
@@ -3,6 +3,13 @@
 #include <cstdint>
 #include <string>
 #include <fstream>
+#include <span>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 constexpr auto sector_size = 2352;	//2352 bytes
 
@@ -15,6 +22,10 @@ constexpr auto sector_payload_mode1_size = 2048;
 constexpr auto sector_tail_mode1_size = 288;
 constexpr auto sector_payload_mode2_size = 2336;
 
+constexpr auto prefetch_sectors = 64;	// Sectors kept ahead of the read position by the read-ahead thread
+
+class CdzImage;
+
 // Sector information structure
 struct SectorInfo {
     uint8_t mm;
@@ -39,23 +50,73 @@ public:
     bool seekSector();
     int readSector(char* buf);
 
+    // Raw sector access. Memory mapped images return a view of the mapping (no copy, no system call),
+    // otherwise a view of an internal buffer valid until the next read. Empty past the end of the image.
+    std::span<const uint8_t> readSectorRaw();               // Sector at the read position, then moves to the next one
+    std::span<const uint8_t> getSectorRaw(uint32_t lba);    // Any sector, the read position is not changed
+
     // Getter methods
     uint32_t getSectorOffset() const { return sectorOffset; }
     uint32_t getSectorTarget() const { return sectorTarget; }
     uint8_t getImageMode() const { return sectorInfo.mode; }
     uint8_t getImageForm() const { return sectorInfo.form; }
     const SectorInfo& getSectorInfo() const { return sectorInfo; }
+    bool isMapped() const { return mappedData != nullptr; }
+    bool isCompressed() const { return compressedImage != nullptr; }
+
+    // Read-ahead statistics, sectors found ready or read inline by readSectorRaw
+    uint64_t getPrefetchHits() const { return prefetchHits.load(std::memory_order_relaxed); }
+    uint64_t getPrefetchMisses() const { return prefetchMisses.load(std::memory_order_relaxed); }
+
+    // Read position methods, LBA of the next sector returned by readSector
+    uint32_t getReadSector();
+    bool setReadSector(uint32_t target, uint32_t sector);
 
 private:
     // Helper methods
     uint8_t bcdToDecimal(uint8_t bcd);
     uint32_t calculateLBA(uint8_t mm, uint8_t ss, uint8_t ff);
     bool readSectorHeader();
+    bool mapImage(const std::string& imageFile);
+    void unmapImage();
+    std::span<const uint8_t> sectorAt(uint32_t index);
+
+    // Read-ahead thread
+    void startPrefetch();
+    void stopPrefetch();
+    void prefetchFrom(uint32_t index);
+    std::span<const uint8_t> prefetchedSector(uint32_t index);
+    void prefetchLoop();
 
     std::string fileName;
     std::ifstream image;
 
+    // Block compressed image, sectors come from its hunk cache
+    std::unique_ptr<CdzImage> compressedImage;
+
+    // Memory mapped image, the stream is only used when mapping is not possible
+    const uint8_t* mappedData;
+    uint64_t mappedSize;
+#if defined(PLATFORM_WINDOWS)
+    void* mappingHandle;
+#endif
+    uint32_t sectorCount;       // Number of whole sectors in the image
+    uint8_t sectorBuffer[sector_size];
+
     SectorInfo sectorInfo;      // First sector information
     uint32_t sectorOffset;      // LBA offset from first sector
     uint32_t sectorTarget;      // Target sector LBA, updated by setLocation
-};
\ No newline at end of file
+    uint32_t readIndex;         // Index in the image of the next sector to read
+
+    // Read-ahead window [prefetchStart, prefetchStart + prefetchCount) holds sectors ready to be read.
+    // The mutex only guards the window, disk I/O runs outside of it.
+    std::thread prefetchThread;
+    std::mutex prefetchMutex;
+    std::condition_variable prefetchWake;
+    bool prefetchStop;
+    uint32_t prefetchStart;
+    uint32_t prefetchCount;
+    std::vector<uint8_t> prefetchSlots;     // Sector copies, not used by memory mapped images
+    std::atomic<uint64_t> prefetchHits;
+    std::atomic<uint64_t> prefetchMisses;
+};
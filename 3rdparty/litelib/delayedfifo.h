@@ -22,6 +22,8 @@ namespace lite
         void    flush();                                                                //empty the fifo
         bool    isfull();                                                               //check if the fifo is full
         bool    isempty();                                                              //check if the fifo is empty
+        int     delayleft();                                                            //return the remaining delay of the first record
+        void    elapse(int _ticks);                                                     //count down the delay of the first record
         T&      operator[](size_t index);                                               //access element by index
         const T& operator[](size_t index) const;                                        //const access element by index
 
@@ -141,7 +143,20 @@ namespace lite
     inline bool delayedfifo<T, size>::isempty()
     {
         return (writePtr - readPtr) == 0;
-    };   
+    };
+
+    template<typename T, size_t size>
+    inline int delayedfifo<T, size>::delayleft()
+    {
+        return isempty() ? 0 : delay[readPtr % size];
+    };
+
+    template<typename T, size_t size>
+    inline void delayedfifo<T, size>::elapse(int _ticks)
+    {
+        if (!isempty())
+            delay[readPtr % size] = (delay[readPtr % size] > _ticks) ? delay[readPtr % size] - _ticks : 0;
+    };
 };
 
 
@@ -18,6 +18,7 @@ namespace lite
         bool    push(const T& value);                  //push a record on the fifo
         bool    push(const std::vector<T>& value);     //push a vector on the fifo
         bool    pop(T& value);                         //pop a record from the fifo
+        size_t  pop(T* values, size_t count);          //pop up to count records, return the number of records popped
         size_t  length();                              //return fifo length in number of records
         void    flush();                               //empty the fifo
         bool    isfull();                              //check if the fifo is full
@@ -96,6 +97,26 @@ namespace lite
         return false;
     };
 
+    template<typename T, size_t size>
+    inline size_t fifo<T, size>::pop(T* values, size_t count)
+    {
+        size_t available = writePtr - readPtr;
+        if (count > available)
+            count = available;
+
+        for (size_t i = 0; i < count; i++)
+            values[i] = data[(readPtr + i) % size];
+        readPtr += static_cast<uint32_t>(count);
+
+        // reset pointers to avoid overflow
+        if (readPtr > size)
+        {
+            writePtr = writePtr % size;
+            readPtr = readPtr % size;
+        };
+        return count;
+    };
+
     template<typename T, size_t size>
     inline size_t fifo<T, size>::length()
     {
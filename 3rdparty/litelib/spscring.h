@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------
+// Lock-free Ring Buffer, one Producer thread and one Consumer thread
+//-------------------------------------------------------------------------------------
+
+namespace lite
+{
+    template <typename T, size_t size>
+    class spscring
+    {
+        static_assert((size & (size - 1)) == 0, "spscring size must be a power of two");
+
+    public:
+        spscring();
+        ~spscring();
+
+        //Producer Interface
+        bool    push(const T* values, size_t count);   //push count records, all or none. Records are dropped when there's not enough space
+        void    drain();                                //discard all the records pushed so far, done by the Consumer on its next pop
+
+        //Consumer Interface
+        size_t  pop(T* values, size_t count);          //pop up to count records, return the number of records popped
+
+        //Status, can be read from any thread
+        size_t   length() const;                       //return ring length in number of records
+        uint64_t overruns() const;                     //number of push dropped for lack of space
+        uint64_t underruns() const;                    //number of pop served with less records than requested
+
+    private:
+        alignas(64) std::atomic<size_t> readPtr;       //written by the Consumer only
+        alignas(64) std::atomic<size_t> writePtr;      //written by the Producer only
+        std::atomic<uint64_t> overrunCount;
+        std::atomic<uint64_t> underrunCount;
+        std::atomic<size_t> drainPtr;                  //written by the Producer, records before it are discarded
+        std::atomic<bool> drainRequest;
+        T data[size];
+    };
+
+    template<typename T, size_t size>
+    inline spscring<T, size>::spscring()
+    {
+        readPtr = 0;
+        writePtr = 0;
+        overrunCount = 0;
+        underrunCount = 0;
+        drainPtr = 0;
+        drainRequest = false;
+    };
+
+    template<typename T, size_t size>
+    inline spscring<T, size>::~spscring()
+    {
+        //Nothing to do
+    };
+
+    template<typename T, size_t size>
+    inline bool spscring<T, size>::push(const T* values, size_t count)
+    {
+        size_t write = writePtr.load(std::memory_order_relaxed);
+        size_t read = readPtr.load(std::memory_order_acquire);
+
+        if (size - (write - read) < count)
+        {
+            overrunCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        //Copy in two chunks when the records wrap around the end of the ring
+        size_t offset = write & (size - 1);
+        size_t first = std::min(count, size - offset);
+        std::copy(values, values + first, data + offset);
+        std::copy(values + first, values + count, data);
+
+        //Publish the records to the Consumer
+        writePtr.store(write + count, std::memory_order_release);
+        return true;
+    };
+
+    template<typename T, size_t size>
+    inline void spscring<T, size>::drain()
+    {
+        //Only the Consumer moves readPtr, it is asked to skip up to the current end of the ring
+        drainPtr.store(writePtr.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        drainRequest.store(true, std::memory_order_release);
+    };
+
+    template<typename T, size_t size>
+    inline size_t spscring<T, size>::pop(T* values, size_t count)
+    {
+        //Take the drain request before loading writePtr, records up to the drain point are then always visible
+        bool drainPending = drainRequest.exchange(false, std::memory_order_acquire);
+        size_t read = readPtr.load(std::memory_order_relaxed);
+        size_t write = writePtr.load(std::memory_order_acquire);
+
+        //A pop racing with the request may already be past the drain point
+        if (drainPending)
+        {
+            size_t drain = drainPtr.load(std::memory_order_relaxed);
+            if (drain - read <= write - read)
+                read = drain;
+        }
+
+        size_t available = write - read;
+        if (count > available)
+        {
+            underrunCount.fetch_add(1, std::memory_order_relaxed);
+            count = available;
+        }
+
+        size_t offset = read & (size - 1);
+        size_t first = std::min(count, size - offset);
+        std::copy(data + offset, data + offset + first, values);
+        std::copy(data, data + (count - first), values + first);
+
+        //Give the space back to the Producer
+        readPtr.store(read + count, std::memory_order_release);
+        return count;
+    };
+
+    template<typename T, size_t size>
+    inline size_t spscring<T, size>::length() const
+    {
+        return writePtr.load(std::memory_order_acquire) - readPtr.load(std::memory_order_acquire);
+    };
+
+    template<typename T, size_t size>
+    inline uint64_t spscring<T, size>::overruns() const
+    {
+        return overrunCount.load(std::memory_order_relaxed);
+    };
+
+    template<typename T, size_t size>
+    inline uint64_t spscring<T, size>::underruns() const
+    {
+        return underrunCount.load(std::memory_order_relaxed);
+    };
+};
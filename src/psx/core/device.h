@@ -1,20 +1,46 @@
 #pragma once
 
+#include <cstdint>
+
+#include "savestate.h"
+
 class Psx;
 
 class Device
 {
 public:
     virtual ~Device() = default;
+    //Catch up with the Master Clock by the given number of CPU cycles and schedule the next event.
+    //Called with zero cycles after a register write to reschedule only.
     virtual bool runTicks(uint32_t cycles) = 0;
 
+    //Run the device up to the given Master Clock value
+    bool syncTo(uint64_t clock)
+    {
+        uint32_t cycles = static_cast<uint32_t>(clock - syncClock);
+        syncClock = clock;
+        return runTicks(cycles);
+    }
+    void resetSync() { syncClock = 0; }
+
+    //Save State of the Device, including its position on the Master Clock
+    virtual bool serialize(SaveState& state) = 0;
+
 public:
     // Link to PSX instance
     virtual void link(Psx* instance) = 0;
 
+protected:
+    void serializeSync(SaveState& state)
+    {
+        state.value(ticks);
+        state.value(syncClock);
+    }
+
 protected:
     float   deviceClockFrequency;   //Device Clock Frequency
     float   cpuClockFrequency;      //CPU Clock Frequency
     float   clockRatio;             //Device to cpu Clock Ratio (CPU Clock is the Master Clock)
     float   ticks;                  //Device Number of accumulated clock Ticks
+    uint64_t syncClock = 0;         //Master Clock value the device has been run up to
 };
@@ -0,0 +1,68 @@
+#include "profiler.h"
+
+Profiler::Profiler()
+{
+	current = ProfileZone::Count;
+	start = std::chrono::steady_clock::now();
+	for (auto& time : zoneTime)
+		time = 0;
+}
+
+ProfileZone Profiler::enter(ProfileZone zone)
+{
+	auto& p = instance();
+
+	ProfileZone previous = p.current;
+	p.charge(std::chrono::steady_clock::now());
+	p.current = zone;
+
+	return previous;
+}
+
+void Profiler::leave(ProfileZone previous)
+{
+	auto& p = instance();
+
+	p.charge(std::chrono::steady_clock::now());
+	p.current = previous;
+}
+
+void Profiler::reset()
+{
+	auto& p = instance();
+
+	p.current = ProfileZone::Count;
+	p.start = std::chrono::steady_clock::now();
+	for (auto& time : p.zoneTime)
+		time = 0;
+}
+
+uint64_t Profiler::getNanoseconds(ProfileZone zone)
+{
+	return instance().zoneTime[static_cast<int>(zone)];
+}
+
+const char* Profiler::getName(ProfileZone zone)
+{
+	switch (zone)
+	{
+	case ProfileZone::Cpu:			return "cpu";
+	case ProfileZone::Gpu:			return "gpu";
+	case ProfileZone::Rasterizer:	return "rasterizer";
+	case ProfileZone::Dma:			return "dma";
+	case ProfileZone::Cdrom:		return "cdrom";
+	case ProfileZone::Timers:		return "timers";
+	case ProfileZone::Controller:	return "controller";
+	case ProfileZone::Spu:			return "spu";
+	case ProfileZone::Mdec:			return "mdec";
+	default:						return "unknown";
+	}
+}
+
+//Time elapsed since the last switch belongs to the running zone, if any
+void Profiler::charge(std::chrono::steady_clock::time_point now)
+{
+	if (current != ProfileZone::Count)
+		zoneTime[static_cast<int>(current)] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+	start = now;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+//Host time is charged to one zone at a time, nested zones pause the enclosing one
+enum class ProfileZone : uint8_t { Cpu, Gpu, Rasterizer, Dma, Cdrom, Timers, Controller, Spu, Mdec, Count };
+
+class Profiler
+{
+public:
+	static Profiler& instance()
+	{
+		static Profiler *instance = new Profiler();
+		return *instance;
+	}
+
+	//Zone Switching, returns the zone to restore on leave()
+	static ProfileZone enter(ProfileZone zone);
+	static void leave(ProfileZone previous);
+
+	//Results
+	static void reset();
+	static uint64_t getNanoseconds(ProfileZone zone);
+	static const char* getName(ProfileZone zone);
+
+	//Charge the lifetime of the object to a zone
+	class Scope
+	{
+	public:
+		Scope(ProfileZone zone) { previous = Profiler::enter(zone); }
+		~Scope() { Profiler::leave(previous); }
+
+	private:
+		ProfileZone previous;
+	};
+
+private:
+	Profiler();
+
+	void charge(std::chrono::steady_clock::time_point now);
+
+	ProfileZone									current;
+	std::chrono::steady_clock::time_point		start;
+	uint64_t									zoneTime[static_cast<int>(ProfileZone::Count)];
+};
+
+//Zones are compiled in only by targets defining PSXEMU_PROFILER (psxemu_bench)
+#ifdef PSXEMU_PROFILER
+#define PROFILE_ZONE(zone) Profiler::Scope profileScope(zone)
+#else
+#define PROFILE_ZONE(zone)
+#endif
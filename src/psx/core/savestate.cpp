@@ -0,0 +1,93 @@
+#include <loguru.hpp>
+#include "savestate.h"
+
+SaveState::SaveState(std::vector<uint8_t>& buffer, StateMode mode) : stream(buffer), mode(mode)
+{
+	uint32_t magic = SAVESTATE_MAGIC;
+	uint32_t version = SAVESTATE_VERSION;
+
+	position = 0;
+	valid = true;
+
+	if (mode == StateMode::Save)
+	{
+		stream.clear();
+		value(magic);
+		value(version);
+		return;
+	}
+
+	uint8_t* header = block(sizeof(magic) + sizeof(version));
+	if (header == nullptr)
+		return;
+
+	std::memcpy(&magic, header, sizeof(magic));
+	std::memcpy(&version, header + sizeof(magic), sizeof(version));
+
+	if (magic != SAVESTATE_MAGIC)
+	{
+		LOG_F(ERROR, "STS - Not a Save State!");
+		valid = false;
+	}
+	else if (version != SAVESTATE_VERSION)
+	{
+		LOG_F(ERROR, "STS - Unsupported Save State version %d, expected %d!", version, SAVESTATE_VERSION);
+		valid = false;
+	}
+}
+
+SaveState::~SaveState()
+{
+}
+
+void SaveState::buffer(void* data, size_t size)
+{
+	uint8_t* source = block(size);
+	if (source == nullptr)
+		return;
+
+	if (mode == StateMode::Save)
+		std::memcpy(source, data, size);
+	else if (mode == StateMode::Load)
+		std::memcpy(data, source, size);
+}
+
+uint8_t* SaveState::block(size_t size)
+{
+	if (!valid)
+		return nullptr;
+
+	if (mode == StateMode::Save)
+		stream.resize(position + size);
+	else if (size > remaining())
+	{
+		truncated();
+		return nullptr;
+	}
+
+	uint8_t* data = stream.data() + position;
+	position += size;
+
+	return data;
+}
+
+void SaveState::section(const char tag[4])
+{
+	uint8_t* marker = block(4);
+	if (marker == nullptr)
+		return;
+
+	if (mode == StateMode::Save)
+		std::memcpy(marker, tag, 4);
+	else if (std::memcmp(marker, tag, 4) != 0)
+	{
+		LOG_F(ERROR, "STS - Save State section %.4s not found!", tag);
+		valid = false;
+	}
+}
+
+void SaveState::truncated()
+{
+	LOG_F(ERROR, "STS - Save State is truncated!");
+	valid = false;
+}
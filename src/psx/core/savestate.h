@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//Save State Format: 8 bytes header (magic + version) followed by one tagged section per device.
+//Bump the version on any change to the layout of a serialized device, older snapshots are rejected.
+constexpr uint32_t SAVESTATE_MAGIC = 0x53585350;	//"PSXS"
+constexpr uint32_t SAVESTATE_VERSION = 6;
+
+//Verify walks a snapshot checking sizes and section tags without touching the machine
+enum class StateMode { Save, Load, Verify };
+
+//Bidirectional Save State Stream, the same serialize() code writes and reads a snapshot
+//so the two directions can not drift apart. Values are copied as raw host bytes.
+//The header is written or checked on construction.
+class SaveState
+{
+public:
+	SaveState(std::vector<uint8_t>& buffer, StateMode mode);
+	~SaveState();
+
+	bool isSaving() const { return mode == StateMode::Save; }
+	bool isLoading() const { return mode == StateMode::Load; }
+	bool isValid() const { return valid; }
+
+	//Raw Memory Block, large buffers are copied in bulk
+	void buffer(void* data, size_t size);
+
+	//In place access to the next block of the snapshot, to be filled (save) or read (load)
+	//by the caller without an intermediate copy. nullptr if the stream is not valid
+	uint8_t* block(size_t size);
+
+	//Plain values, structs of plain values and fixed size arrays
+	template<typename T>
+	void value(T& data) { buffer(reinterpret_cast<uint8_t*>(&data), sizeof(T)); }
+
+	//Variable length vector of plain values
+	template<typename T>
+	void vector(std::vector<T>& data)
+	{
+		uint32_t count = static_cast<uint32_t>(data.size());
+
+		if (isSaving())
+		{
+			value(count);
+			buffer(data.data(), count * sizeof(T));
+			return;
+		}
+
+		uint8_t* header = block(sizeof(count));
+		if (header == nullptr)
+			return;
+		std::memcpy(&count, header, sizeof(count));
+
+		//Never trust the count of a corrupted snapshot
+		if (static_cast<size_t>(count) * sizeof(T) > remaining())
+		{
+			truncated();
+			return;
+		}
+
+		if (isLoading())
+		{
+			data.resize(count);
+			buffer(data.data(), count * sizeof(T));
+		}
+		else
+			block(count * sizeof(T));
+	}
+
+	//Section Marker, loading stops at the first mismatch instead of restoring garbage
+	void section(const char tag[4]);
+
+private:
+	size_t remaining() const { return stream.size() - position; }
+	void truncated();
+
+	std::vector<uint8_t>&	stream;
+	StateMode				mode;
+	size_t					position;
+	bool					valid;
+};
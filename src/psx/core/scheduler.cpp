@@ -0,0 +1,54 @@
+#include <loguru.hpp>
+#include <algorithm>
+#include "scheduler.h"
+#include "psx.h"
+
+Scheduler::Scheduler()
+{
+	psx = nullptr;
+	timeline.reserve(8);
+}
+
+Scheduler::~Scheduler()
+{
+}
+
+bool Scheduler::reset()
+{
+	timeline.clear();
+
+	return true;
+}
+
+bool Scheduler::serialize(SaveState& state)
+{
+	state.section("SCHD");
+	state.vector(timeline);
+
+	return state.isValid();
+}
+
+void Scheduler::schedule(SchedulerEvent event, uint64_t cycles)
+{
+	scheduleAt(event, psx->masterClock + cycles);
+}
+
+//Devices synced behind the Master Clock schedule from their own clock, a timestamp already passed fires on the next check
+void Scheduler::scheduleAt(SchedulerEvent event, uint64_t timestamp)
+{
+	Event entry = { timestamp, event };
+
+	//Each device owns a single entry, replace the previous one
+	cancel(event);
+
+	auto pos = std::upper_bound(timeline.begin(), timeline.end(), entry,
+		[](const Event& a, const Event& b) { return a.timestamp < b.timestamp; });
+	timeline.insert(pos, entry);
+}
+
+void Scheduler::cancel(SchedulerEvent event)
+{
+	auto pos = std::find_if(timeline.begin(), timeline.end(), [event](const Event& e) { return e.event == event; });
+	if (pos != timeline.end())
+		timeline.erase(pos);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <limits>
+
+#include "savestate.h"
+
+class Psx;
+
+//Devices owning an entry on the Scheduler Timeline
+enum class SchedulerEvent : uint8_t { Gpu, Dma, Cdrom, Controller, Timers, Spu };
+
+constexpr auto SCHEDULER_NEVER = std::numeric_limits<uint64_t>::max();
+
+class Scheduler
+{
+public:
+	Scheduler();
+	~Scheduler();
+
+	bool reset();
+	bool serialize(SaveState& state);
+
+	//Timeline Management, cycles are relative to the current Master Clock
+	void schedule(SchedulerEvent event, uint64_t cycles);
+	void scheduleAt(SchedulerEvent event, uint64_t timestamp);
+	void cancel(SchedulerEvent event);
+
+	//Master Clock value of the first pending event
+	uint64_t nextTimestamp() const { return timeline.empty() ? SCHEDULER_NEVER : timeline.front().timestamp; }
+	SchedulerEvent nextEvent() const { return timeline.front().event; }
+
+	//Connect to PSX Instance
+	void link(Psx* instance) { psx = instance; }
+
+private:
+	//Link to Bus Object
+	Psx* psx;
+
+	struct Event
+	{
+		uint64_t		timestamp;		//Absolute Master Clock value
+		SchedulerEvent	event;
+	};
+
+	//Pending Events, sorted by timestamp. At most one entry per device.
+	std::vector<Event>	timeline;
+};
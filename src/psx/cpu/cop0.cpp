@@ -34,6 +34,14 @@ bool Cop0::reset()
 	return true;
 }
 
+bool Cop0::serialize(SaveState& state)
+{
+	state.section("COP0");
+	state.value(reg);
+
+	return state.isValid();
+}
+
 bool Cop0::execute(uint32_t cofun)
 {
 	cop0::Operation currentOperation;
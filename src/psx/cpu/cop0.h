@@ -71,6 +71,7 @@ public:
     //Cop0 Interface
     bool reset();
     bool execute (uint32_t cofun);
+    bool serialize(SaveState& state);
 
 public:
     //Cop0 Registers
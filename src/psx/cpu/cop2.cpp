@@ -95,6 +95,15 @@ bool Cop2::reset()
 	return true;
 }
 
+bool Cop2::serialize(SaveState& state)
+{
+	state.section("GTE ");
+	state.buffer(reg.data, sizeof(uint32_t) * GTE_DATA_REGISTER_NUMBER);
+	state.buffer(reg.ctrl, sizeof(uint32_t) * GTE_CONTROL_REGISTER_NUMBER);
+
+	return state.isValid();
+}
+
 bool Cop2::execute(uint32_t cofun)
 {
 	//Parse Current Operation
@@ -155,6 +155,7 @@ public:
     //Cop2 Interface
     bool reset();
     bool execute (uint32_t cofun);
+    bool serialize(SaveState& state);
 
     //Helper Functions
     bool checkOverflow(int64_t value, uint8_t size);
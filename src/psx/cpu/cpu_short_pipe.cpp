@@ -1,5 +1,8 @@
 #include <loguru.hpp>
+#include <algorithm>
+
 #include "cpu_short_pipe.h"
+#include "recompiler.h"
 #include "psx.h"
 
 CpuShort::CpuShort()
@@ -15,6 +18,9 @@ CpuShort::CpuShort()
 	cop0 = std::make_shared<Cop0>(this);
 	cop2 = std::make_shared<Cop2>(this);
 
+	//Init Native Code Translator
+	recompiler = std::make_shared<Recompiler>(this);
+
 	//Init Pipeline Registers and Status
 	std::memset(&currentOpcode, 0x00, sizeof(decodedOpcode));
 	isInDelaySlot = false;
@@ -23,6 +29,10 @@ CpuShort::CpuShort()
 	//Init Call Stack Callback
 	kernelCallCb = nullptr;
 
+	//Init Block Cache
+	mode = CpuMode::Cached;
+	flushBlocks();
+
 	//Init Memory Delay Load Status
 	currentDelayedRegisterLoad.id = 0;
 	currentDelayedRegisterLoad.value = 0;
@@ -200,11 +210,47 @@ bool CpuShort::reset()
 	nextDelayedRegisterLoad.id = 0;
 	nextDelayedRegisterLoad.value = 0;
 
-
+	//Flush Block Cache
+	flushBlocks();
 	
 	return true;
 }
 
+bool CpuShort::serialize(SaveState& state)
+{
+	state.section("CPU ");
+
+	//CPU Internal Registers
+	state.value(pc);
+	state.value(hi);
+	state.value(lo);
+	state.value(gpr);
+	state.value(cacheReg);
+
+	//Pipeline Status
+	state.value(currentOpcode);
+	state.value(isInDelaySlot);
+	state.value(branchAddress);
+	state.value(currentDelayedRegisterLoad);
+	state.value(nextDelayedRegisterLoad);
+	state.value(previousPipelineState);
+
+	//Instruction Cache and ScratchPad
+	state.buffer(iCache, sizeof(iCache));
+	state.buffer(dCache, sizeof(dCache));
+	state.value(iCacheEnabled);
+	state.value(dCacheEnabled);
+
+	cop0->serialize(state);
+	cop2->serialize(state);
+
+	//Compiled blocks refer to the RAM being replaced
+	if (state.isLoading())
+		flushBlocks();
+
+	return state.isValid();
+}
+
 //-----------------------------------------------------------------------------------------------------------------------------------
 //
 // Cache and Memory Access Functions
@@ -220,6 +266,16 @@ inline uint32_t CpuShort::rdInst(uint32_t vAddr, uint8_t bytes)
 inline uint32_t CpuShort::rdMem(uint32_t vAddr, uint8_t bytes)
 {
 	cop0::StatusRegister statusReg;
+	uint32_t phAddr;
+	uint32_t data = 0;
+
+	//Fast Path: RAM and BIOS are read straight through the Page Table
+	utility::Virtual2PhisicalAddr(vAddr, phAddr);
+	if (const uint8_t* host = psx->getReadPointer(phAddr))
+	{
+		std::memcpy(&data, host, bytes);
+		return data;
+	}
 
 	statusReg.word = cop0->reg[12];
 
@@ -229,7 +285,7 @@ inline uint32_t CpuShort::rdMem(uint32_t vAddr, uint8_t bytes)
 		//TODO
 	}
 
-	//Check if Reading from Data Cache, aka ScratchPad (0x1f800000 - 0x1f8003ff)
+	//Check if Reading from Data Cache, aka ScratchPad (0x1f800000 - 0x1f8003ff), not in the Page Table since a Page would mirror it over 4 KB
 	if (memRangeScratchpad.contains(vAddr)) return rdDataCache(vAddr, bytes);
 
 	//Check if Reading from Cache Control Register (0xfffe0130)
@@ -253,6 +309,16 @@ inline bool CpuShort::wrMem(uint32_t vAddr, uint32_t& data, uint8_t bytes, bool
 		return true;
 	}
 
+	//Fast Path: RAM is written straight through the Page Table
+	uint32_t phAddr;
+	utility::Virtual2PhisicalAddr(vAddr, phAddr);
+	if (uint8_t* host = psx->getWritePointer(phAddr))
+	{
+		std::memcpy(host, &data, bytes);
+		invalidateBlocks(phAddr);
+		return true;
+	}
+
 	//Check if Writing to Data Cache, aka ScratchPad
 	if (memRangeScratchpad.contains(vAddr)) return wrDataCache(vAddr, data, bytes);
 
@@ -265,6 +331,7 @@ inline bool CpuShort::wrMem(uint32_t vAddr, uint32_t& data, uint8_t bytes, bool
 		return true;
 	}
 
+	ioStore = true;
 	return psx->wrMem(vAddr, data, bytes);
 }
 
@@ -413,55 +480,12 @@ bool CpuShort::performDelayedLoad()
 //-----------------------------------------------------------------------------------------------------------------------------------
 bool CpuShort::execute()
 {
-	cpu::Instruction opcode;
-
-	auto runInstruction = [&]()
-	{
-		bool bResult;
-			
-		//Decode Current Instruction Fields
-		currentOpcode.op = opcode.op;
-		currentOpcode.funct = opcode.funct;
-		currentOpcode.rd = (uint8_t)opcode.rd;
-		currentOpcode.rt = (uint8_t)opcode.rt;
-		currentOpcode.rs = (uint8_t)opcode.rs;
-		currentOpcode.regA = gpr[currentOpcode.rs];
-		currentOpcode.regB = gpr[currentOpcode.rt];
-		currentOpcode.tgt = opcode.tgt;
-		currentOpcode.shamt = (uint8_t)opcode.shamt;
-		currentOpcode.cofun = (uint32_t)opcode.cofun;
-		currentOpcode.imm = (uint32_t)(int16_t)opcode.imm; //Sign Extended
-	
-		//Execute Current Instruction
-		if (currentOpcode.op == 0x00)
-		{
-			//SPECIAL opcode
-			bResult = (this->*functSet[currentOpcode.funct].operate)();
-			if (!bResult)
-				LOG_F(ERROR, "CPU - Unimplemented Function %s! [%02x]", functSet[currentOpcode.funct].mnemonic.c_str(), currentOpcode.funct);
-		}
-		else
-		{
-			bResult = (this->*instrSet[currentOpcode.op].operate)();
-			if (!bResult)
-				LOG_F(ERROR, "CPU - Unimplemented Instruction %s!", instrSet[currentOpcode.op].mnemonic.c_str());
-		}
-
-		//Memory Delay Load implementation
-		performDelayedLoad();
+	const CachedInstr* cached = nullptr;
+	CachedInstr uncached;
 
-		return bResult;
-	};
-	
 	//Stall CPU if databus is busy
 	if (psx->dataBusBusy)
 		return true;
-
-	//Save current Pipeline State for interrupt and exception handling
-	previousPipelineState.pc = pc;
-	previousPipelineState.isInDelaySlot = isInDelaySlot;
-	previousPipelineState.isLoadDelayPending = false;
-	previousPipelineState.isRFEInstruction = false;
 		
 	//Check for Shell Execution
 	if (pc == 0x80030000)
@@ -472,7 +496,10 @@ bool CpuShort::execute()
 		{
 			psx->exeFile->loadExe(fileName, psx->mem->ram);
 			psx->exeFile->setRegisters(&pc, gpr);
-			LOG_F(INFO, "CPU - EXE Loaded, jumping to 0x%08x", pc);	
+			LOG_F(INFO, "CPU - EXE Loaded, jumping to 0x%08x", pc);
+
+			//EXE is copied straight into RAM, any block compiled from there is stale
+			flushBlocks();
 		}
 		else
 		{
@@ -480,15 +507,82 @@ bool CpuShort::execute()
 		}
 	}
 
-	//Fetch Instruction from current PC
-	opcode.word = rdInst(pc);
+	//Fetch Instruction from current PC, using the Block Cache if enabled
+	if (mode == CpuMode::Cached)
+		cached = fetchCached(pc);
+
+	if (cached == nullptr)
+	{
+		decodeInstruction(rdInst(pc), uncached);
+		cached = &uncached;
+	}
+
+	stepInstruction(cached);
+
+	return true;
+}
+
+// Run a whole translated block, returns the number of retired instructions
+// so the caller can advance the rest of the system accordingly.
+uint32_t CpuShort::executeBlock()
+{
+	uint32_t phAddr;
+	CodeBlock* block;
+
+	//Stall CPU if databus is busy
+	if (psx->dataBusBusy)
+		return 1;
+
+	//Pending branch delay slots, shell execution and code outside RAM and BIOS are left to the interpreter
+	utility::Virtual2PhisicalAddr(pc, phAddr);
+	if (isInDelaySlot || pc == 0x80030000 || !recompiler->isSupported() || !isCodeAddress(phAddr))
+	{
+		execute();
+		return 1;
+	}
+
+	//Look for an existing block or compile a new one
+	auto it = codeBlocks.find(phAddr);
+	block = (it != codeBlocks.end()) ? it->second.get() : compileBlock(pc, phAddr);
+
+	if (block->code == nullptr)
+	{
+		block->code = translateBlock(block);
+
+		//Code Buffer is full, drop everything and start again
+		if (block->code == nullptr)
+		{
+			LOG_F(1, "JIT - Code Buffer Full, flushing all blocks");
+			flushBlocks();
+			execute();
+			return 1;
+		}
+	}
+
+	//Run native code, activeBlock is cleared if the block gets invalidated while running.
+	//Stepped instructions charge masterClock as they go, only the rest is left to the caller
+	activeBlock = block;
+	blockCharged = 0;
+	uint32_t retired = block->code();
+	activeBlock = nullptr;
+
+	return retired - blockCharged;
+}
+
+void CpuShort::stepInstruction(const CachedInstr* cached)
+{
+	//Save current Pipeline State for interrupt and exception handling
+	previousPipelineState.pc = pc;
+	previousPipelineState.isInDelaySlot = isInDelaySlot;
+	previousPipelineState.isLoadDelayPending = false;
+	previousPipelineState.isRFEInstruction = false;
 
 	//Check if isInDelaySlot is set, in that case we are executing the instruction in the Branch Delay Slot
 	//and Program Counter must be set to branch new value, if not just step to the next instruction
 	if (isInDelaySlot)
 	{
 		pc = branchAddress;
-		runInstruction();
+		runInstruction(cached->decoded, cached->operate);
 		isInDelaySlot = false;
 		
 		//Check for Kernel Call and trigger Callback
@@ -509,10 +603,317 @@ bool CpuShort::execute()
 	else
 	{
 		pc += 4;
-		runInstruction();
+		runInstruction(cached->decoded, cached->operate);
 	}
+}
 
-	return true;
+bool CpuShort::runInstruction(const decodedOpcode& decoded, bool(CpuShort::* operate)())
+{
+	bool bResult;
+
+	//Load predecoded fields and read source registers
+	currentOpcode = decoded;
+	currentOpcode.regA = gpr[currentOpcode.rs];
+	currentOpcode.regB = gpr[currentOpcode.rt];
+
+	//Execute Current Instruction
+	bResult = (this->*operate)();
+	if (!bResult)
+	{
+		if (currentOpcode.op == 0x00)
+			LOG_F(ERROR, "CPU - Unimplemented Function %s! [%02x]", functSet[currentOpcode.funct].mnemonic.c_str(), currentOpcode.funct);
+		else
+			LOG_F(ERROR, "CPU - Unimplemented Instruction %s!", instrSet[currentOpcode.op].mnemonic.c_str());
+	}
+
+	//Memory Delay Load implementation
+	performDelayedLoad();
+
+	return bResult;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------------
+//
+// Block Cache Implementation
+//
+//-----------------------------------------------------------------------------------------------------------------------------------
+void CpuShort::setMode(CpuMode value)
+{
+	mode = value;
+	flushBlocks();
+
+	//Native code is not available on every host
+	if (mode == CpuMode::Recompiler && !recompiler->isSupported())
+	{
+		LOG_F(WARNING, "CPU - Recompiler not supported on this host, using Cached Interpreter");
+		mode = CpuMode::Cached;
+	}
+
+	LOG_F(INFO, "CPU - Execution Mode: %s", (mode == CpuMode::Recompiler) ? "Recompiler" : (mode == CpuMode::Cached) ? "Cached Interpreter" : "Interpreter");
+}
+
+void CpuShort::flushBlocks()
+{
+	codeBlocks.clear();
+	for (auto& blocks : pageBlocks)
+		blocks.clear();
+	std::memset(codePages, 0x00, sizeof(codePages));
+
+	activeBlock = nullptr;
+	activeIndex = 0;
+	activePc = 0;
+	blockCharged = 0;
+	ioStore = false;
+
+	//No block references translated code anymore
+	recompiler->reset();
+}
+
+void CpuShort::decodeInstruction(uint32_t word, CachedInstr& cached)
+{
+	cpu::Instruction opcode;
+
+	opcode.word = word;
+
+	//Decode Instruction Fields, register contents are read at execution time
+	cached.decoded.op = opcode.op;
+	cached.decoded.funct = opcode.funct;
+	cached.decoded.rd = (uint8_t)opcode.rd;
+	cached.decoded.rt = (uint8_t)opcode.rt;
+	cached.decoded.rs = (uint8_t)opcode.rs;
+	cached.decoded.regA = 0;
+	cached.decoded.regB = 0;
+	cached.decoded.tgt = opcode.tgt;
+	cached.decoded.shamt = (uint8_t)opcode.shamt;
+	cached.decoded.cofun = (uint32_t)opcode.cofun;
+	cached.decoded.imm = (uint32_t)(int16_t)opcode.imm; //Sign Extended
+
+	//Resolve Handler
+	if (cached.decoded.op == 0x00)
+		cached.operate = functSet[cached.decoded.funct].operate;
+	else
+		cached.operate = instrSet[cached.decoded.op].operate;
+}
+
+//Only RAM and BIOS can hold cached code
+bool CpuShort::isCodeAddress(uint32_t phAddr) const
+{
+	return (phAddr <= CODE_RAM_MASK) || (phAddr >= 0x1fc00000 && phAddr < 0x1fc80000);
+}
+
+// Return the predecoded instruction at vAddr, compiling a new block if needed.
+// Returns nullptr for code outside RAM and BIOS, which is always interpreted.
+const CpuShort::CachedInstr* CpuShort::fetchCached(uint32_t vAddr)
+{
+	uint32_t phAddr;
+
+	//Sequential execution inside the active block
+	if (activeBlock != nullptr && vAddr == activePc && activeIndex < activeBlock->instr.size())
+	{
+		activePc += 4;
+		return &activeBlock->instr[activeIndex++];
+	}
+
+	activeBlock = nullptr;
+
+	utility::Virtual2PhisicalAddr(vAddr, phAddr);
+
+	//Only RAM and BIOS code is cached
+	if (!isCodeAddress(phAddr))
+		return nullptr;
+
+	//Look for an existing block or compile a new one
+	auto it = codeBlocks.find(phAddr);
+	if (it != codeBlocks.end())
+		activeBlock = it->second.get();
+	else
+		activeBlock = compileBlock(vAddr, phAddr);
+
+	activeIndex = 1;
+	activePc = vAddr + 4;
+
+	return &activeBlock->instr[0];
+}
+
+CpuShort::CodeBlock* CpuShort::compileBlock(uint32_t vAddr, uint32_t phAddr)
+{
+	auto block = std::make_unique<CodeBlock>();
+	bool endOfBlock = false;
+	bool delaySlot = false;
+
+	block->phAddr = phAddr;
+	block->isRam = (phAddr <= CODE_RAM_MASK);
+
+	//Decode up to the delay slot of the first control transfer, or to the end of the page
+	do
+	{
+		CachedInstr cached;
+
+		decodeInstruction(rdInst(vAddr), cached);
+		block->instr.push_back(cached);
+
+		if (delaySlot)
+			break;
+
+		switch (cached.decoded.op)
+		{
+		case 0x00:
+			//JR, JALR need the delay slot, SYSCALL and BREAK end the block immediately
+			if (cached.decoded.funct == 0x08 || cached.decoded.funct == 0x09)
+				delaySlot = true;
+			else if (cached.decoded.funct == 0x0c || cached.decoded.funct == 0x0d)
+				endOfBlock = true;
+			break;
+		case 0x01:	//BXX
+		case 0x02:	//J
+		case 0x03:	//JAL
+		case 0x04:	//BEQ
+		case 0x05:	//BNE
+		case 0x06:	//BLEZ
+		case 0x07:	//BGTZ
+			delaySlot = true;
+			break;
+		case 0x10:	//COP0, RFE and MTC0 may change the interrupt status
+			endOfBlock = true;
+			break;
+		}
+
+		vAddr += 4;
+		phAddr += 4;
+
+		//Do not cross a page boundary, unless it is a delay slot
+		if (!delaySlot && (phAddr & (CODE_PAGE_SIZE - 1)) == 0)
+			endOfBlock = true;
+
+	} while (!endOfBlock);
+
+	//Register RAM block on the pages it covers for invalidation
+	if (block->isRam)
+	{
+		block->firstPage = (block->phAddr & CODE_RAM_MASK) >> CODE_PAGE_SHIFT;
+		block->lastPage = ((phAddr - 4) & CODE_RAM_MASK) >> CODE_PAGE_SHIFT;
+		for (uint32_t page = block->firstPage; ; page = (page + 1) % CODE_RAM_PAGES)
+		{
+			pageBlocks[page].push_back(block->phAddr);
+			codePages[page] = true;
+			if (page == block->lastPage)
+				break;
+		}
+	}
+
+	LOG_F(3, "CPU - Compiled Block 0x%08x (%d instructions)", block->phAddr, (int)block->instr.size());
+
+	CodeBlock* result = block.get();
+	codeBlocks[block->phAddr] = std::move(block);
+
+	return result;
+}
+
+void CpuShort::invalidatePage(uint32_t page)
+{
+	//Drop all blocks overlapping the written page, a block crossing into the next page is dropped as well
+	for (uint32_t phAddr : pageBlocks[page])
+	{
+		auto it = codeBlocks.find(phAddr);
+		if (it == codeBlocks.end())
+			continue;
+
+		if (it->second.get() == activeBlock)
+			activeBlock = nullptr;
+
+		//A block crossing a page boundary is listed on every page it covers, drop it from the others too
+		const CodeBlock* block = it->second.get();
+		for (uint32_t other = block->firstPage; ; other = (other + 1) % CODE_RAM_PAGES)
+		{
+			if (other != page)
+			{
+				auto& blocks = pageBlocks[other];
+				blocks.erase(std::remove(blocks.begin(), blocks.end(), phAddr), blocks.end());
+				if (blocks.empty())
+					codePages[other] = false;
+			}
+			if (other == block->lastPage)
+				break;
+		}
+
+		codeBlocks.erase(it);
+	}
+
+	pageBlocks[page].clear();
+	codePages[page] = false;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------------
+//
+// Recompiler Implementation
+//
+//-----------------------------------------------------------------------------------------------------------------------------------
+JitFunction CpuShort::translateBlock(CodeBlock* block)
+{
+	bool lastInline = false;
+	bool delayPending = true;		//A load delay left by the previous block may still be in flight on entry
+
+	if (!recompiler->beginBlock())
+		return nullptr;
+
+	for (uint32_t i = 0; i < block->instr.size(); i++)
+	{
+		const CachedInstr& cached = block->instr[i];
+		const decodedOpcode& d = cached.decoded;
+
+		//ALU instructions are translated only when no delayed load or branch delay slot is pending.
+		//Translated instructions don't touch the bus, jitStep charges them to masterClock before
+		//the next stepped instruction so loads and stores see devices at the right cycle
+		if (!delayPending && recompiler->canInline(d))
+		{
+			recompiler->emitInline(d);
+			lastInline = true;
+		}
+		else
+		{
+			recompiler->emitStep(&CpuShort::jitStep, &cached, i + 1);
+			lastInline = false;
+
+			switch (d.op)
+			{
+			case 0x00:	//JR, JALR
+				delayPending = (d.funct == 0x08) || (d.funct == 0x09);
+				break;
+			case 0x01: case 0x02: case 0x03: case 0x04: case 0x05: case 0x06: case 0x07:	//BcondZ, J, JAL, BEQ, BNE, BLEZ, BGTZ
+			case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26:	//LB, LH, LWL, LW, LBU, LHU, LWR
+			case 0x30: case 0x31: case 0x32: case 0x33:										//LWC0-3
+				delayPending = true;
+				break;
+			case 0x10: case 0x11: case 0x12: case 0x13:	//MFCz, CFCz
+				delayPending = (d.rs == 0x00) || (d.rs == 0x02);
+				break;
+			default:
+				delayPending = false;
+			}
+		}
+	}
+
+	return recompiler->endBlock((uint32_t)block->instr.size(), lastInline);
+}
+
+// Called from translated code for instructions without a native translation.
+// Returns false when execution must leave the block: delay slot executed,
+// exception taken, block invalidated by a store or I/O register written.
+bool CpuShort::jitStep(CpuShort* cpu, const void* instr, uint32_t index)
+{
+	CodeBlock* block = cpu->activeBlock;
+	uint32_t nextPc = cpu->pc + 4;
+	bool delaySlot = cpu->isInDelaySlot;
+
+	//Instructions before this one have retired, as in Cached mode it runs at masterClock + index
+	cpu->psx->masterClock += index - cpu->blockCharged;
+	cpu->blockCharged = index;
+
+	cpu->ioStore = false;
+	cpu->stepInstruction(static_cast<const CachedInstr*>(instr));
+
+	//An I/O store may start a DMA holding the bus or raise an interrupt, Psx::execute checks both between blocks
+	return !delaySlot && (cpu->pc == nextPc) && (cpu->activeBlock == block) && !cpu->ioStore;
 }
 
 bool CpuShort::exception(uint32_t cause)
@@ -1607,6 +2008,7 @@ uint32_t CpuShort::get_pc() const
 
 void CpuShort::set_pc(uint32_t value)
 {
+	pc = value;
 }
 
 uint32_t CpuShort::get_hi() const
@@ -7,13 +7,16 @@
 #include <map>
 #include <memory>
 #include <functional>
+#include <unordered_map>
 
 #include "litelib.h" 
 #include "cpu_registers.h"
+#include "savestate.h"
 
 //Forward declarations to break circular dependency with cop0.h and cop2.h
 class Cop0;
 class Cop2;
+class Recompiler;
 
 #include "cop0.h"
 #include "cop2.h"
@@ -22,6 +25,12 @@ class Cop2;
 //Kernel Call Callback for Debugger
 using KernelCallCallback = std::function<void(KernelCallEvent& e)>;
 
+//Block Cache Constants
+constexpr auto CODE_PAGE_SHIFT = 12;							//4 KB Invalidation Pages
+constexpr auto CODE_PAGE_SIZE = 1 << CODE_PAGE_SHIFT;
+constexpr auto CODE_RAM_MASK = 0x001fffff;						//2 MB Main RAM
+constexpr auto CODE_RAM_PAGES = (CODE_RAM_MASK + 1) >> CODE_PAGE_SHIFT;
+
 
 //Support Structures
 struct DelayedLoadRegister
@@ -53,6 +62,17 @@ struct decodedOpcode
 	uint32_t	cofun;	//26-bit coprocessor function
 };
 
+//CPU Execution Mode
+enum class CpuMode
+{
+	Interpreter,		//Fetch and decode every instruction
+	Cached,				//Execute predecoded Basic Blocks from the Block Cache
+	Recompiler			//Execute Basic Blocks translated to native code, interpreter as fallback
+};
+
+//Native Block Entry Point, returns the number of retired guest instructions
+using JitFunction = uint32_t(*)();
+
 
 //Class Declaration
 class Psx;
@@ -65,6 +85,20 @@ public:
 
 	bool reset();
 	bool execute();
+	uint32_t executeBlock();
+	bool serialize(SaveState& state);
+
+	//Block Cache Management
+	void setMode(CpuMode value);
+	CpuMode getMode() const { return mode; }
+	void flushBlocks();
+	void invalidateBlocks(uint32_t phAddr)
+	{
+		//Called on every RAM write, only pages containing cached code need further work
+		uint32_t page = (phAddr & CODE_RAM_MASK) >> CODE_PAGE_SHIFT;
+		if (codePages[page])
+			invalidatePage(page);
+	}
 
 	//Cache & Memory Access
 	uint32_t rdInst(uint32_t vAddr, uint8_t bytes = 4);
@@ -123,6 +157,7 @@ public:
 	//Coprocessors
 	friend class Cop0;
 	friend class Cop2;
+	friend class Recompiler;
 
 	std::shared_ptr<Cop0>	cop0;	//Coprocessor 0
 	std::shared_ptr<Cop2>	cop2;	//Coprocessor 2 (GTE)
@@ -219,6 +254,37 @@ private:
 		bool(CpuShort::* operate)() = nullptr;
 	};
 
+	//Predecoded Instruction, handler is resolved once when the block is built
+	struct CachedInstr
+	{
+		bool(CpuShort::* operate)() = nullptr;
+		decodedOpcode	decoded;
+	};
+
+	//Basic Block, straight line code up to and including the delay slot of the first branch
+	struct CodeBlock
+	{
+		uint32_t	phAddr;						//Physical Address of the first instruction
+		uint32_t	firstPage;					//First and Last RAM invalidation page covered by the block
+		uint32_t	lastPage;
+		bool		isRam;						//Only RAM blocks can be invalidated, BIOS is read only
+		std::vector<CachedInstr> instr;
+		JitFunction	code = nullptr;				//Native translation, if any
+	};
+
+	//Block Cache Helper Functions
+	void stepInstruction(const CachedInstr* cached);
+	bool runInstruction(const decodedOpcode& decoded, bool(CpuShort::* operate)());
+	bool isCodeAddress(uint32_t phAddr) const;
+	const CachedInstr* fetchCached(uint32_t vAddr);
+	CodeBlock* compileBlock(uint32_t vAddr, uint32_t phAddr);
+	void decodeInstruction(uint32_t word, CachedInstr& cached);
+	void invalidatePage(uint32_t page);
+
+	//Recompiler Helper Functions
+	JitFunction translateBlock(CodeBlock* block);
+	static bool jitStep(CpuShort* cpu, const void* instr, uint32_t index);
+
 	KernelCallCallback		kernelCallCb;					//Callback to Debugger for Kernel Calls;
 	
 	DelayedLoadRegister		currentDelayedRegisterLoad;		//Contains the register that is going to be updated after Memory Delay
@@ -228,6 +294,20 @@ private:
 	std::vector<INSTR> instrSet;		//Full Instruction Set
 	std::vector<INSTR> functSet;		//Full Function Set
 
+	//Block Cache
+	CpuMode		mode;														//Current Execution Mode
+	std::unordered_map<uint32_t, std::unique_ptr<CodeBlock>> codeBlocks;	//Compiled Blocks, keyed by physical address
+	std::vector<uint32_t>	pageBlocks[CODE_RAM_PAGES];						//Blocks touching each RAM page
+	bool		codePages[CODE_RAM_PAGES];									//RAM pages containing compiled code
+	CodeBlock*	activeBlock;												//Block currently executing
+	uint32_t	activeIndex;												//Next instruction in the active block
+	uint32_t	activePc;													//Virtual address expected for the next instruction
+	uint32_t	blockCharged;												//Instructions of the running native block already added to masterClock
+	bool		ioStore;													//Last store went past RAM and ScratchPad to an I/O register
+
+	//Native Code Translator
+	std::shared_ptr<Recompiler>	recompiler;
+
 	//Memory Mapping
 	lite::range memRangeScratchpad =  lite::range(0x1f800000, 0x400);
 	lite::range memRangeIntRegs = lite::range(0x1f801070, 0x8);
@@ -0,0 +1,283 @@
+#include <loguru.hpp>
+#include "recompiler.h"
+#include "cpu_short_pipe.h"
+
+#if defined(PLATFORM_WINDOWS)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+//Native Code Generation is only available on x86-64 hosts
+#if defined(__x86_64__) || defined(_M_X64)
+#define JIT_X64
+#endif
+
+//x86-64 Register Encoding
+enum : uint8_t { EAX = 0, ECX = 1 };
+
+Recompiler::Recompiler(CpuShort* instance)
+{
+	//Link recompiler to cpu
+	cpu = instance;
+
+	codeBuffer = nullptr;
+	codePtr = nullptr;
+	blockStart = nullptr;
+
+	//CPU State is addressed relative to the CpuShort instance held in RBX
+	auto offset = [this](const void* member) { return static_cast<int32_t>(reinterpret_cast<const uint8_t*>(member) - reinterpret_cast<const uint8_t*>(cpu)); };
+	gprOffset = offset(&cpu->gpr[0]);
+	pcOffset = offset(&cpu->pc);
+	pipelinePcOffset = offset(&cpu->previousPipelineState.pc);
+	pipelineFlagOffset[0] = offset(&cpu->previousPipelineState.isInDelaySlot);
+	pipelineFlagOffset[1] = offset(&cpu->previousPipelineState.isLoadDelayPending);
+	pipelineFlagOffset[2] = offset(&cpu->previousPipelineState.isRFEInstruction);
+
+#ifdef JIT_X64
+	//Allocate Executable Code Buffer
+#if defined(PLATFORM_WINDOWS)
+	codeBuffer = static_cast<uint8_t*>(VirtualAlloc(nullptr, JIT_BUFFER_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+#else
+	void* buffer = mmap(nullptr, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	codeBuffer = (buffer == MAP_FAILED) ? nullptr : static_cast<uint8_t*>(buffer);
+#endif
+	if (codeBuffer == nullptr)
+		LOG_F(ERROR, "JIT - Unable to allocate executable memory, falling back to interpreter");
+#endif
+
+	codePtr = codeBuffer;
+}
+
+Recompiler::~Recompiler()
+{
+	if (codeBuffer == nullptr)
+		return;
+
+#if defined(PLATFORM_WINDOWS)
+	VirtualFree(codeBuffer, 0, MEM_RELEASE);
+#else
+	munmap(codeBuffer, JIT_BUFFER_SIZE);
+#endif
+}
+
+bool Recompiler::reset()
+{
+	//Discard all translated code, caller must drop every block referencing it
+	codePtr = codeBuffer;
+	blockStart = nullptr;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------------
+//
+// Block Translation
+//
+//-----------------------------------------------------------------------------------------------------------------------------------
+bool Recompiler::beginBlock()
+{
+	if (codeBuffer == nullptr)
+		return false;
+
+	//Check for room to translate a full block
+	if ((codePtr + JIT_BLOCK_MAX_SIZE) > (codeBuffer + JIT_BUFFER_SIZE))
+		return false;
+
+	blockStart = codePtr;
+
+	//Prologue: save RBX, keep stack 16 byte aligned with Win64 shadow space, load CpuShort instance
+	emit8(0x53);												//push rbx
+	emit8(0x48); emit8(0x83); emit8(0xec); emit8(0x20);			//sub rsp, 32
+	emit8(0x48); emit8(0xbb); emit64(reinterpret_cast<uint64_t>(cpu));	//mov rbx, imm64
+
+	return true;
+}
+
+// ALU instructions without exceptions or delayed loads are translated to native code,
+// everything else is executed through the interpreter handlers.
+bool Recompiler::canInline(const decodedOpcode& decoded) const
+{
+	if (decoded.op == 0x00)
+	{
+		switch (decoded.funct)
+		{
+		case 0x00: case 0x02: case 0x03:				//SLL, SRL, SRA
+		case 0x04: case 0x06: case 0x07:				//SLLV, SRLV, SRAV
+		case 0x21: case 0x23:							//ADDU, SUBU
+		case 0x24: case 0x25: case 0x26: case 0x27:		//AND, OR, XOR, NOR
+		case 0x2a: case 0x2b:							//SLT, SLTU
+			return true;
+		}
+		return false;
+	}
+
+	switch (decoded.op)
+	{
+	case 0x09: case 0x0a: case 0x0b:					//ADDIU, SLTI, SLTIU
+	case 0x0c: case 0x0d: case 0x0e: case 0x0f:			//ANDI, ORI, XORI, LUI
+		return true;
+	}
+
+	return false;
+}
+
+void Recompiler::emitInline(const decodedOpcode& decoded)
+{
+	uint8_t dest = (decoded.op == 0x00) ? decoded.rd : decoded.rt;
+
+	//Writes to r0 are discarded, only the Program Counter moves
+	if (dest != 0)
+	{
+		if (decoded.op == 0x00)
+		{
+			switch (decoded.funct)
+			{
+			case 0x00:	//SLL
+			case 0x02:	//SRL
+			case 0x03:	//SRA
+				emitModRM(0x8b, EAX, gprOffset + decoded.rt * 4);							//mov eax, rt
+				emit8(0xc1); emit8((decoded.funct == 0x00) ? 0xe0 : (decoded.funct == 0x02) ? 0xe8 : 0xf8); emit8(decoded.shamt);
+				break;
+
+			case 0x04:	//SLLV
+			case 0x06:	//SRLV
+			case 0x07:	//SRAV
+				emitModRM(0x8b, EAX, gprOffset + decoded.rt * 4);							//mov eax, rt
+				emitModRM(0x8b, ECX, gprOffset + decoded.rs * 4);							//mov ecx, rs (x86 masks the count to 5 bits)
+				emit8(0xd3); emit8((decoded.funct == 0x04) ? 0xe0 : (decoded.funct == 0x06) ? 0xe8 : 0xf8);
+				break;
+
+			default:
+				emitModRM(0x8b, EAX, gprOffset + decoded.rs * 4);							//mov eax, rs
+				emitModRM(0x8b, ECX, gprOffset + decoded.rt * 4);							//mov ecx, rt
+				switch (decoded.funct)
+				{
+				case 0x21: emit8(0x01); emit8(0xc8); break;									//add eax, ecx
+				case 0x23: emit8(0x29); emit8(0xc8); break;									//sub eax, ecx
+				case 0x24: emit8(0x21); emit8(0xc8); break;									//and eax, ecx
+				case 0x25: emit8(0x09); emit8(0xc8); break;									//or eax, ecx
+				case 0x26: emit8(0x31); emit8(0xc8); break;									//xor eax, ecx
+				case 0x27: emit8(0x09); emit8(0xc8); emit8(0xf7); emit8(0xd0); break;		//or eax, ecx; not eax
+				case 0x2a:
+				case 0x2b:
+					emit8(0x39); emit8(0xc8);												//cmp eax, ecx
+					emit8(0x0f); emit8((decoded.funct == 0x2a) ? 0x9c : 0x92); emit8(0xc0);	//setl al / setb al
+					emit8(0x0f); emit8(0xb6); emit8(0xc0);									//movzx eax, al
+					break;
+				}
+				break;
+			}
+		}
+		else
+		{
+			if (decoded.op == 0x0f)
+			{
+				emit8(0xb8); emit32(decoded.imm << 16);										//mov eax, imm << 16
+			}
+			else
+			{
+				emitModRM(0x8b, EAX, gprOffset + decoded.rs * 4);							//mov eax, rs
+				switch (decoded.op)
+				{
+				case 0x09: emit8(0x05); emit32(decoded.imm); break;							//add eax, imm
+				case 0x0c: emit8(0x25); emit32(decoded.imm & 0x0000ffff); break;			//and eax, zero extended imm
+				case 0x0d: emit8(0x0d); emit32(decoded.imm & 0x0000ffff); break;			//or eax, zero extended imm
+				case 0x0e: emit8(0x35); emit32(decoded.imm & 0x0000ffff); break;			//xor eax, zero extended imm
+				case 0x0a:
+				case 0x0b:
+					emit8(0x3d); emit32(decoded.imm);										//cmp eax, sign extended imm
+					emit8(0x0f); emit8((decoded.op == 0x0a) ? 0x9c : 0x92); emit8(0xc0);	//setl al / setb al
+					emit8(0x0f); emit8(0xb6); emit8(0xc0);									//movzx eax, al
+					break;
+				}
+			}
+		}
+
+		emitModRM(0x89, EAX, gprOffset + dest * 4);											//mov dest, eax
+	}
+
+	//Step Program Counter
+	emitModRM(0x83, 0, pcOffset); emit8(0x04);												//add dword pc, 4
+}
+
+void Recompiler::emitStep(JitStepFunction step, const void* instr, uint32_t retired)
+{
+	//Call interpreter step with (CpuShort*, instr, index) according to host ABI, the index is the number of instructions before it
+#if defined(PLATFORM_WINDOWS)
+	emit8(0x48); emit8(0x89); emit8(0xd9);										//mov rcx, rbx
+	emit8(0x48); emit8(0xba); emit64(reinterpret_cast<uint64_t>(instr));		//mov rdx, imm64
+	emit8(0x41); emit8(0xb8); emit32(retired - 1);								//mov r8d, imm32
+#else
+	emit8(0x48); emit8(0x89); emit8(0xdf);										//mov rdi, rbx
+	emit8(0x48); emit8(0xbe); emit64(reinterpret_cast<uint64_t>(instr));		//mov rsi, imm64
+	emit8(0xba); emit32(retired - 1);											//mov edx, imm32
+#endif
+	emit8(0x48); emit8(0xb8); emit64(reinterpret_cast<uint64_t>(step));			//mov rax, imm64
+	emit8(0xff); emit8(0xd0);													//call rax
+
+	//Leave the block if the step changed the control flow or invalidated the block
+	emit8(0x84); emit8(0xc0);													//test al, al
+	emit8(0x75); emit8(0x0b);													//jnz +11 (skip exit)
+	emitExit(retired);
+}
+
+JitFunction Recompiler::endBlock(uint32_t retired, bool lastInline)
+{
+	//Inlined instructions do not update the Pipeline State, do it once for the last one
+	if (lastInline)
+	{
+		emitModRM(0x8b, EAX, pcOffset);											//mov eax, pc
+		emit8(0x83); emit8(0xe8); emit8(0x04);									//sub eax, 4
+		emitModRM(0x89, EAX, pipelinePcOffset);									//mov previous pc, eax
+		for (int32_t flagOffset : pipelineFlagOffset)
+		{
+			emitModRM(0xc6, 0, flagOffset); emit8(0x00);						//mov byte flag, 0
+		}
+	}
+
+	emitExit(retired);
+
+	LOG_F(3, "JIT - Translated Block (%d instructions, %d bytes)", retired, (int)(codePtr - blockStart));
+
+	return reinterpret_cast<JitFunction>(blockStart);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------------
+//
+// x86-64 Emitter Helpers
+//
+//-----------------------------------------------------------------------------------------------------------------------------------
+void Recompiler::emit8(uint8_t value)
+{
+	*codePtr++ = value;
+}
+
+void Recompiler::emit32(uint32_t value)
+{
+	std::memcpy(codePtr, &value, sizeof(uint32_t));
+	codePtr += sizeof(uint32_t);
+}
+
+void Recompiler::emit64(uint64_t value)
+{
+	std::memcpy(codePtr, &value, sizeof(uint64_t));
+	codePtr += sizeof(uint64_t);
+}
+
+//Emit opcode with a [rbx + disp32] memory operand
+void Recompiler::emitModRM(uint8_t opcode, uint8_t reg, int32_t offset)
+{
+	emit8(opcode);
+	emit8(0x80 | (reg << 3) | 0x03);
+	emit32(static_cast<uint32_t>(offset));
+}
+
+//Epilogue: return the number of retired instructions
+void Recompiler::emitExit(uint32_t retired)
+{
+	emit8(0xb8); emit32(retired);												//mov eax, retired
+	emit8(0x48); emit8(0x83); emit8(0xc4); emit8(0x20);							//add rsp, 32
+	emit8(0x5b);																//pop rbx
+	emit8(0xc3);																//ret
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#include "litelib.h"
+#include "cpu_short_pipe.h"
+
+//Recompiler Constants
+constexpr auto JIT_BUFFER_SIZE = 0x1000000;		//16 MB of native code
+constexpr auto JIT_BLOCK_MAX_SIZE = 0x10000;		//Worst case size of a single translated block
+
+//Interpreter Fallback, executes one predecoded instruction (index in the block) and returns false to leave the block
+using JitStepFunction = bool(*)(CpuShort* cpu, const void* instr, uint32_t index);
+
+class CpuShort;
+
+class Recompiler
+{
+public:
+	Recompiler(CpuShort* instance);
+	~Recompiler();
+
+	//Recompiler Interface
+	bool reset();
+	bool isSupported() const { return codeBuffer != nullptr; }
+
+	//Block Translation
+	bool beginBlock();
+	bool canInline(const decodedOpcode& decoded) const;
+	void emitInline(const decodedOpcode& decoded);
+	void emitStep(JitStepFunction step, const void* instr, uint32_t retired);
+	JitFunction endBlock(uint32_t retired, bool lastInline);
+
+private:
+	//x86-64 Emitter Helpers
+	void emit8(uint8_t value);
+	void emit32(uint32_t value);
+	void emit64(uint64_t value);
+	void emitModRM(uint8_t opcode, uint8_t reg, int32_t offset);
+	void emitExit(uint32_t retired);
+
+private:
+	CpuShort* cpu;
+
+	//Native Code Buffer
+	uint8_t*	codeBuffer;
+	uint8_t*	codePtr;
+	uint8_t*	blockStart;
+
+	//Offsets of CPU State from the CpuShort instance, addressed through RBX
+	int32_t		gprOffset;
+	int32_t		pcOffset;
+	int32_t		pipelinePcOffset;
+	int32_t		pipelineFlagOffset[3];
+};
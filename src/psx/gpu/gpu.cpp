@@ -6,6 +6,268 @@
 #include "psx.h"
 #include "renderer.h"
 #include "gpu.h"
+#include "profiler.h"
+
+//GP0 Instruction Set, indexed by opcode. Primitive handlers are instantiated per opcode, bits they ignore are cleared to share instantiations
+constexpr std::array<GPU::INSTRGP0, 256> GPU::gp0InstrSet =
+{{
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"Clear Texture Cache", &GPU::gp0_ClearTextureCache, 0, false, false},
+	{"Fill Rectangle in VRAM", &GPU::gp0_FillVRam, 2, true, false},
+	{"Unknown", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"Interrupt Request (IRQ1)", &GPU::gp0_InterruptRequest, 0, false, false},
+	{"Monocrome 3 Point Polygon, Opaque", &GPU::gp0_Polygons<0x20>, 3, true, false},
+	{"Monocrome 3 Point Polygon, Opaque", &GPU::gp0_Polygons<0x20>, 3, true, false},
+	{"Monocrome 3 Point Polygon, Semi-Transparent", &GPU::gp0_Polygons<0x22>, 3, true, false},
+	{"Monocrome 3 Point Polygon, Semi-Transparent", &GPU::gp0_Polygons<0x22>, 3, true, false},
+	{"Textured 3 Point polygon, opaque, texture blending", &GPU::gp0_Polygons<0x24>, 6, true, false},
+	{"Textured 3 Point polygon, opaque, raw texture", &GPU::gp0_Polygons<0x25>, 6, true, false},
+	{"Textured 3 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons<0x26>, 6, true, false},
+	{"Textured 3 Point polygon, semi-transparent, raw texture", &GPU::gp0_Polygons<0x27>, 6, true, false},
+	{"Monocrome 4 Point Polygon, Opaque", &GPU::gp0_Polygons<0x28>, 4, true, false},
+	{"Monocrome 4 Point Polygon, Opaque", &GPU::gp0_Polygons<0x28>, 4, true, false},
+	{"Monocrome 4 Point Polygon, Semi-Transparent", &GPU::gp0_Polygons<0x2a>, 4, true, false},
+	{"Monocrome 4 Point Polygon, Semi-Transparent", &GPU::gp0_Polygons<0x2a>, 4, true, false},
+	{"Textured 4 Point polygon, opaque, texture blending", &GPU::gp0_Polygons<0x2c>, 8, true, false},
+	{"Textured 4 Point polygon, opaque, raw texture", &GPU::gp0_Polygons<0x2d>, 8, true, false},
+	{"Textured 4 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons<0x2e>, 8, true, false},
+	{"Textured 4 Point polygon, semi-transparent, raw texture", &GPU::gp0_Polygons<0x2f>, 8, true, false},
+	{"Shaded 3 Point polygon, opaque", &GPU::gp0_Polygons<0x30>, 5, true, false},
+	{"Shaded 3 Point polygon, opaque", &GPU::gp0_Polygons<0x30>, 5, true, false},
+	{"Shaded 3 Point polygon, semi-transparent", &GPU::gp0_Polygons<0x32>, 5, true, false},
+	{"Shaded 3 Point polygon, semi-transparent", &GPU::gp0_Polygons<0x32>, 5, true, false},
+	{"Shaded Textured 3 Point polygon, opaque, texture blending", &GPU::gp0_Polygons<0x34>, 8, true, false},
+	{"Shaded Textured 3 Point polygon, opaque, texture blending", &GPU::gp0_Polygons<0x35>, 8, true, false},
+	{"Shaded Textured 3 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons<0x36>, 8, true, false},
+	{"Shaded Textured 3 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons<0x37>, 8, true, false},
+	{"Shaded 4 Point polygon, opaque", &GPU::gp0_Polygons<0x38>, 7, true, false},
+	{"Shaded 4 Point polygon, opaque", &GPU::gp0_Polygons<0x38>, 7, true, false},
+	{"Shaded 4 Point polygon, semi-transparent", &GPU::gp0_Polygons<0x3a>, 7, true, false},
+	{"Shaded 4 Point polygon, semi-transparent", &GPU::gp0_Polygons<0x3a>, 7, true, false},
+	{"Shaded Textured 4 Point polygon, opaque, texture blending", &GPU::gp0_Polygons<0x3c>, 11, true, false},
+	{"Shaded Textured 4 Point polygon, opaque, texture blending", &GPU::gp0_Polygons<0x3d>, 11, true, false},
+	{"Shaded Textured 4 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons<0x3e>, 11, true, false},
+	{"Shaded Textured 4 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons<0x3f>, 11, true, false},
+	{"Monocrome line, opaque", &GPU::gp0_Lines<0x40>, 2, true, false},
+	{"Monocrome line, opaque", &GPU::gp0_Lines<0x40>, 2, true, false},
+	{"Monocrome line, semi-transparent", &GPU::gp0_Lines<0x42>, 2, true, false},
+	{"Monocrome line, semi-transparent", &GPU::gp0_Lines<0x42>, 2, true, false},
+	{"Monocrome line, opaque", &GPU::gp0_Lines<0x40>, 2, true, false},
+	{"Monocrome line, opaque", &GPU::gp0_Lines<0x40>, 2, true, false},
+	{"Monocrome line, opaque", &GPU::gp0_Lines<0x42>, 2, true, false},
+	{"Monocrome line, semi-transparent", &GPU::gp0_Lines<0x42>, 2, true, false},
+	{"Monocrome Polyline, opaque", &GPU::gp0_Lines<0x48>, 255, true, true},
+	{"Monocrome Polyline, opaque", &GPU::gp0_Lines<0x48>, 255, true, true},
+	{"Monocrome Polyline, semi-transparent", &GPU::gp0_Lines<0x4a>, 255, true, true},
+	{"Monocrome Polyline, semi-transparent", &GPU::gp0_Lines<0x4a>, 255, true, true},
+	{"Monocrome Polyline, opaque", &GPU::gp0_Lines<0x48>, 255, true, true},
+	{"Monocrome Polyline, opaque", &GPU::gp0_Lines<0x48>, 255, true, true},
+	{"Monocrome Polyline, semi-transparent", &GPU::gp0_Lines<0x4a>, 255, true, true},
+	{"Monocrome Polyline, semi-transparent", &GPU::gp0_Lines<0x4a>, 255, true, true},
+	{"Shaded line, opaque", &GPU::gp0_Lines<0x50>, 3, true, false},
+	{"Shaded line, opaque", &GPU::gp0_Lines<0x50>, 3, true, false},
+	{"Shaded line, semi-transparent", &GPU::gp0_Lines<0x52>, 3, true, false},
+	{"Shaded line, semi-transparent", &GPU::gp0_Lines<0x52>, 3, true, false},
+	{"Shaded line, opaque", &GPU::gp0_Lines<0x50>, 3, true, false},
+	{"Shaded line, opaque", &GPU::gp0_Lines<0x50>, 3, true, false},
+	{"Shaded line, semi-transparent", &GPU::gp0_Lines<0x52>, 3, true, false},
+	{"Shaded line, semi-transparent", &GPU::gp0_Lines<0x52>, 3, true, false},
+	{"Shaded Polyline, opaque", &GPU::gp0_Lines<0x58>, 255, true, true},
+	{"Shaded Polyline, opaque", &GPU::gp0_Lines<0x58>, 255, true, true},
+	{"Shaded Polyline, semi-transparent", &GPU::gp0_Lines<0x5a>, 255, true, true},
+	{"Shaded Polyline, semi-transparent", &GPU::gp0_Lines<0x5a>, 255, true, true},
+	{"Shaded Polyline, opaque", &GPU::gp0_Lines<0x58>, 255, true, true},
+	{"Shaded Polyline, opaque", &GPU::gp0_Lines<0x58>, 255, true, true},
+	{"Shaded Polyline, semi-transparent", &GPU::gp0_Lines<0x5a>, 255, true, true},
+	{"Shaded Polyline, semi-transparent", &GPU::gp0_Lines<0x5a>, 255, true, true},
+	{"Monocrome Rectangle, variable size, opaque", &GPU::gp0_Rectangles<0x60>, 2, true, false},
+	{"Monocrome Rectangle, variable size, opaque", &GPU::gp0_Rectangles<0x60>, 2, true, false},
+	{"Monocrome Rectangle, variable size, semi-transparent", &GPU::gp0_Rectangles<0x62>, 2, true, false},
+	{"Monocrome Rectangle, variable size, semi-transparent", &GPU::gp0_Rectangles<0x62>, 2, true, false},
+	{"Textured Rectangle, variable size, opaque, texture blending", &GPU::gp0_Rectangles<0x64>, 3, true, false},
+	{"Textured Rectangle, variable size, opaque, raw texture", &GPU::gp0_Rectangles<0x65>, 3, true, false},
+	{"Textured Rectangle, variable size, semi-transparent, texture blending", &GPU::gp0_Rectangles<0x66>, 3, true, false},
+	{"Textured Rectangle, variable size, semi-transparent, raw texture", &GPU::gp0_Rectangles<0x67>, 3, true, false},
+	{"Monocrome Rectangle, 1x1, opaque", &GPU::gp0_Rectangles<0x68>, 1, true, false},
+	{"Monocrome Rectangle, 1x1, opaque", &GPU::gp0_Rectangles<0x68>, 1, true, false },
+	{"Monocrome Rectangle, 1x1, semi-transparent", &GPU::gp0_Rectangles<0x6a>, 1, true, false},
+	{"Monocrome Rectangle, 1x1, semi-transparent", &GPU::gp0_Rectangles<0x6a>, 1, true, false },
+	{"Textured Rectangle, 1x1, opaque, texture blending", &GPU::gp0_Rectangles<0x6c>, 2, true, false},
+	{"Textured Rectangle, 1x1, opaque, raw texture", &GPU::gp0_Rectangles<0x6d>, 2, true, false},
+	{"Textured Rectangle, 1x1, semi-transparent, texture blending", &GPU::gp0_Rectangles<0x6e>, 2, true, false},
+	{"Textured Rectangle, 1x1, semi-transparent, raw texture", &GPU::gp0_Rectangles<0x6f>, 2, true, false},
+	{"Monocrome Rectangle, 8x8, opaque", &GPU::gp0_Rectangles<0x70>, 1, true, false},
+	{"Monocrome Rectangle, 8x8, opaque", &GPU::gp0_Rectangles<0x70>, 1, true, false },
+	{"Monocrome Rectangle, 8x8, semi-transparent", &GPU::gp0_Rectangles<0x72>, 1, true, false},
+	{"Monocrome Rectangle, 8x8, semi-transparent", &GPU::gp0_Rectangles<0x72>, 1, true, false },
+	{"Textured Rectangle, 8x8, opaque, texture blending", &GPU::gp0_Rectangles<0x74>, 2, true, false},
+	{"Textured Rectangle, 8x8, opaque, raw texture", &GPU::gp0_Rectangles<0x75>, 2, true, false},
+	{"Textured Rectangle, 8x8, semi-transparent, texture blending", &GPU::gp0_Rectangles<0x76>, 2, true, false},
+	{"Textured Rectangle, 8x8, semi-transparent, raw texture", &GPU::gp0_Rectangles<0x77>, 2, true, false},
+	{"Monocrome Rectangle, 16x16, opaque", &GPU::gp0_Rectangles<0x78>, 1, true, false},
+	{"Monocrome Rectangle, 16x16, opaque", &GPU::gp0_Rectangles<0x78>, 1, true, false },
+	{"Monocrome Rectangle, 16x16, semi-transparent", &GPU::gp0_Rectangles<0x7a>, 1, true, false},
+	{"Monocrome Rectangle, 16x16, semi-transparent", &GPU::gp0_Rectangles<0x7a>, 1, true, false },
+	{"Textured Rectangle, 16x16, opaque, texture blending", &GPU::gp0_Rectangles<0x7c>, 2, true, false},
+	{"Textured Rectangle, 16x16, opaque, raw texture", &GPU::gp0_Rectangles<0x7d>, 2, true, false},
+	{"Textured Rectangle, 16x16, semi-transparent, texture blending", &GPU::gp0_Rectangles<0x7e>, 2, true, false},
+	{"Textured Rectangle, 16x16, semi-transparent, raw texture", &GPU::gp0_Rectangles<0x7f>, 2, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"Draw Mode Setting", &GPU::gp0_DrawMode, 0, false, false},
+	{"Texture Window Setting", &GPU::gp0_TextureSetting, 0, false, false},
+	{"Set Drawing Area Top Left", &GPU::gp0_SetDrawAreaTop, 0, false, false},
+	{"Set Drawing Area Bottom Right", &GPU::gp0_SetDrawAreaBottom, 0, false, false},
+	{"Set Drawing Offset", &GPU::gp0_SetDrawOffset, 0, false, false},
+	{"Mask Bit Setting", &GPU::gp0_SetMaskBit, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false},
+	{"NOP", &GPU::gp0_NoOperation, 0, false, false}
+}};
 
 GPU::GPU()
 {
@@ -16,266 +278,6 @@ GPU::GPU()
 	Renderer::Init();
 
 	//Init GPU Instruction Dictionaries
-	gp0InstrSet =
-	{
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"Clear Texture Cache", &GPU::gp0_ClearTextureCache, 0, false, false},
-		{"Fill Rectangle in VRAM", &GPU::gp0_FillVRam, 2, true, false},
-		{"Unknown", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"Interrupt Request (IRQ1)", &GPU::gp0_InterruptRequest, 0, false, false},
-		{"Monocrome 3 Point Polygon, Opaque", &GPU::gp0_Polygons, 3, true, false},
-		{"Monocrome 3 Point Polygon, Opaque", &GPU::gp0_Polygons, 3, true, false},
-		{"Monocrome 3 Point Polygon, Semi-Transparent", &GPU::gp0_Polygons, 3, true, false},
-		{"Monocrome 3 Point Polygon, Semi-Transparent", &GPU::gp0_Polygons, 3, true, false},
-		{"Textured 3 Point polygon, opaque, texture blending", &GPU::gp0_Polygons, 6, true, false},
-		{"Textured 3 Point polygon, opaque, raw texture", &GPU::gp0_Polygons, 6, true, false},
-		{"Textured 3 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons, 6, true, false},
-		{"Textured 3 Point polygon, semi-transparent, raw texture", &GPU::gp0_Polygons, 6, true, false},
-		{"Monocrome 4 Point Polygon, Opaque", &GPU::gp0_Polygons, 4, true, false},
-		{"Monocrome 4 Point Polygon, Opaque", &GPU::gp0_Polygons, 4, true, false},
-		{"Monocrome 4 Point Polygon, Semi-Transparent", &GPU::gp0_Polygons, 4, true, false},
-		{"Monocrome 4 Point Polygon, Semi-Transparent", &GPU::gp0_Polygons, 4, true, false},
-		{"Textured 4 Point polygon, opaque, texture blending", &GPU::gp0_Polygons, 8, true, false},
-		{"Textured 4 Point polygon, opaque, raw texture", &GPU::gp0_Polygons, 8, true, false},
-		{"Textured 4 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons, 8, true, false},
-		{"Textured 4 Point polygon, semi-transparent, raw texture", &GPU::gp0_Polygons, 8, true, false},
-		{"Shaded 3 Point polygon, opaque", &GPU::gp0_Polygons, 5, true, false},
-		{"Shaded 3 Point polygon, opaque", &GPU::gp0_Polygons, 5, true, false},
-		{"Shaded 3 Point polygon, semi-transparent", &GPU::gp0_Polygons, 5, true, false},
-		{"Shaded 3 Point polygon, semi-transparent", &GPU::gp0_Polygons, 5, true, false},
-		{"Shaded Textured 3 Point polygon, opaque, texture blending", &GPU::gp0_Polygons, 8, true, false},
-		{"Shaded Textured 3 Point polygon, opaque, texture blending", &GPU::gp0_Polygons, 8, true, false},
-		{"Shaded Textured 3 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons, 8, true, false},
-		{"Shaded Textured 3 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons, 8, true, false},
-		{"Shaded 4 Point polygon, opaque", &GPU::gp0_Polygons, 7, true, false},
-		{"Shaded 4 Point polygon, opaque", &GPU::gp0_Polygons, 7, true, false},
-		{"Shaded 4 Point polygon, semi-transparent", &GPU::gp0_Polygons, 7, true, false},
-		{"Shaded 4 Point polygon, semi-transparent", &GPU::gp0_Polygons, 7, true, false},
-		{"Shaded Textured 4 Point polygon, opaque, texture blending", &GPU::gp0_Polygons, 11, true, false},
-		{"Shaded Textured 4 Point polygon, opaque, texture blending", &GPU::gp0_Polygons, 11, true, false},
-		{"Shaded Textured 4 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons, 11, true, false},
-		{"Shaded Textured 4 Point polygon, semi-transparent, texture blending", &GPU::gp0_Polygons, 11, true, false},
-		{"Monocrome line, opaque", &GPU::gp0_Lines, 2, true, false},
-		{"Monocrome line, opaque", &GPU::gp0_Lines, 2, true, false},
-		{"Monocrome line, semi-transparent", &GPU::gp0_Lines, 2, true, false},
-		{"Monocrome line, semi-transparent", &GPU::gp0_Lines, 2, true, false},
-		{"Monocrome line, opaque", &GPU::gp0_Lines, 2, true, false},
-		{"Monocrome line, opaque", &GPU::gp0_Lines, 2, true, false},
-		{"Monocrome line, opaque", &GPU::gp0_Lines, 2, true, false},
-		{"Monocrome line, semi-transparent", &GPU::gp0_Lines, 2, true, false},
-		{"Monocrome Polyline, opaque", &GPU::gp0_Lines, 255, true, true},
-		{"Monocrome Polyline, opaque", &GPU::gp0_Lines, 255, true, true},
-		{"Monocrome Polyline, semi-transparent", &GPU::gp0_Lines, 255, true, true},
-		{"Monocrome Polyline, semi-transparent", &GPU::gp0_Lines, 255, true, true},
-		{"Monocrome Polyline, opaque", &GPU::gp0_Lines, 255, true, true},
-		{"Monocrome Polyline, opaque", &GPU::gp0_Lines, 255, true, true},
-		{"Monocrome Polyline, semi-transparent", &GPU::gp0_Lines, 255, true, true},
-		{"Monocrome Polyline, semi-transparent", &GPU::gp0_Lines, 255, true, true},
-		{"Shaded line, opaque", &GPU::gp0_Lines, 3, true, false},
-		{"Shaded line, opaque", &GPU::gp0_Lines, 3, true, false},
-		{"Shaded line, semi-transparent", &GPU::gp0_Lines, 3, true, false},
-		{"Shaded line, semi-transparent", &GPU::gp0_Lines, 3, true, false},
-		{"Shaded line, opaque", &GPU::gp0_Lines, 3, true, false},
-		{"Shaded line, opaque", &GPU::gp0_Lines, 3, true, false},
-		{"Shaded line, semi-transparent", &GPU::gp0_Lines, 3, true, false},
-		{"Shaded line, semi-transparent", &GPU::gp0_Lines, 3, true, false},
-		{"Shaded Polyline, opaque", &GPU::gp0_Lines, 255, true, true},
-		{"Shaded Polyline, opaque", &GPU::gp0_Lines, 255, true, true},
-		{"Shaded Polyline, semi-transparent", &GPU::gp0_Lines, 255, true, true},
-		{"Shaded Polyline, semi-transparent", &GPU::gp0_Lines, 255, true, true},
-		{"Shaded Polyline, opaque", &GPU::gp0_Lines, 255, true, true},
-		{"Shaded Polyline, opaque", &GPU::gp0_Lines, 255, true, true},
-		{"Shaded Polyline, semi-transparent", &GPU::gp0_Lines, 255, true, true},
-		{"Shaded Polyline, semi-transparent", &GPU::gp0_Lines, 255, true, true},
-		{"Monocrome Rectangle, variable size, opaque", &GPU::gp0_Rectangles, 2, true, false},
-		{"Monocrome Rectangle, variable size, opaque", &GPU::gp0_Rectangles, 2, true, false},
-		{"Monocrome Rectangle, variable size, semi-transparent", &GPU::gp0_Rectangles, 2, true, false},
-		{"Monocrome Rectangle, variable size, semi-transparent", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, variable size, opaque, texture blending", &GPU::gp0_Rectangles, 3, true, false},
-		{"Textured Rectangle, variable size, opaque, raw texture", &GPU::gp0_Rectangles, 3, true, false},
-		{"Textured Rectangle, variable size, semi-transparent, texture blending", &GPU::gp0_Rectangles, 3, true, false},
-		{"Textured Rectangle, variable size, semi-transparent, raw texture", &GPU::gp0_Rectangles, 3, true, false},
-		{"Monocrome Rectangle, 1x1, opaque", &GPU::gp0_Rectangles, 1, true, false},
-		{"Monocrome Rectangle, 1x1, opaque", &GPU::gp0_Rectangles, 1, true, false },
-		{"Monocrome Rectangle, 1x1, semi-transparent", &GPU::gp0_Rectangles, 1, true, false},
-		{"Monocrome Rectangle, 1x1, semi-transparent", &GPU::gp0_Rectangles, 1, true, false },
-		{"Textured Rectangle, 1x1, opaque, texture blending", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 1x1, opaque, raw texture", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 1x1, semi-transparent, texture blending", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 1x1, semi-transparent, raw texture", &GPU::gp0_Rectangles, 2, true, false},
-		{"Monocrome Rectangle, 8x8, opaque", &GPU::gp0_Rectangles, 1, true, false},
-		{"Monocrome Rectangle, 8x8, opaque", &GPU::gp0_Rectangles, 1, true, false },
-		{"Monocrome Rectangle, 8x8, semi-transparent", &GPU::gp0_Rectangles, 1, true, false},
-		{"Monocrome Rectangle, 8x8, semi-transparent", &GPU::gp0_Rectangles, 1, true, false },
-		{"Textured Rectangle, 8x8, opaque, texture blending", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 8x8, opaque, raw texture", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 8x8, semi-transparent, texture blending", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 8x8, semi-transparent, raw texture", &GPU::gp0_Rectangles, 2, true, false},
-		{"Monocrome Rectangle, 16x16, opaque", &GPU::gp0_Rectangles, 1, true, false},
-		{"Monocrome Rectangle, 16x16, opaque", &GPU::gp0_Rectangles, 1, true, false },
-		{"Monocrome Rectangle, 16x16, semi-transparent", &GPU::gp0_Rectangles, 1, true, false},
-		{"Monocrome Rectangle, 16x16, semi-transparent", &GPU::gp0_Rectangles, 1, true, false },
-		{"Textured Rectangle, 16x16, opaque, texture blending", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 16x16, opaque, raw texture", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 16x16, semi-transparent, texture blending", &GPU::gp0_Rectangles, 2, true, false},
-		{"Textured Rectangle, 16x16, semi-transparent, raw texture", &GPU::gp0_Rectangles, 2, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit VRAM -> VRAM", &GPU::gp0_CopyVRam2VRam, 3, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Blit RAM  -> VRAM", &GPU::gp0_CopyRam2VRam, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"Copy Rectangle (VRAM to RAM)", &GPU::gp0_CopyVRam2Ram, 2, true, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"Draw Mode Setting", &GPU::gp0_DrawMode, 0, false, false},
-		{"Texture Window Setting", &GPU::gp0_TextureSetting, 0, false, false},
-		{"Set Drawing Area Top Left", &GPU::gp0_SetDrawAreaTop, 0, false, false},
-		{"Set Drawing Area Bottom Right", &GPU::gp0_SetDrawAreaBottom, 0, false, false},
-		{"Set Drawing Offset", &GPU::gp0_SetDrawOffset, 0, false, false},
-		{"Mask Bit Setting", &GPU::gp0_SetMaskBit, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false},
-		{"NOP", &GPU::gp0_NoOperation, 0, false, false}
-	};
-
 	gp1InstrSet =
 	{
 		{"Reset GPU", &GPU::gp1_ResetGpu, 0},
@@ -353,8 +355,8 @@ GPU::~GPU()
 bool GPU::reset()
 {
 	//Reset Scheduler Parameters
-	schedulerClockRatio = 11.0f / 7.0f; //GPU Clock is 11/7 of CPU Clock
-	schedulerClockTicks = 0.0f;
+	clockFraction = 0;
+	tickClock = 0;
 
 	//Reset Internal Registers
 	gp0DataLatch = 0x00000000;
@@ -432,35 +434,169 @@ bool GPU::reset()
 	return true;
 }
 
+bool GPU::serialize(SaveState& state)
+{
+	state.section("GPU ");
+	serializeSync(state);
+
+	//GPU Internal Registers
+	state.value(hBlank);
+	state.value(vBlank);
+	state.value(gp0DataLatch);
+	state.value(gp1DataLatch);
+	state.value(gpuReadLatch);
+	state.value(gpuStat);
+	state.value(fifo);
+
+	//Display and Drawing Configuration
+	state.value(displayStart);
+	state.value(displayRange);
+	state.value(displayResolution);
+	state.value(displayMode);
+	state.value(displayColorMode);
+	state.value(dotClockRatio);
+	state.value(displayDisabled);
+	state.value(verticalInterlace);
+	state.value(drawingArea);
+	state.value(drawingOffset);
+	state.value(textureMask);
+	state.value(textureOffset);
+	state.value(texturePage);
+	state.value(semiTransparencyMode);
+	state.value(colorMode);
+	state.value(ditherEnabled);
+	state.value(drawingOnDisplayEnabled);
+	state.value(rectangleTexFlipX);
+	state.value(rectangleTexFlipY);
+	state.value(textureDisabled);
+	state.value(forceMask);
+	state.value(checkMask);
+
+	//Command Interpreter Status
+	state.value(recvCommand);
+	state.value(recvParameters);
+	state.value(gp0CommandAvailable);
+	state.value(gp0Opcode);
+	state.value(gp0Command);
+	state.value(gp0CommandParameters);
+	state.value(gp0ReadParameters);
+	state.value(gp0CommandFifo);
+	state.value(gp0RecvPolyLine);
+	state.value(gp1CommandAvailable);
+	state.value(gp1Opcode);
+	state.value(gp1Command);
+	state.value(cmdPipelineState);
+
+	//Timing Status
+	state.value(gpuClockTicks);
+	state.value(hCount);
+	state.value(vCount);
+	state.value(tickCountPerScanline);
+	state.value(tickCountPerDots);
+	state.value(tickCountPerHBlank);
+	state.value(scanlinePerFrame);
+	state.value(scanlinePerVBlank);
+	state.value(newScanline);
+	state.value(newFrame);
+	state.value(clockFraction);
+	state.value(vramAccessState);
+
+	//Video RAM, copied in a single block straight from/to the snapshot
+	uint16_t* vram = reinterpret_cast<uint16_t*>(state.block(VRAM_SIZE * sizeof(uint16_t)));
+	if (vram == nullptr)
+		return false;
+	if (state.isSaving() && !Renderer::SaveVRAM(std::span<uint16_t>(vram, VRAM_SIZE)))
+	{
+		LOG_F(ERROR, "GPU - Unable to read VRAM for Save State!");
+		return false;
+	}
+
+	//A CPU to VRAM transfer in progress is only in the Access Buffer until its last word
+	std::vector<uint16_t> transfer;
+	if (state.isSaving() && vramAccessState.write)
+	{
+		for (uint32_t i = 0; i < vramAccessState.size.x * vramAccessState.size.y; i++)
+			transfer.push_back(Renderer::ReadVRAM((vramAccessState.dst.x + i % vramAccessState.size.x) % 1024, (vramAccessState.dst.y + i / vramAccessState.size.x) % 512));
+	}
+	state.vector(transfer);
+
+	if (state.isLoading() && state.isValid())
+	{
+		if (!Renderer::LoadVRAM(std::span<const uint16_t>(vram, VRAM_SIZE)))
+		{
+			LOG_F(ERROR, "GPU - Unable to write VRAM from Save State!");
+			return false;
+		}
+		for (uint32_t i = 0; i < transfer.size(); i++)
+			Renderer::WriteVRAM((vramAccessState.dst.x + i % vramAccessState.size.x) % 1024, (vramAccessState.dst.y + i / vramAccessState.size.x) % 512, transfer[i]);
+		restoreRendererState();
+	}
+
+	return state.isValid();
+}
+
 //-----------------------------------------------------------------------------------------------------
 // 
 //                               HELPER FUNCTIONS
 // 
 //-----------------------------------------------------------------------------------------------------
+void GPU::restoreRendererState()
+{
+	//Renderer keeps its own copy of the GPU configuration, push it again after a Save State load
+	Renderer::SetDisplayStart(displayStart);
+	Renderer::SetDisplayDisable(displayDisabled);
+	Renderer::SetDisplayResolution(displayResolution);
+	Renderer::SetDisplayInterlaceMode(verticalInterlace);
+	Renderer::SetDisplayColorMode(displayColorMode);
+
+	Renderer::SetTexturePage(texturePage);
+	Renderer::SetTransparencyMode(semiTransparencyMode);
+	Renderer::SetTextureColorMode(colorMode);
+	Renderer::SetDither(ditherEnabled);
+	Renderer::SetDrawingOnDisplayEnabled(drawingOnDisplayEnabled);
+	Renderer::SetTextureDisable(textureDisabled);
+	Renderer::SetRectangleTextureFlip(rectangleTexFlipX, rectangleTexFlipY);
+	Renderer::SetTextureMask(textureMask);
+	Renderer::SetTextureOffset(textureOffset);
+	Renderer::SetDrawingArea(drawingArea);
+	Renderer::SetDrawingOffset(drawingOffset);
+	Renderer::SetMaskBit(checkMask, forceMask);
+}
+
 inline bool GPU::writeVRAM(uint32_t data, bool masked)
+{
+	return writeVRAMBlock(std::span<const uint32_t>(&data, 1), masked);
+}
+
+bool GPU::writeVRAMBlock(std::span<const uint32_t> data, bool masked)
 {
 	if (vramAccessState.dataWrite == 0)
 	{
 		vramAccessState.dataLenght = vramAccessState.size.x * vramAccessState.size.y;
 		vramAccessState.writePos = vramAccessState.dst;
 	}
-		
-	uint16_t l = static_cast<uint16_t>((data & 0x0000ffff));
-	uint16_t h = static_cast<uint16_t>((data & 0xffff0000) >> 16);
 
-	if (masked)
-	{
-		Renderer::WriteVRAMMasked(vramAccessState.writePos.x, vramAccessState.writePos.y, l);
-		Renderer::WriteVRAMMasked(vramAccessState.writePos.x + 1, vramAccessState.writePos.y, h);
-	}
-	else
+	//Each word holds two pixels, low halfword first. Pixels fill the rectangle row by row,
+	//an odd pixel count leaves the last halfword of the transfer unused
+	const uint16_t* pixels = reinterpret_cast<const uint16_t*>(data.data());
+	uint32_t count = std::min(static_cast<uint32_t>(data.size()) * 2, vramAccessState.dataLenght - vramAccessState.dataWrite);
+
+	while (count > 0)
 	{
-		Renderer::WriteVRAM(vramAccessState.writePos.x, vramAccessState.writePos.y, l);
-		Renderer::WriteVRAM(vramAccessState.writePos.x + 1, vramAccessState.writePos.y, h);
+		uint32_t column = vramAccessState.dataWrite % vramAccessState.size.x;
+		uint16_t x = (vramAccessState.dst.x + column) % 1024;
+		uint16_t y = (vramAccessState.dst.y + vramAccessState.dataWrite / vramAccessState.size.x) % 512;
+
+		//Rest of the row, split where it wraps around the right edge of VRAM
+		uint32_t length = std::min({ count, vramAccessState.size.x - column, 1024u - x });
+		Renderer::WriteVRAMBlock(x, y, std::span<const uint16_t>(pixels, length), masked);
+
+		pixels += length;
+		count -= length;
+		vramAccessState.dataWrite += length;
 	}
 
 	//Update Data Pointer in VRAM
-	vramAccessState.dataWrite += 2;
 	vramAccessState.writePos.x = ((vramAccessState.dataWrite % vramAccessState.size.x) + vramAccessState.dst.x) % 1024; //Horizontal Wrapping
 	vramAccessState.writePos.y = ((vramAccessState.dataWrite / vramAccessState.size.x) + vramAccessState.dst.y) % 512;	//Vertical Wrapping
 	
@@ -485,8 +621,10 @@ inline uint32_t GPU::readVRAM()
 		Renderer::SyncAccessBuffer(vramAccessState.src.x, vramAccessState.src.y, vramAccessState.size.x, vramAccessState.size.y);
 	}
 
+	//Second pixel of the word is the next one along the rectangle rows, as writeVRAMBlock stores them
+	uint32_t next = vramAccessState.dataRead + 1;
 	uint16_t l = Renderer::ReadVRAM(vramAccessState.readPos.x, vramAccessState.readPos.y);
-	uint16_t h = Renderer::ReadVRAM(vramAccessState.readPos.x + 1, vramAccessState.readPos.y);
+	uint16_t h = Renderer::ReadVRAM((vramAccessState.src.x + next % vramAccessState.size.x) % 1024, (vramAccessState.src.y + next / vramAccessState.size.x) % 512);
 	uint32_t data = (h << 16) | l;
 
 	//Update Data Pointer in VRAM
@@ -525,9 +663,15 @@ bool GPU::updateVHBlank()
 		newFrame = true;
 	}
 
-	//Update hBlank and vBlank Status
-	hBlank = !(hCount < (tickCountPerScanline - tickCountPerHBlank));
-	vBlank = !(vCount < (scanlinePerFrame - scanlinePerVBlank));
+	//Update hBlank and vBlank Status, Counters synchronized to blanking catch up with the old one first
+	bool nextHBlank = !(hCount < (tickCountPerScanline - tickCountPerHBlank));
+	bool nextVBlank = !(vCount < (scanlinePerFrame - scanlinePerVBlank));
+	if (nextHBlank != hBlank)
+		psx->timers->blankEdge(0, nextHBlank, tickClock);
+	if (nextVBlank != vBlank)
+		psx->timers->blankEdge(1, nextVBlank, tickClock);
+	hBlank = nextHBlank;
+	vBlank = nextVBlank;
 
 	//Check if I need to trigger vBlank Interrupt or hBlank Clock on raising edge
 	//According to vBlank and hBlank new status
@@ -553,50 +697,92 @@ bool GPU::updateVHBlank()
 //                               GPU Interface
 // 
 //-----------------------------------------------------------------------------------------------------
-bool GPU::runticks()
+bool GPU::runTicks(uint32_t cycles)
 {
-	schedulerClockTicks += schedulerClockRatio;
-	while (schedulerClockTicks >= 1.0f)
+	PROFILE_ZONE(ProfileZone::Gpu);
+
+	//Convert CPU Cycles to GPU Clock Ticks
+	uint64_t fraction = static_cast<uint64_t>(cycles) * GPU_CLOCK_MUL + clockFraction;
+	uint64_t ticks = fraction / GPU_CLOCK_DIV;
+	clockFraction = static_cast<uint32_t>(fraction % GPU_CLOCK_DIV);
+
+	while (ticks > 0)
 	{
-		execute();
-		schedulerClockTicks -= 1.0f;
+		//Pending commands and blanking edges go through the full GPU Tick
+		uint64_t quiet = (gp0CommandAvailable || gp1CommandAvailable) ? 0 : std::min<uint64_t>(quietTicks(), ticks);
+		if (quiet == 0)
+		{
+			tickClock = syncClock - ((ticks - 1) * GPU_CLOCK_DIV + clockFraction) / GPU_CLOCK_MUL;
+			execute();
+			ticks--;
+			continue;
+		}
+
+		//Nothing but the beam position and the Dot Clock moves until the next edge
+		if (psx->timers->usesClock(ClockSource::Dot))
+		{
+			uint64_t dots = (gpuClockTicks + quiet + tickCountPerDots - 1) / tickCountPerDots - (gpuClockTicks + tickCountPerDots - 1) / tickCountPerDots;
+			psx->timers->execute(ClockSource::Dot, static_cast<uint32_t>(dots));
+		}
+		hCount += static_cast<uint32_t>(quiet);
+		gpuClockTicks += quiet;
+		ticks -= quiet;
 	}
+
+	//Wake up on the next hBlank or Scanline edge
+	uint64_t nextTicks = static_cast<uint64_t>(quietTicks()) + 1;
+	psx->scheduler->schedule(SchedulerEvent::Gpu, (nextTicks * GPU_CLOCK_DIV - clockFraction + GPU_CLOCK_MUL - 1) / GPU_CLOCK_MUL);
+
 	return true;
 }
 
-bool GPU::execute()
+// Number of GPU Ticks before the next one raising an hBlank edge or starting a new Scanline.
+// Those ticks only move hCount and can be skipped in bulk.
+uint32_t GPU::quietTicks() const
 {
-	uint32_t data;
+	uint32_t next = hCount + 1;
+	uint32_t hBlankStart = tickCountPerScanline - tickCountPerHBlank;
+
+	if (next >= tickCountPerScanline)
+		return 0;
+
+	return ((next <= hBlankStart) ? hBlankStart : tickCountPerScanline) - next;
+}
 
-	auto gp0RunCommand = [&]()
+bool GPU::gp0RunCommand()
+{
+	bool bResult;
+
+	if (gp0CommandFifo)
 	{
-		bool bResult;
+		//It is a Command stored on the FIFO
+		//Flush the Command from FIFO first. Already have its value on gp0Command.	
+		uint32_t tmp;
+		fifo.pop(tmp);
+		
+		LOG_F(1, "GPU - %s (params: %d) [%xh]", gp0InstrSet[gp0Opcode].mnemonic, gp0InstrSet[gp0Opcode].parameters, gp0Opcode);
+		bResult = (this->*gp0InstrSet[gp0Opcode].operate)();
+		if (!bResult)
+			LOG_F(ERROR, "GPU - Unimplemented GP0 Command %s!", gp0InstrSet[gp0Opcode].mnemonic);
+	}
+	else
+	{
+		//It isn't a command stored on the FIFO
+		//Actual GP0 Command its already on gp0Command
 
-		if (gp0CommandFifo)
-		{
-			//It is a Command stored on the FIFO
-			//Flush the Command from FIFO first. Already have its value on gp0Command.	
-			uint32_t tmp;
-			fifo.pop(tmp);
-			
-			LOG_F(1, "GPU - %s (params: %d) [%xh]", gp0InstrSet[gp0Opcode].mnemonic.c_str(), gp0InstrSet[gp0Opcode].parameters, gp0Opcode);
-			bResult = (this->*gp0InstrSet[gp0Opcode].operate)();
-			if (!bResult)
-				LOG_F(ERROR, "GPU - Unimplemented GP0 Command %s!", gp0InstrSet[gp0Opcode].mnemonic.c_str());
-		}
-		else
-		{
-			//It isn't a command stored on the FIFO
-			//Actual GP0 Command its already on gp0Command
+		LOG_F(1, "GPU - %s (params: %d) [%xh]", gp0InstrSet[gp0Opcode].mnemonic, gp0InstrSet[gp0Opcode].parameters, gp0Opcode);
+		bResult = (this->*gp0InstrSet[gp0Opcode].operate)();
+		if (!bResult)
+			LOG_F(ERROR, "GPU - Unimplemented GP0 Command %s!", gp0InstrSet[gp0Opcode].mnemonic); 
+	}
+
+	return bResult;
+}
+
+bool GPU::execute()
+{
+	uint32_t data;
 
-			LOG_F(1, "GPU - %s (params: %d) [%xh]", gp0InstrSet[gp0Opcode].mnemonic.c_str(), gp0InstrSet[gp0Opcode].parameters, gp0Opcode);
-			bResult = (this->*gp0InstrSet[gp0Opcode].operate)();
-			if (!bResult)
-				LOG_F(ERROR, "GPU - Unimplemented GP0 Command %s!", gp0InstrSet[gp0Opcode].mnemonic.c_str()); 
-		}
-	
-		return 0;
-	};
 	auto gp1RunCommand = [&]()
 	{
 		bool bResult;
@@ -787,6 +973,8 @@ uint32_t GPU::readAddr(uint32_t addr, uint8_t bytes)
 			data = readVRAM();
 		break;
 	case 0x1f801814:
+		//Ready bits 26 and 28 follow the GP0 parser on this thread, no bit waits for queued primitives to be rasterized.
+		//Polling doesn't sync with the Software Rasterizer, VRAM reads do.
 		data = gpuStat;			//--------------------------------------GPU Status Register
 		break;
 
@@ -798,12 +986,54 @@ uint32_t GPU::readAddr(uint32_t addr, uint8_t bytes)
 	LOG_F(3, "GPU - Read from Register:\t\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
 	return data;
 }
+
+// DMA Burst to GP0. The GPU gets no Tick between two words of the burst, so every
+// command runs as soon as its last parameter is in, ahead of the data following it.
+// Image data of a CPU to VRAM transfer goes to VRAM a whole row at a time.
+bool GPU::writeGP0(std::span<const uint32_t> data)
+{
+	size_t i = 0;
+	while (i < data.size())
+	{
+		if (gp0CommandAvailable)
+			gp0RunCommand();
+
+		uint32_t dmaDirection = (gpuStat >> 29) & 0x3;
+		if (vramAccessState.write && (dmaDirection == 2 || dmaDirection == 0))
+		{
+			size_t words = std::min<size_t>(data.size() - i, vramWriteWords());
+			gp0DataLatch = data[i + words - 1];
+			writeVRAMBlock(data.subspan(i, words));
+			i += words;
+		}
+		else
+		{
+			uint32_t word = data[i++];
+			writeAddr(0x1f801810, word);
+		}
+	}
+
+	if (gp0CommandAvailable)
+		gp0RunCommand();
+
+	return true;
+}
+
+// DMA Burst from GPUREAD
+bool GPU::readGP0(std::span<uint32_t> data)
+{
+	for (uint32_t& word : data)
+		word = readAddr(0x1f801810);
+
+	return true;
+}
 //-----------------------------------------------------------------------------------------------------
 // 
 //                               GP0 Full Instruction Set
 // 
 //-----------------------------------------------------------------------------------------------------
 
+template<uint8_t opcode>
 bool GPU::gp0_Lines()
 {
 	// Parse Lines Render Command
@@ -814,42 +1044,37 @@ bool GPU::gp0_Lines()
 	// 2            1/0     Unused
 	// 1            1/0     semi-transparent / opaque
 	// 0            1/0     Unused
-	bool		shaded = (gp0Opcode & 0x10) ? true : false;
-	bool		polyline  = (gp0Opcode & 0x08) ? true : false;
-	bool		semiTransparent  = (gp0Opcode & 0x02) ? true : false;
-	uint32_t	param;
-		
-	param = gp0Command;
+	constexpr bool	shaded = (opcode & 0x10) ? true : false;
+	constexpr bool	polyline  = (opcode & 0x08) ? true : false;
+	constexpr bool	semiTransparent  = (opcode & 0x02) ? true : false;
 
-	LOG_F(2, "GPU - Line Type, Shaded: %d, SemiTransparent: %d, Polyline: %d", shaded, semiTransparent, polyline);
-	LOG_F(2, "GPU - Line Parameter [0]: 0x%08x", param);
-	for (int i = 0; i < fifo.length(); ++i)
-	{
-		LOG_F(2, "GPU - Line Parameter [%d]: 0x%08x", i + 1, fifo[i]);
-	}
+	LOG_F(2, "GPU - Line Type, Shaded: %d, SemiTransparent: %d, Polyline: %d [0x%08x]", shaded, semiTransparent, polyline, gp0Command);
 
 	//Set Renderer Status Before Rendering Lines
 	Renderer::SetTransparency(semiTransparent);
-	
+
 	//Set Vertex Buffer
 	GpuVertex verts[2];
 
-	//First Vertex
-	decodeColor(param, verts[0]);
-	fifo.pop(param);
-	decodePosition(param, verts[0]);
-	fifo.pop(param);
-	//Reset Texture Coordinates since Lines don't have texture
-	verts[0].u = 0;
-	verts[0].v = 0;
-
-	if (polyline)
+	if constexpr (polyline)
 	{
+		//Polyline length is only known from its terminator, vertices are read one word at a time
+		uint32_t param = gp0Command;
+
+		//First Vertex
+		decodeColor(param, verts[0]);
+		fifo.pop(param);
+		decodePosition(param, verts[0]);
+		fifo.pop(param);
+		//Reset Texture Coordinates since Lines don't have texture
+		verts[0].u = 0;
+		verts[0].v = 0;
+
 		while((param & 0xf000f000) != 0x50005000)
 		{
 			//Other Vertex
 			verts[1] = verts[0]; //Settink v1 color equal to v0 color for Monocrome Lines.
-			if (shaded)
+			if constexpr (shaded)
 			{
 				decodeColor(param, verts[1]);
 				fifo.pop(param);
@@ -866,23 +1091,33 @@ bool GPU::gp0_Lines()
 	}
 	else
 	{
+		//Parameters are Position 0, Color 1 (shaded only) and Position 1, word 0 is the Command itself
+		constexpr int paramNum = shaded ? 3 : 2;
+		uint32_t param[1 + paramNum];
+		param[0] = gp0Command;
+		fifo.pop(param + 1, paramNum);
+
+		//First Vertex, Lines don't have texture
+		decodeColor(param[0], verts[0]);
+		decodePosition(param[1], verts[0]);
+		verts[0].u = 0;
+		verts[0].v = 0;
+
 		//Second Vertex
 		verts[1] = verts[0]; //Setting v1 color equal to v0 color for Monocrome Lines.
-		if (shaded)
-		{
-			decodeColor(param, verts[1]);
-			fifo.pop(param);
-		}
-		decodePosition(param, verts[1]);
+		if constexpr (shaded)
+			decodeColor(param[2], verts[1]);
+		decodePosition(param[paramNum], verts[1]);
 		Renderer::DrawLine(verts);
-	}	
-	
+	}
+
 	//Reset GPUSTAT Flag to receive next GP0 command
 	gp0_ResetStatus();
 
 	return true;
 }
 
+template<uint8_t opcode>
 bool GPU::gp0_Rectangles()
 {
 	// Parse Rectangles Render Command
@@ -892,74 +1127,50 @@ bool GPU::gp0_Rectangles()
 	// 2            1/0     textured / untextured
 	// 1            1/0     semi-transparent / opaque
 	// 0            1/0     raw texture / texture blending
-		
-	uint8_t		recType = (gp0Opcode & 0x18) >> 3;
-	bool		textured  = (gp0Opcode & 0x04) ? true : false;
-	bool		semiTransparent  = (gp0Opcode & 0x02) ? true : false;
-	bool		texblending  = (gp0Opcode & 0x01) ? false : true;
-	uint16_t	texPageInfo = 0;
-	uint16_t	clutInfo = 0;
+	constexpr uint8_t	recType = (opcode & 0x18) >> 3;
+	constexpr bool		textured  = (opcode & 0x04) ? true : false;
+	constexpr bool		semiTransparent  = (opcode & 0x02) ? true : false;
+	constexpr bool		texblending  = (opcode & 0x01) ? false : true;
 
-	uint32_t	param;
-	GpuVertex	recDimension;
+	//Parameters are Position, Texture (textured only) and Size (variable size only), word 0 is the Command itself
+	constexpr int		paramNum = 1 + textured + (recType == 0);
+	uint32_t			param[1 + paramNum];
+	param[0] = gp0Command;
+	fifo.pop(param + 1, paramNum);
 
-	// Parse all Polygon Command Parameters from FIFO directly into Triangle vertex temporaries
-	param = gp0Command;
-
-	LOG_F(2, "GPU - Rectangle Type: %d, Textured: %d, SemiTransparent: %d, TextureBlending: %d", recType, textured, semiTransparent, texblending);
-	LOG_F(2, "GPU - Rectangle Parameter [0]: 0x%08x", param);
-	for(int i = 0; i<fifo.length(); ++i)
-	{
-		LOG_F(2, "GPU - Rectangle Parameter [%d]: 0x%08x", i+1, fifo[i]);
-	}
+	LOG_F(2, "GPU - Rectangle Type: %d, Textured: %d, SemiTransparent: %d, TextureBlending: %d [0x%08x]", recType, textured, semiTransparent, texblending, gp0Command);
 
 	//Set Vertex Buffer
 	GpuVertex verts[MAX_VERTEX_NUMBER];
-	
+	GpuVertex recDimension;
+	uint16_t clutInfo = 0;
+
 	//Extract All Rectangle Parameters
-	decodeColor(param, verts[0]);
-	fifo.pop(param);
-	decodePosition(param, verts[0]);
-	
+	decodeColor(param[0], verts[0]);
+	decodePosition(param[1], verts[0]);
+
 	//Texture info, only for textured rectangles
-	if (textured)										
+	if constexpr (textured)
 	{
-		fifo.pop(param);
-		clutInfo = decodeTexture(param, verts[0]);
+		clutInfo = decodeTexture(param[2], verts[0]);
 	}
 	else
 	{
-		for(int i = 0; i < 4; ++i)
-		{
-			verts[i].u = 0;
-			verts[i].v = 0;
-		}
+		verts[0].u = 0;
+		verts[0].v = 0;
 	}
-	
+
 	//Set Rectangle Size according to type
-	switch (recType)
+	if constexpr (recType == 0)			//Variable Size
 	{
-		case 0:			//Variable Size
-			fifo.pop(param);
-			decodePosition(param, recDimension);
-			break;
-		case 1:			//Single pixel
-			recDimension.x = 1;
-			recDimension.y = 1;
-			break;
-		case 2:			//8x8 Sprite
-			recDimension.x = 8;
-			recDimension.y = 8;
-			break;
-		case 3:			//16x16 Sprite
-			recDimension.x = 16;
-			recDimension.y = 16;
-			break;
-	};
-
-	//Extract CLUT Info if present
-	lite::vec2t<uint16_t> clutCoords{0, 0};
-	decodeClut(clutInfo, clutCoords);
+		decodePosition(param[paramNum], recDimension);
+	}
+	else								//Single pixel, 8x8 or 16x16 Sprite
+	{
+		constexpr uint16_t size = (recType == 1) ? 1 : (recType == 2) ? 8 : 16;
+		recDimension.x = size;
+		recDimension.y = size;
+	}
 
 	//Generate All remaining vertex
 	verts[1] = verts[0];  //Start from first vertex values
@@ -967,12 +1178,12 @@ bool GPU::gp0_Rectangles()
 
 	verts[2] = verts[0];  //Start from first vertex values
 	verts[2].y += recDimension.y;
-	
+
 	verts[3] = verts[0];  //Start from first vertex values
 	verts[3].x += recDimension.x;
 	verts[3].y += recDimension.y;
-	
-	if (textured)
+
+	if constexpr (textured)
 	{
 		verts[1].u += recDimension.x;
 		verts[2].u += recDimension.x;
@@ -984,26 +1195,27 @@ bool GPU::gp0_Rectangles()
 	Renderer::SetTextureMode(textured, texblending);
 	Renderer::SetTransparency(semiTransparent);
 
-	if (textured)
+	if constexpr (textured)
 	{
-		//Renderer::SetTextureMode(textured, texblending);
-		//Renderer::SetTextureColorMode(colorMode);
+		//Extract CLUT Info
+		lite::vec2t<uint16_t> clutCoords{0, 0};
+		decodeClut(clutInfo, clutCoords);
 		Renderer::SetClutTable(clutCoords);
 	}
-	
-	
+
 	//Draw Rectangle
-	if (recType == 1)
+	if constexpr (recType == 1)
 		Renderer::DrawPoint(verts);
 	else
 		Renderer::DrawRectangle(verts);
-	
+
 	//Reset GPUSTAT Flag to receive next GP0 command
 	gp0_ResetStatus();
 
 	return true;
 }
 
+template<uint8_t opcode>
 bool GPU::gp0_Polygons()
 {
 	//Parse Polygon Render Command
@@ -1014,84 +1226,73 @@ bool GPU::gp0_Polygons()
 	// 2            1/0     textured / untextured
 	// 1            1/0     semi transparent / solid
 	// 0            1/0     raw texture / texture blending
-	bool		shaded = (gp0Opcode & 0x10) ? true : false;
-	bool		textured  = (gp0Opcode & 0x04) ? true : false;
-	bool		semiTransparent  = (gp0Opcode & 0x02) ? true : false;
-	bool		texblending  = (gp0Opcode & 0x01) ? false : true;
-	uint8_t		vertexNum = (gp0Opcode & 0x08) ? 4 : 3;		
-	
-	uint16_t	texPageInfo = 0;
-	uint16_t	clutInfo = 0;
-	uint32_t 	param;
-	
-	// Parse all Polygon Command Parameters from FIFO directly into Triangle vertex temporaries
-	param = gp0Command;
+	constexpr bool		shaded = (opcode & 0x10) ? true : false;
+	constexpr bool		quad = (opcode & 0x08) ? true : false;
+	constexpr bool		textured  = (opcode & 0x04) ? true : false;
+	constexpr bool		semiTransparent  = (opcode & 0x02) ? true : false;
+	constexpr bool		texblending  = (opcode & 0x01) ? false : true;
+	constexpr uint8_t	vertexNum = quad ? 4 : 3;
+
+	//Each Vertex is Color (shaded only, the first one is the Command itself), Position and Texture (textured only)
+	constexpr int		stride = 1 + shaded + textured;
+	constexpr int		paramNum = vertexNum * stride - shaded;
+	uint32_t			param[1 + paramNum];
+	param[0] = gp0Command;
+	fifo.pop(param + 1, paramNum);
+
+	LOG_F(2, "GPU - Polygon Type, Shaded: %d, Textured: %d, SemiTransparent: %d, TextureBlending: %d, Vertex: %d [0x%08x]", shaded, textured, semiTransparent, texblending, vertexNum, gp0Command);
 
-	LOG_F(2, "GPU - Polygon Type, Shaded: %d, Textured: %d, SemiTransparent: %d, TextureBlending: %d, Vertex: %d", shaded, textured, semiTransparent, texblending, vertexNum);
-	LOG_F(2, "GPU - Polygon Parameter [0]: 0x%08x", param);
-	for (int i = 0; i < fifo.length(); ++i)
-	{
-		LOG_F(2, "GPU - Polygon Parameter [%d]: 0x%08x", i + 1, fifo[i]);
-	}
-	
 	//Set Vertex Buffer
 	GpuVertex verts[MAX_VERTEX_NUMBER];
 
-	//Extract all Vertex Data
-	for (int i = 0; i < vertexNum; ++i)
+	//Extract Vertex Data, Monocrome Polygons use first vertex color for all vertex. Returns the CLUT or Texture Page Info sharing the Texture word
+	auto decodeVertex = [&](int i)
 	{
-		for (int j = 0; j < MAX_POLYGON_PARAMS; ++j)
+		const uint32_t* word = param + 1 + i * stride;		//Position word
+		uint16_t info = 0;
+
+		decodeColor(shaded ? word[-1] : param[0], verts[i]);
+		decodePosition(word[0], verts[i]);
+		if constexpr (textured)
 		{
-			switch (j)
-			{
-			case 0: // COLOR
-				if (shaded || i == 0)
-				{
-					decodeColor(param, verts[i]);
-					fifo.pop(param);
-				} // Shaded Polygons have a different colour for each vertex
-				else
-				{
-					decodeColor(gp0Command, verts[i]);
-				}  // Monocrome Polygons use first vertex color for all vertex
-				break;
-
-			case 1: // POSITION
-				decodePosition(param, verts[i]);
-				fifo.pop(param);
-				break;
-			case 2: // TEXTURE
-				if (textured && i == 0) { clutInfo = decodeTexture(param, verts[i]); fifo.pop(param);}
-				else if (textured && i == 1) { texPageInfo = decodeTexture(param, verts[i]); fifo.pop(param);}
-				else if (textured && i > 1) { decodeTexture(param, verts[i]); fifo.pop(param);}
-				else { verts[i].u = 0; verts[i].v = 0;}
-				break;
-			}
+			info = decodeTexture(word[1], verts[i]);
 		}
-	}
-	
-	if (textured)
+		else
+		{
+			verts[i].u = 0;
+			verts[i].v = 0;
+		}
+		return info;
+	};
+
+	uint16_t clutInfo = decodeVertex(0);
+	uint16_t texPageInfo = decodeVertex(1);
+	decodeVertex(2);
+	if constexpr (quad)
+		decodeVertex(3);
+
+	if constexpr (textured)
 	{
-		//Extract Texture Page Info if present
+		//Extract Texture Page Info
 		lite::vec2t<uint16_t> texPageCoords{0, 0};
 		uint8_t colorMode = 0;
 		uint8_t semiTransMode = 0;
 		decodeTexPage(texPageInfo, texPageCoords, colorMode, semiTransMode);
 
-		//Extract CLUT Info if present
+		//Extract CLUT Info
 		lite::vec2t<uint16_t> clutCoords{0, 0};
 		decodeClut(clutInfo, clutCoords);
 
-		Renderer::SetTransparencyMode(semiTransMode);	
+		Renderer::SetTransparencyMode(semiTransMode);
 		Renderer::SetTextureColorMode(colorMode);
 		Renderer::SetTexturePage(texPageCoords);
 		Renderer::SetClutTable(clutCoords);
 	}
-	
+
 	//Set Renderer Status
 	Renderer::SetTransparency(semiTransparent);
 	Renderer::SetTextureMode(textured, texblending);
-	
+
 	//Draw Polygon depending on number of vertices
 	Renderer::DrawPolygon(verts, vertexNum);
 
@@ -1119,8 +1320,10 @@ bool GPU::gp0_CopyVRam2VRam()
 	vramAccessState.size.x = ((static_cast<uint16_t>((param & 0x0000ffff)) - 1) & 0x3ff) + 1;
 	vramAccessState.size.y = ((static_cast<uint16_t>((param & 0xffff0000) >> 16) - 1) & 0x1ff) + 1;
 
+	//OpenGL copies the rectangle on the GPU, otherwise it goes through the Access Buffer.
 	//This is done on a single clock cycle to ease the implementation
-	while (!writeVRAM(readVRAM(), true)) {};
+	if (!Renderer::CopyVRAM(vramAccessState.src.x, vramAccessState.src.y, vramAccessState.dst.x, vramAccessState.dst.y, vramAccessState.size.x, vramAccessState.size.y))
+		while (!writeVRAM(readVRAM(), true)) {};
 		
 	LOG_F(2, "GPU - Read from VRAM at [x: %d, y: %d]", vramAccessState.src.x, vramAccessState.src.y);
 	LOG_F(2, "GPU - Write to VRAM at  [x: %d, y: %d]", vramAccessState.dst.x, vramAccessState.dst.y);
@@ -4,10 +4,13 @@
 #include <cstdio>
 #include <cstring>
 #include <vector>
+#include <array>
 #include <string>
 #include <memory>
+#include <span>
 
 #include "litelib.h"
+#include "device.h"
 #include "gpu_utils.h"
 
 class Psx;
@@ -26,7 +29,6 @@ constexpr auto PAL_SCANLINES_PER_VBLANK = 25;
 
 //GPU Constants
 constexpr auto VRAM_SIZE = 1024 * 512;
-constexpr auto MAX_POLYGON_PARAMS = 3;
 constexpr auto MAX_RECTANGLE_PARAMS = 4;
 
 //GPU Video Modes
@@ -95,8 +97,12 @@ namespace gpu
 
 }
 
+//GPU Clock is 11/7 of CPU Clock
+constexpr auto GPU_CLOCK_MUL = 11;
+constexpr auto GPU_CLOCK_DIV = 7;
+
 //GPU Class
-class GPU
+class GPU : public Device
 {
 public:
 	GPU();
@@ -104,13 +110,18 @@ public:
 
 	bool reset();
 	bool execute();
-	bool runticks();
+	bool runTicks(uint32_t cycles) override;
+	bool serialize(SaveState& state) override;
 
 	bool writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes = 4);
 	uint32_t readAddr(uint32_t addr, uint8_t bytes = 4);
 
+	//DMA Channel 2 Bursts
+	bool writeGP0(std::span<const uint32_t> data);
+	bool readGP0(std::span<uint32_t> data);
+
 	//Connect to PSX Instance
-	void link(Psx* instance) { psx = instance; }
+	void link(Psx* instance) override { psx = instance; }
 
 	//Getter for GPU Internal Registers
 	uint32_t getGPUStat() const { return gpuStat; }
@@ -165,8 +176,13 @@ public:
 
 private:
 	bool writeVRAM(uint32_t data, bool masked = false);
+	bool writeVRAMBlock(std::span<const uint32_t> data, bool masked = true);
+	uint32_t vramWriteWords() const { return (vramAccessState.size.x * vramAccessState.size.y - vramAccessState.dataWrite + 1) / 2; }	//Words left in the CPU to VRAM transfer
 	uint32_t readVRAM();
 	bool updateVHBlank();
+	bool gp0RunCommand();
+	uint32_t quietTicks() const;
+	void restoreRendererState();
 
 private:
 	//Link to Bus Object
@@ -233,8 +249,8 @@ private:
 	uint32_t					scanlinePerVBlank;			//The number of scanlines per VBlank, updated by by GP1(08h) - Display Mode
 	bool						newScanline;				//Set if a new Scanline has startes
 	bool						newFrame;					//Set if a new Frame has started
-	float						schedulerClockTicks;
-	float						schedulerClockRatio;
+	uint32_t					clockFraction;				//Remainder of the CPU to GPU Clock conversion (in 1/7 of GPU Tick)
+	uint64_t					tickClock;					//Master Clock of the GPU Tick being executed, blanking edges are reported at it
 		
 	//GPU Memory Operation Status & Configurations
 	gpu::VideoMemoryAccessState	vramAccessState;			//Current VRAM Access Status & Configuration
@@ -242,7 +258,7 @@ private:
 	//GPU Instruction Dictionaries and Functions
 	struct INSTRGP0
 	{
-		std::string mnemonic;
+		const char* mnemonic;
 		bool(GPU::* operate)() = nullptr;
 		uint8_t parameters;
 		bool fifo;
@@ -256,7 +272,7 @@ private:
 		uint8_t parameters;
 	};
 
-	std::vector<INSTRGP0> gp0InstrSet;						//Full GP0 Instruction Set
+	static const std::array<INSTRGP0, 256> gp0InstrSet;		//Full GP0 Instruction Set, constexpr table defined in gpu.cpp
 	std::vector<INSTRGP1> gp1InstrSet;						//Full GP1 Instruction Set
 
 	//GP0 Instructions
@@ -264,9 +280,9 @@ private:
 	bool gp0_ClearTextureCache();							//GP0(01h), Clear Texture Cache
 	bool gp0_FillVRam();									//GP0(02h), Fill VRAM
 	bool gp0_InterruptRequest();							//GP0(1Fh), Interrupt Request
-	bool gp0_Polygons();									//GP0(20h - 3Fh), Draw Polygons
-	bool gp0_Lines();										//GP0(40h - 5Fh), Draw Lines
-	bool gp0_Rectangles();									//GP0(60h - 7Fh), Draw Rectangles
+	template<uint8_t opcode> bool gp0_Polygons();			//GP0(20h - 3Fh), Draw Polygons, specialized on the opcode bits
+	template<uint8_t opcode> bool gp0_Lines();				//GP0(40h - 5Fh), Draw Lines, specialized on the opcode bits
+	template<uint8_t opcode> bool gp0_Rectangles();			//GP0(60h - 7Fh), Draw Rectangles, specialized on the opcode bits
 	bool gp0_CopyVRam2VRam();								//GP0(80h - 9Fh), Copy VRAM to VRAM
 	bool gp0_CopyRam2VRam();								//GP0(A0h - BFh), Copy RAM to VRAM
 	bool gp0_CopyVRam2Ram();								//GP0(C0h - DFh), Copy VRAM to RAM
@@ -0,0 +1,747 @@
+#include <loguru.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include "rasterizer.h"
+#include "renderer.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define RASTERIZER_SSE2
+#endif
+
+//PSX Dithering Matrix (4x4), same table used by fragmentRenderShader.glsl
+static constexpr int32_t ditherTable[4][4] =
+{
+	{ -4,  0, -3,  1 },
+	{  2, -2,  3, -1 },
+	{ -3,  1, -4,  0 },
+	{  3, -1,  2, -2 }
+};
+
+//Integer Division rounded towards minus and plus infinity
+static int32_t floorDiv(int32_t a, int32_t b) { return a / b - (((a % b) != 0 && ((a < 0) != (b < 0))) ? 1 : 0); }
+static int32_t ceilDiv(int32_t a, int32_t b) { return -floorDiv(-a, b); }
+
+//-----------------------------------------------------------------------------------------------------
+//
+// Span Kernel Lanes, 16 bits per pixel: 16 pixels per step with AVX2, 8 with SSE2 or plain C++
+//
+//-----------------------------------------------------------------------------------------------------
+#if defined(__AVX2__)
+static constexpr int32_t SPAN_LANES = 16;
+using Lanes = __m256i;
+
+static inline Lanes lanesSet(int32_t value) { return _mm256_set1_epi16(static_cast<int16_t>(value)); }
+static inline Lanes lanesLoad(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+static inline void lanesStore(void* p, Lanes a) { _mm256_storeu_si256(static_cast<__m256i*>(p), a); }
+static inline Lanes lanesAdd(Lanes a, Lanes b) { return _mm256_add_epi16(a, b); }
+static inline Lanes lanesSub(Lanes a, Lanes b) { return _mm256_sub_epi16(a, b); }
+static inline Lanes lanesMul(Lanes a, Lanes b) { return _mm256_mullo_epi16(a, b); }
+static inline Lanes lanesMin(Lanes a, Lanes b) { return _mm256_min_epi16(a, b); }
+static inline Lanes lanesMax(Lanes a, Lanes b) { return _mm256_max_epi16(a, b); }
+static inline Lanes lanesAnd(Lanes a, Lanes b) { return _mm256_and_si256(a, b); }
+static inline Lanes lanesOr(Lanes a, Lanes b) { return _mm256_or_si256(a, b); }
+static inline Lanes lanesAndNot(Lanes a, Lanes b) { return _mm256_andnot_si256(a, b); }		//~a & b
+static inline Lanes lanesEqual(Lanes a, Lanes b) { return _mm256_cmpeq_epi16(a, b); }
+static inline Lanes lanesGreater(Lanes a, Lanes b) { return _mm256_cmpgt_epi16(a, b); }
+template <int N> static inline Lanes lanesShl(Lanes a) { return _mm256_slli_epi16(a, N); }
+template <int N> static inline Lanes lanesShr(Lanes a) { return _mm256_srli_epi16(a, N); }
+template <int N> static inline Lanes lanesSar(Lanes a) { return _mm256_srai_epi16(a, N); }
+
+//Attribute in 16.16 fixed point for 16 pixels, lanes 0..7 and 8..15 in two 32 bits registers
+struct LaneAttribute
+{
+	__m256i lo, hi, stride;
+
+	LaneAttribute(int32_t start, int32_t step)
+	{
+		alignas(32) int32_t values[SPAN_LANES];
+		for (int32_t i = 0; i < SPAN_LANES; i++)
+			values[i] = static_cast<int32_t>(static_cast<uint32_t>(start) + static_cast<uint32_t>(i) * static_cast<uint32_t>(step));
+		lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(values));
+		hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + 8));
+		stride = _mm256_set1_epi32(static_cast<int32_t>(static_cast<uint32_t>(step) * SPAN_LANES));
+	}
+
+	//Integer part, saturated to 16 bits. Packing works within 128 bits halves, the permute puts the pixels back in order
+	Lanes value() const { return _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_srai_epi32(lo, 16), _mm256_srai_epi32(hi, 16)), 0xd8); }
+	void next() { lo = _mm256_add_epi32(lo, stride); hi = _mm256_add_epi32(hi, stride); }
+};
+#elif defined(RASTERIZER_SSE2)
+static constexpr int32_t SPAN_LANES = 8;
+using Lanes = __m128i;
+
+static inline Lanes lanesSet(int32_t value) { return _mm_set1_epi16(static_cast<int16_t>(value)); }
+static inline Lanes lanesLoad(const void* p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+static inline void lanesStore(void* p, Lanes a) { _mm_storeu_si128(static_cast<__m128i*>(p), a); }
+static inline Lanes lanesAdd(Lanes a, Lanes b) { return _mm_add_epi16(a, b); }
+static inline Lanes lanesSub(Lanes a, Lanes b) { return _mm_sub_epi16(a, b); }
+static inline Lanes lanesMul(Lanes a, Lanes b) { return _mm_mullo_epi16(a, b); }
+static inline Lanes lanesMin(Lanes a, Lanes b) { return _mm_min_epi16(a, b); }
+static inline Lanes lanesMax(Lanes a, Lanes b) { return _mm_max_epi16(a, b); }
+static inline Lanes lanesAnd(Lanes a, Lanes b) { return _mm_and_si128(a, b); }
+static inline Lanes lanesOr(Lanes a, Lanes b) { return _mm_or_si128(a, b); }
+static inline Lanes lanesAndNot(Lanes a, Lanes b) { return _mm_andnot_si128(a, b); }			//~a & b
+static inline Lanes lanesEqual(Lanes a, Lanes b) { return _mm_cmpeq_epi16(a, b); }
+static inline Lanes lanesGreater(Lanes a, Lanes b) { return _mm_cmpgt_epi16(a, b); }
+template <int N> static inline Lanes lanesShl(Lanes a) { return _mm_slli_epi16(a, N); }
+template <int N> static inline Lanes lanesShr(Lanes a) { return _mm_srli_epi16(a, N); }
+template <int N> static inline Lanes lanesSar(Lanes a) { return _mm_srai_epi16(a, N); }
+
+//Attribute in 16.16 fixed point for 8 pixels, lanes 0..3 and 4..7 in two 32 bits registers
+struct LaneAttribute
+{
+	__m128i lo, hi, stride;
+
+	LaneAttribute(int32_t start, int32_t step)
+	{
+		alignas(16) int32_t values[SPAN_LANES];
+		for (int32_t i = 0; i < SPAN_LANES; i++)
+			values[i] = static_cast<int32_t>(static_cast<uint32_t>(start) + static_cast<uint32_t>(i) * static_cast<uint32_t>(step));
+		lo = _mm_load_si128(reinterpret_cast<const __m128i*>(values));
+		hi = _mm_load_si128(reinterpret_cast<const __m128i*>(values + 4));
+		stride = _mm_set1_epi32(static_cast<int32_t>(static_cast<uint32_t>(step) * SPAN_LANES));
+	}
+
+	//Integer part, saturated to 16 bits
+	Lanes value() const { return _mm_packs_epi32(_mm_srai_epi32(lo, 16), _mm_srai_epi32(hi, 16)); }
+	void next() { lo = _mm_add_epi32(lo, stride); hi = _mm_add_epi32(hi, stride); }
+};
+#else
+static constexpr int32_t SPAN_LANES = 8;
+struct Lanes { int16_t v[SPAN_LANES]; };
+
+template <typename Op>
+static inline Lanes lanesMap(Lanes a, Lanes b, Op op)
+{
+	Lanes result;
+	for (int32_t i = 0; i < SPAN_LANES; i++)
+		result.v[i] = static_cast<int16_t>(op(a.v[i], b.v[i]));
+	return result;
+}
+
+static inline Lanes lanesSet(int32_t value) { Lanes a; std::fill(a.v, a.v + SPAN_LANES, static_cast<int16_t>(value)); return a; }
+static inline Lanes lanesLoad(const void* p) { Lanes a; std::memcpy(a.v, p, sizeof(a.v)); return a; }
+static inline void lanesStore(void* p, Lanes a) { std::memcpy(p, a.v, sizeof(a.v)); }
+static inline Lanes lanesAdd(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return x + y; }); }
+static inline Lanes lanesSub(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return x - y; }); }
+static inline Lanes lanesMul(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return x * y; }); }
+static inline Lanes lanesMin(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return std::min(x, y); }); }
+static inline Lanes lanesMax(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return std::max(x, y); }); }
+static inline Lanes lanesAnd(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return x & y; }); }
+static inline Lanes lanesOr(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return x | y; }); }
+static inline Lanes lanesAndNot(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return ~x & y; }); }		//~a & b
+static inline Lanes lanesEqual(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return (x == y) ? -1 : 0; }); }
+static inline Lanes lanesGreater(Lanes a, Lanes b) { return lanesMap(a, b, [](int32_t x, int32_t y) { return (x > y) ? -1 : 0; }); }
+template <int N> static inline Lanes lanesShl(Lanes a) { return lanesMap(a, a, [](int32_t x, int32_t) { return x << N; }); }
+template <int N> static inline Lanes lanesShr(Lanes a) { return lanesMap(a, a, [](int32_t x, int32_t) { return static_cast<uint16_t>(x) >> N; }); }
+template <int N> static inline Lanes lanesSar(Lanes a) { return lanesMap(a, a, [](int32_t x, int32_t) { return x >> N; }); }
+
+//Attribute in 16.16 fixed point for 8 pixels
+struct LaneAttribute
+{
+	int32_t values[SPAN_LANES];
+	uint32_t stride;
+
+	LaneAttribute(int32_t start, int32_t step)
+	{
+		for (int32_t i = 0; i < SPAN_LANES; i++)
+			values[i] = static_cast<int32_t>(static_cast<uint32_t>(start) + static_cast<uint32_t>(i) * static_cast<uint32_t>(step));
+		stride = static_cast<uint32_t>(step) * SPAN_LANES;
+	}
+
+	//Integer part, saturated to 16 bits
+	Lanes value() const
+	{
+		Lanes a;
+		for (int32_t i = 0; i < SPAN_LANES; i++)
+			a.v[i] = static_cast<int16_t>(std::clamp(values[i] >> 16, -32768, 32767));
+		return a;
+	}
+	void next()
+	{
+		for (int32_t i = 0; i < SPAN_LANES; i++)
+			values[i] = static_cast<int32_t>(static_cast<uint32_t>(values[i]) + stride);
+	}
+};
+#endif
+
+static inline Lanes lanesSelect(Lanes mask, Lanes a, Lanes b) { return lanesOr(lanesAnd(mask, a), lanesAndNot(mask, b)); }
+static inline Lanes lanesClamp(Lanes a, int32_t low, int32_t high) { return lanesMin(lanesMax(a, lanesSet(low)), lanesSet(high)); }
+
+//Dithering Matrix rows repeated along a span, the pixels starting at x use ditherLanes[y & 3][(x & 3) + i]
+struct DitherLanes
+{
+	int16_t value[4][SPAN_LANES + 4];
+
+	constexpr DitherLanes() : value()
+	{
+		for (int32_t y = 0; y < 4; y++)
+		{
+			for (int32_t i = 0; i < SPAN_LANES + 4; i++)
+				value[y][i] = static_cast<int16_t>(ditherTable[y][i & 3]);
+		}
+	}
+};
+static constexpr DitherLanes ditherLanes;
+
+//Lane Index, selects the pixels of a partial step
+struct LaneIndex
+{
+	int16_t value[SPAN_LANES];
+
+	constexpr LaneIndex() : value()
+	{
+		for (int32_t i = 0; i < SPAN_LANES; i++)
+			value[i] = static_cast<int16_t>(i);
+	}
+};
+static constexpr LaneIndex laneIndex;
+
+Rasterizer::Rasterizer(uint16_t* vramBuffer)
+{
+	vram = vramBuffer;
+	pipeline = {};
+	sliceIndex = 0;
+	sliceCount = 1;
+}
+
+Rasterizer::~Rasterizer()
+{
+}
+
+void Rasterizer::setLineSlice(uint32_t index, uint32_t count)
+{
+	sliceCount = std::max(count, 1u);
+	sliceIndex = index % sliceCount;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//
+// Primitive Drawing
+//
+//-----------------------------------------------------------------------------------------------------
+void Rasterizer::drawTriangle(const GpuVertex& v0, const GpuVertex& v1, const GpuVertex& v2, const RendererState& state)
+{
+	struct Vertex { int32_t x, y, r, g, b, u, v; };
+
+	setupPipeline(state, state.textured && !state.texDisable, state.dither);
+
+	Vertex p[3];
+	const GpuVertex* src[3] = { &v0, &v1, &v2 };
+	for (int i = 0; i < 3; i++)
+	{
+		p[i].x = signExtend(src[i]->x) + pipeline.offsetX;
+		p[i].y = signExtend(src[i]->y) + pipeline.offsetY;
+		p[i].r = src[i]->r;
+		p[i].g = src[i]->g;
+		p[i].b = src[i]->b;
+		p[i].u = src[i]->u;
+		p[i].v = src[i]->v;
+	}
+
+	int32_t minX = std::min({ p[0].x, p[1].x, p[2].x });
+	int32_t maxX = std::max({ p[0].x, p[1].x, p[2].x });
+	int32_t minY = std::min({ p[0].y, p[1].y, p[2].y });
+	int32_t maxY = std::max({ p[0].y, p[1].y, p[2].y });
+
+	//Polygons larger than 1023x511 are skipped by the hardware
+	if ((maxX - minX) > 1023 || (maxY - minY) > 511)
+		return;
+
+	//Keep a positive winding, degenerate triangles draw nothing
+	int32_t area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x);
+	if (area == 0)
+		return;
+	if (area < 0)
+	{
+		std::swap(p[1], p[2]);
+		area = -area;
+	}
+
+	//Clip Bounding Box to Drawing Area
+	minX = std::max(minX, pipeline.drawX1);
+	maxX = std::min(maxX, pipeline.drawX2);
+	minY = std::max(minY, pipeline.drawY1);
+	maxY = std::min(maxY, pipeline.drawY2);
+	if (minX > maxX || minY > maxY)
+		return;
+
+	//First line owned by this Rasterizer, the Drawing Area keeps y inside VRAM
+	int32_t startY = firstLine(minY);
+	if (startY > maxY)
+		return;
+
+	//Edge Functions, right and bottom edges are not drawn (top-left rule)
+	struct Edge { int32_t stepX, stepY, bias; int32_t row; };
+	auto setupEdge = [&](const Vertex& a, const Vertex& b)
+	{
+		Edge e;
+		e.stepX = a.y - b.y;
+		e.stepY = b.x - a.x;
+		bool topLeft = (b.y < a.y) || (b.y == a.y && b.x > a.x);
+		e.bias = topLeft ? 0 : -1;
+		e.row = e.stepY * (minY - a.y) + e.stepX * (minX - a.x);
+		return e;
+	};
+	Edge edge[3] = { setupEdge(p[1], p[2]), setupEdge(p[2], p[0]), setupEdge(p[0], p[1]) };
+
+	//Attribute Gradients in 16.16 fixed point
+	struct Attribute { int64_t stepX, stepY, row; };
+	auto setupAttribute = [&](int32_t a0, int32_t a1, int32_t a2)
+	{
+		Attribute a;
+		int64_t dx = static_cast<int64_t>(a1 - a0) * (p[2].y - p[0].y) - static_cast<int64_t>(a2 - a0) * (p[1].y - p[0].y);
+		int64_t dy = static_cast<int64_t>(a2 - a0) * (p[1].x - p[0].x) - static_cast<int64_t>(a1 - a0) * (p[2].x - p[0].x);
+		a.stepX = (dx * 65536) / area;
+		a.stepY = (dy * 65536) / area;
+		a.row = (static_cast<int64_t>(a0) << 16) + 0x8000 + a.stepX * (minX - p[0].x) + a.stepY * (minY - p[0].y);
+		return a;
+	};
+	Attribute attr[5] =
+	{
+		setupAttribute(p[0].r, p[1].r, p[2].r),
+		setupAttribute(p[0].g, p[1].g, p[2].g),
+		setupAttribute(p[0].b, p[1].b, p[2].b),
+		setupAttribute(p[0].u, p[1].u, p[2].u),
+		setupAttribute(p[0].v, p[1].v, p[2].v)
+	};
+
+	//Skip the lines owned by the other Rasterizers, edge and attribute steps are exact so the values match a serial walk
+	for (int i = 0; i < 3; i++)
+		edge[i].row += edge[i].stepY * (startY - minY);
+	for (int i = 0; i < 5; i++)
+		attr[i].row += attr[i].stepY * (startY - minY);
+
+	int32_t lineStep = static_cast<int32_t>(sliceCount);
+	SpanAttributes span;
+	span.wrapUV = false;
+	for (int i = 0; i < 5; i++)
+		span.step[i] = static_cast<int32_t>(attr[i].stepX);
+
+	for (int32_t y = startY; y <= maxY; y += lineStep)
+	{
+		//Covered Pixels, solve edge.row + edge.stepX * k + edge.bias >= 0 for the three edges
+		int32_t first = 0;
+		int32_t last = maxX - minX;
+		for (int i = 0; i < 3; i++)
+		{
+			int32_t need = -edge[i].bias - edge[i].row;
+			if (edge[i].stepX > 0)
+				first = std::max(first, ceilDiv(need, edge[i].stepX));
+			else if (edge[i].stepX < 0)
+				last = std::min(last, floorDiv(need, edge[i].stepX));
+			else if (need > 0)
+				last = -1;
+		}
+
+		//Attributes of covered pixels stay in 0..255, 32 bits wrap around arithmetic gives back the exact values
+		if (first <= last)
+		{
+			for (int i = 0; i < 5; i++)
+				span.start[i] = static_cast<int32_t>(attr[i].row + attr[i].stepX * first);
+			(this->*pipeline.spanKernel)(minX + first, y, last - first + 1, span);
+		}
+
+		for (int i = 0; i < 3; i++)
+			edge[i].row += edge[i].stepY * lineStep;
+		for (int i = 0; i < 5; i++)
+			attr[i].row += attr[i].stepY * lineStep;
+	}
+}
+
+void Rasterizer::drawRectangle(const GpuVertex& origin, int32_t width, int32_t height, const RendererState& state)
+{
+	//Rectangles are never dithered
+	setupPipeline(state, state.textured && !state.texDisable, false);
+
+	int32_t x0 = signExtend(origin.x) + pipeline.offsetX;
+	int32_t y0 = signExtend(origin.y) + pipeline.offsetY;
+
+	//Clip to Drawing Area
+	int32_t iStart = std::max(0, pipeline.drawX1 - x0);
+	int32_t iEnd = std::min(width, pipeline.drawX2 - x0 + 1);
+	int32_t jStart = std::max(0, pipeline.drawY1 - y0);
+	int32_t jEnd = std::min(height, pipeline.drawY2 - y0 + 1);
+	if (iStart >= iEnd || jStart >= jEnd)
+		return;
+
+	//Flat Color, U steps by one texel per pixel and V by one per line, both wrapping at 256
+	SpanAttributes span;
+	span.start[0] = origin.r << 16;
+	span.start[1] = origin.g << 16;
+	span.start[2] = origin.b << 16;
+	span.start[3] = (origin.u + iStart) << 16;
+	span.step[0] = 0;
+	span.step[1] = 0;
+	span.step[2] = 0;
+	span.step[3] = 1 << 16;
+	span.step[4] = 0;
+	span.wrapUV = true;
+
+	for (int32_t j = firstLine(y0 + jStart) - y0; j < jEnd; j += static_cast<int32_t>(sliceCount))
+	{
+		span.start[4] = ((origin.v + j) & 0xff) << 16;
+		(this->*pipeline.spanKernel)(x0 + iStart, y0 + j, iEnd - iStart, span);
+	}
+}
+
+void Rasterizer::drawLine(const GpuVertex& v0, const GpuVertex& v1, const RendererState& state)
+{
+	//Lines are never textured
+	setupPipeline(state, false, state.dither);
+
+	int32_t x0 = signExtend(v0.x) + pipeline.offsetX;
+	int32_t y0 = signExtend(v0.y) + pipeline.offsetY;
+	int32_t dx = (signExtend(v1.x) + pipeline.offsetX) - x0;
+	int32_t dy = (signExtend(v1.y) + pipeline.offsetY) - y0;
+
+	//Lines longer than 1023x511 are skipped by the hardware
+	if (std::abs(dx) > 1023 || std::abs(dy) > 511)
+		return;
+
+	//Both end points are drawn, position and color are stepped in 16.16 fixed point
+	int32_t steps = std::max(std::abs(dx), std::abs(dy));
+	int64_t divider = std::max(steps, 1);
+
+	int64_t x = (static_cast<int64_t>(x0) << 16) + 0x8000;
+	int64_t y = (static_cast<int64_t>(y0) << 16) + 0x8000;
+	int64_t r = (static_cast<int64_t>(v0.r) << 16) + 0x8000;
+	int64_t g = (static_cast<int64_t>(v0.g) << 16) + 0x8000;
+	int64_t b = (static_cast<int64_t>(v0.b) << 16) + 0x8000;
+
+	int64_t stepX = (static_cast<int64_t>(dx) << 16) / divider;
+	int64_t stepY = (static_cast<int64_t>(dy) << 16) / divider;
+	int64_t stepR = (static_cast<int64_t>(v1.r - v0.r) << 16) / divider;
+	int64_t stepG = (static_cast<int64_t>(v1.g - v0.g) << 16) / divider;
+	int64_t stepB = (static_cast<int64_t>(v1.b - v0.b) << 16) / divider;
+
+	for (int32_t i = 0; i <= steps; i++)
+	{
+		int32_t lineY = static_cast<int32_t>(y >> 16);
+		if (static_cast<uint32_t>(lineY & 0x1ff) % sliceCount == sliceIndex)
+			plotPixel(static_cast<int32_t>(x >> 16), lineY, static_cast<int32_t>(r >> 16), static_cast<int32_t>(g >> 16), static_cast<int32_t>(b >> 16));
+
+		x += stepX;
+		y += stepY;
+		r += stepR;
+		g += stepG;
+		b += stepB;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------
+//
+// Pixel Pipeline
+//
+//-----------------------------------------------------------------------------------------------------
+//Kernel Table, index is ((Texture * 2 + Blend) * 5 + (SemiMode + 1)) * 2 + Dither
+template <size_t... Index>
+constexpr auto Rasterizer::makeSpanKernels(std::index_sequence<Index...>)
+{
+	return std::array<SpanKernel, sizeof...(Index)>
+	{
+		&Rasterizer::drawSpan<static_cast<int>(Index / 20), ((Index / 10) % 2) == 1, static_cast<int>((Index / 2) % 5) - 1, (Index % 2) == 1>...
+	};
+}
+
+void Rasterizer::setupPipeline(const RendererState& state, bool textured, bool dither)
+{
+	pipeline.drawX1 = state.drawingArea.x;
+	pipeline.drawY1 = state.drawingArea.y;
+	pipeline.drawX2 = state.drawingArea.z;
+	pipeline.drawY2 = state.drawingArea.w;
+	pipeline.offsetX = signExtend(static_cast<uint16_t>(state.drawingOffset.x));
+	pipeline.offsetY = signExtend(static_cast<uint16_t>(state.drawingOffset.y));
+
+	pipeline.textured = textured;
+	pipeline.texBlending = state.texBlending;
+	pipeline.texPageX = state.texPageCoords.x;
+	pipeline.texPageY = state.texPageCoords.y;
+	pipeline.clutX = state.clutTableCoords.x;
+	pipeline.clutY = state.clutTableCoords.y;
+	pipeline.texColorMode = state.texColorMode;
+
+	//UV = (UV AND NOT (Mask * 8)) OR ((Offset AND Mask) * 8)
+	pipeline.texWindowMaskX = (state.texMask.x & 0x1f) * 8;
+	pipeline.texWindowMaskY = (state.texMask.y & 0x1f) * 8;
+	pipeline.texWindowOffsetX = (state.texOffset.x & state.texMask.x & 0x1f) * 8;
+	pipeline.texWindowOffsetY = (state.texOffset.y & state.texMask.y & 0x1f) * 8;
+
+	pipeline.semiTransparent = state.semiTranparent;
+	pipeline.semiTransparentMode = state.semiTransparentMode & 0x3;
+	pipeline.checkMask = state.checkMask;
+	pipeline.forceMask = state.forceMask ? 0x8000 : 0x0000;
+	pipeline.dither = dither;
+
+	//Span Kernel, lines use plotPixel
+	static constexpr auto spanKernels = makeSpanKernels(std::make_index_sequence<80>());
+	int32_t texture = textured ? ((pipeline.texColorMode < 2) ? static_cast<int32_t>(pipeline.texColorMode) + 1 : 3) : 0;
+	int32_t blend = (textured && pipeline.texBlending) ? 1 : 0;
+	int32_t semiMode = pipeline.semiTransparent ? static_cast<int32_t>(pipeline.semiTransparentMode) : -1;
+	pipeline.spanKernel = spanKernels[((texture * 2 + blend) * 5 + (semiMode + 1)) * 2 + (dither ? 1 : 0)];
+}
+
+template <int Texture>
+uint16_t Rasterizer::fetchTexel(uint32_t u, uint32_t v) const
+{
+	uint32_t y = ((pipeline.texPageY + v) & 0x1ff) * 1024;
+
+	if constexpr (Texture == 1)		//CLUT 4bit
+	{
+		uint16_t data = vram[y + ((pipeline.texPageX + u / 4) & 0x3ff)];
+		uint32_t index = (data >> ((u & 3) * 4)) & 0x0f;
+		return vram[(pipeline.clutY & 0x1ff) * 1024 + ((pipeline.clutX + index) & 0x3ff)];
+	}
+	else if constexpr (Texture == 2)	//CLUT 8bit
+	{
+		uint16_t data = vram[y + ((pipeline.texPageX + u / 2) & 0x3ff)];
+		uint32_t index = (data >> ((u & 1) * 8)) & 0xff;
+		return vram[(pipeline.clutY & 0x1ff) * 1024 + ((pipeline.clutX + index) & 0x3ff)];
+	}
+	else							//Raw 1-5-5-5 format
+	{
+		return vram[y + ((pipeline.texPageX + u) & 0x3ff)];
+	}
+}
+
+void Rasterizer::plotPixel(int32_t x, int32_t y, int32_t r, int32_t g, int32_t b)
+{
+	//Drawing Area Clipping
+	if (x < pipeline.drawX1 || x > pipeline.drawX2 || y < pipeline.drawY1 || y > pipeline.drawY2)
+		return;
+
+	uint16_t& pixel = vram[(y & 0x1ff) * 1024 + (x & 0x3ff)];
+
+	//Mask Bit Check
+	if (pipeline.checkMask && (pixel & 0x8000))
+		return;
+
+	if (pipeline.semiTransparent)
+	{
+		int32_t br = (pixel & 0x001f) << 3;
+		int32_t bg = (pixel & 0x03e0) >> 2;
+		int32_t bb = (pixel & 0x7c00) >> 7;
+
+		switch (pipeline.semiTransparentMode)
+		{
+		case 0:		//B/2 + F/2
+			r = (br + r) >> 1;
+			g = (bg + g) >> 1;
+			b = (bb + b) >> 1;
+			break;
+
+		case 1:		//B + F
+			r = std::min(br + r, 255);
+			g = std::min(bg + g, 255);
+			b = std::min(bb + b, 255);
+			break;
+
+		case 2:		//B - F
+			r = std::max(br - r, 0);
+			g = std::max(bg - g, 0);
+			b = std::max(bb - b, 0);
+			break;
+
+		case 3:		//B + F/4
+			r = std::min(br + (r >> 2), 255);
+			g = std::min(bg + (g >> 2), 255);
+			b = std::min(bb + (b >> 2), 255);
+			break;
+		}
+	}
+
+	if (pipeline.dither)
+	{
+		int32_t d = ditherTable[y & 3][x & 3];
+		r = std::clamp(r + d, 0, 255);
+		g = std::clamp(g + d, 0, 255);
+		b = std::clamp(b + d, 0, 255);
+	}
+
+	pixel = static_cast<uint16_t>((r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10) | pipeline.forceMask);
+}
+
+template <int Texture>
+bool Rasterizer::samplesSpan(int32_t x, int32_t y, int32_t count) const
+{
+	//Rectangles on the 1024x512 VRAM ring, spans never wrap horizontally
+	uint32_t line = static_cast<uint32_t>(y) & 0x1ff;
+	auto overlaps = [&](uint32_t left, uint32_t top, uint32_t width, uint32_t height)
+	{
+		if (((line - top) & 0x1ff) >= height)
+			return false;
+		return ((static_cast<uint32_t>(x) - left) & 0x3ff) < width || ((left - static_cast<uint32_t>(x)) & 0x3ff) < static_cast<uint32_t>(count);
+	};
+
+	//Texture Page spans 256 texels, 4 and 8 bit texels are packed in 16 bit VRAM pixels
+	if (overlaps(pipeline.texPageX, pipeline.texPageY, (Texture == 1) ? 64 : (Texture == 2) ? 128 : 256, 256))
+		return true;
+
+	if constexpr (Texture != 3)
+		return overlaps(pipeline.clutX, pipeline.clutY, (Texture == 1) ? 16 : 256, 1);
+
+	return false;
+}
+
+template <int Texture, bool Blend, int SemiMode, bool Dither>
+void Rasterizer::drawSpan(int32_t x, int32_t y, int32_t count, const SpanAttributes& span)
+{
+	//Texels read after the pixels before them on the same span are drawn, keep that order one pixel at a time
+	if constexpr (Texture != 0)
+	{
+		if (count > 1 && samplesSpan<Texture>(x, y, count))
+		{
+			SpanAttributes pixel = span;
+			for (int32_t i = 0; i < count; i++)
+			{
+				drawSpan<Texture, Blend, SemiMode, Dither>(x + i, y, 1, pixel);
+				for (int a = 0; a < 5; a++)
+					pixel.start[a] = static_cast<int32_t>(static_cast<uint32_t>(pixel.start[a]) + static_cast<uint32_t>(pixel.step[a]));
+			}
+			return;
+		}
+	}
+
+	uint16_t* line = vram + (y & 0x1ff) * 1024;
+	const int16_t* ditherRow = ditherLanes.value[y & 3];
+
+	LaneAttribute r(span.start[0], span.step[0]);
+	LaneAttribute g(span.start[1], span.step[1]);
+	LaneAttribute b(span.start[2], span.step[2]);
+	LaneAttribute u(span.start[3], span.step[3]);
+	LaneAttribute v(span.start[4], span.step[4]);
+
+	const Lanes zero = lanesSet(0);
+	const Lanes byteMask = lanesSet(0xff);
+	const Lanes colorMask = lanesSet(0x1f);
+	const Lanes maskBit = lanesSet(0x8000);
+
+	for (int32_t i = 0; i < count; i += SPAN_LANES, x += SPAN_LANES)
+	{
+		//Spans never cross the Drawing Area, the last step goes through a copy of the pixels left
+		int32_t pixels = std::min(count - i, SPAN_LANES);
+		alignas(32) uint16_t partial[SPAN_LANES] = {};
+		uint16_t* dst = (pixels == SPAN_LANES) ? (line + x) : partial;
+		if (pixels < SPAN_LANES)
+			std::memcpy(partial, line + x, pixels * sizeof(uint16_t));
+
+		Lanes background = lanesLoad(dst);
+		Lanes live = lanesGreater(lanesSet(pixels), lanesLoad(laneIndex.value));
+
+		//Mask Bit Check
+		if (pipeline.checkMask)
+			live = lanesAndNot(lanesSar<15>(background), live);
+
+		Lanes cr = lanesClamp(r.value(), 0, 255);
+		Lanes cg = lanesClamp(g.value(), 0, 255);
+		Lanes cb = lanesClamp(b.value(), 0, 255);
+		Lanes mask = lanesSet(pipeline.forceMask);
+		Lanes semiTransparent = lanesSet(-1);
+
+		if constexpr (Texture != 0)
+		{
+			Lanes tu = span.wrapUV ? lanesAnd(u.value(), byteMask) : lanesClamp(u.value(), 0, 255);
+			Lanes tv = span.wrapUV ? lanesAnd(v.value(), byteMask) : lanesClamp(v.value(), 0, 255);
+			tu = lanesOr(lanesAndNot(lanesSet(pipeline.texWindowMaskX), tu), lanesSet(pipeline.texWindowOffsetX));
+			tv = lanesOr(lanesAndNot(lanesSet(pipeline.texWindowMaskY), tv), lanesSet(pipeline.texWindowOffsetY));
+
+			//Texel Fetch and CLUT Lookup are gathers, done one lane at a time
+			alignas(32) uint16_t lu[SPAN_LANES], lv[SPAN_LANES], texels[SPAN_LANES];
+			lanesStore(lu, tu);
+			lanesStore(lv, tv);
+			for (int32_t k = 0; k < SPAN_LANES; k++)
+				texels[k] = fetchTexel<Texture>(lu[k] & 0xff, lv[k] & 0xff);
+			Lanes texel = lanesLoad(texels);
+
+			//Texel 0x0000 is fully transparent
+			live = lanesAndNot(lanesEqual(texel, zero), live);
+
+			Lanes tr = lanesAnd(texel, colorMask);
+			Lanes tg = lanesAnd(lanesShr<5>(texel), colorMask);
+			Lanes tb = lanesAnd(lanesShr<10>(texel), colorMask);
+
+			if constexpr (Blend)
+			{
+				//Vertex Color 0x80 leaves the texel unchanged
+				cr = lanesMin(lanesSar<4>(lanesMul(tr, cr)), byteMask);
+				cg = lanesMin(lanesSar<4>(lanesMul(tg, cg)), byteMask);
+				cb = lanesMin(lanesSar<4>(lanesMul(tb, cb)), byteMask);
+			}
+			else
+			{
+				cr = lanesShl<3>(tr);
+				cg = lanesShl<3>(tg);
+				cb = lanesShl<3>(tb);
+			}
+
+			//Texel bit 15 selects semi transparency and is copied to the mask bit
+			semiTransparent = lanesSar<15>(texel);
+			mask = lanesOr(mask, lanesAnd(texel, maskBit));
+		}
+
+		if constexpr (SemiMode >= 0)
+		{
+			Lanes br = lanesShl<3>(lanesAnd(background, colorMask));
+			Lanes bg = lanesShl<3>(lanesAnd(lanesShr<5>(background), colorMask));
+			Lanes bb = lanesShl<3>(lanesAnd(lanesShr<10>(background), colorMask));
+			Lanes sr, sg, sb;
+
+			if constexpr (SemiMode == 0)		//B/2 + F/2
+			{
+				sr = lanesSar<1>(lanesAdd(br, cr));
+				sg = lanesSar<1>(lanesAdd(bg, cg));
+				sb = lanesSar<1>(lanesAdd(bb, cb));
+			}
+			else if constexpr (SemiMode == 1)	//B + F
+			{
+				sr = lanesMin(lanesAdd(br, cr), byteMask);
+				sg = lanesMin(lanesAdd(bg, cg), byteMask);
+				sb = lanesMin(lanesAdd(bb, cb), byteMask);
+			}
+			else if constexpr (SemiMode == 2)	//B - F
+			{
+				sr = lanesMax(lanesSub(br, cr), zero);
+				sg = lanesMax(lanesSub(bg, cg), zero);
+				sb = lanesMax(lanesSub(bb, cb), zero);
+			}
+			else								//B + F/4
+			{
+				sr = lanesMin(lanesAdd(br, lanesSar<2>(cr)), byteMask);
+				sg = lanesMin(lanesAdd(bg, lanesSar<2>(cg)), byteMask);
+				sb = lanesMin(lanesAdd(bb, lanesSar<2>(cb)), byteMask);
+			}
+
+			cr = lanesSelect(semiTransparent, sr, cr);
+			cg = lanesSelect(semiTransparent, sg, cg);
+			cb = lanesSelect(semiTransparent, sb, cb);
+		}
+
+		if constexpr (Dither)
+		{
+			//Steps are a multiple of 4 pixels, the matrix column only depends on the span start
+			Lanes d = lanesLoad(ditherRow + (x & 3));
+			cr = lanesClamp(lanesAdd(cr, d), 0, 255);
+			cg = lanesClamp(lanesAdd(cg, d), 0, 255);
+			cb = lanesClamp(lanesAdd(cb, d), 0, 255);
+		}
+
+		Lanes pixel = lanesOr(lanesOr(lanesShr<3>(cr), lanesShl<5>(lanesShr<3>(cg))), lanesOr(lanesShl<10>(lanesShr<3>(cb)), mask));
+		lanesStore(dst, lanesSelect(live, pixel, background));
+		if (pixels < SPAN_LANES)
+			std::memcpy(line + x, partial, pixels * sizeof(uint16_t));
+
+		r.next();
+		g.next();
+		b.next();
+		if constexpr (Texture != 0)
+		{
+			u.next();
+			v.next();
+		}
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+#include "gpu_utils.h"
+
+struct RendererState;
+
+//Software Rasterizer, draws PSX primitives straight into a host memory 1024x512 VRAM.
+//Pixel pipeline follows fragmentRenderShader.glsl: texture fetch (4/8/15 bit), CLUT lookup,
+//texture window, texture blending, semi transparency, dithering and mask bit.
+//Polygons and Rectangles are drawn as horizontal spans by SIMD kernels specialized on texture depth,
+//texture blending, semi transparency mode and dithering. Lines are drawn one pixel at a time.
+class Rasterizer
+{
+public:
+	Rasterizer(uint16_t* vramBuffer);
+	~Rasterizer();
+
+	//Line Interleaving for parallel drawing, only VRAM lines with y % count == index are drawn
+	void setLineSlice(uint32_t index, uint32_t count);
+
+	//Primitive Drawing, vertex coordinates are relative to the Drawing Offset
+	void drawTriangle(const GpuVertex& v0, const GpuVertex& v1, const GpuVertex& v2, const RendererState& state);
+	void drawRectangle(const GpuVertex& origin, int32_t width, int32_t height, const RendererState& state);
+	void drawLine(const GpuVertex& v0, const GpuVertex& v1, const RendererState& state);
+
+	//Unit Tests compare the Span Kernels with plotPixel
+	friend class RasterizerTest;
+
+private:
+	//Span Attributes R, G, B, U, V in 16.16 fixed point, the value at pixel i is start + i * step
+	struct SpanAttributes
+	{
+		int32_t		start[5];
+		int32_t		step[5];
+		bool		wrapUV;				//Rectangles wrap U and V at 256, Polygons clamp them to 0..255 like the colors
+	};
+
+	//Span Kernel variants, Texture is 0 (none), 1 (CLUT 4bit), 2 (CLUT 8bit), 3 (15bit), SemiMode is -1 (opaque) or 0..3
+	template <int Texture, bool Blend, int SemiMode, bool Dither>
+	void drawSpan(int32_t x, int32_t y, int32_t count, const SpanAttributes& span);
+
+	using SpanKernel = void (Rasterizer::*)(int32_t x, int32_t y, int32_t count, const SpanAttributes& span);
+	template <size_t... Index>
+	static constexpr auto makeSpanKernels(std::index_sequence<Index...>);
+
+	void setupPipeline(const RendererState& state, bool textured, bool dither);
+	template <int Texture>
+	uint16_t fetchTexel(uint32_t u, uint32_t v) const;
+	template <int Texture>
+	bool samplesSpan(int32_t x, int32_t y, int32_t count) const;
+	int32_t firstLine(int32_t y) const { return y + static_cast<int32_t>((sliceIndex + sliceCount - static_cast<uint32_t>(y) % sliceCount) % sliceCount); }
+	void plotPixel(int32_t x, int32_t y, int32_t r, int32_t g, int32_t b);
+
+	//Vertex coordinates are signed 11 bit values
+	static int32_t signExtend(uint16_t value) { return static_cast<int32_t>(static_cast<int16_t>(value << 5)) >> 5; }
+
+private:
+	//Host VRAM, owned by the Renderer
+	uint16_t*	vram;
+
+	//VRAM lines drawn by this Rasterizer
+	uint32_t	sliceIndex;
+	uint32_t	sliceCount;
+
+	//Pixel Pipeline Configuration for the current Primitive
+	struct PixelPipeline
+	{
+		int32_t		drawX1, drawY1, drawX2, drawY2;		//Drawing Area, inclusive
+		int32_t		offsetX, offsetY;					//Drawing Offset
+		bool		textured;
+		bool		texBlending;
+		uint32_t	texPageX, texPageY;
+		uint32_t	clutX, clutY;
+		uint32_t	texColorMode;
+		uint32_t	texWindowMaskX, texWindowMaskY;		//Texture Window Mask, in pixels
+		uint32_t	texWindowOffsetX, texWindowOffsetY;	//Texture Window Offset, in pixels
+		bool		semiTransparent;
+		uint32_t	semiTransparentMode;
+		bool		checkMask;
+		uint16_t	forceMask;
+		bool		dither;
+		SpanKernel	spanKernel;							//Span Kernel matching the settings above
+	} pipeline;
+};
@@ -1,14 +1,32 @@
 #include <loguru.hpp>
+#include <algorithm>
+#include <bit>
 #include "renderer.h"
 #include "debugger.h"
+#include "profiler.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define RENDERER_SSE2
+#endif
 
 bool Renderer::Init()
 {
     auto& r = instance();  // Alias al singleton
 
+    //A previous Software Backend may still be drawing into the host VRAM, a previous OpenGL one from the Vertex Ring
+    r.StopRasterizer();
+    for (auto& sync : r.vertexFence)
+        r.WaitForFence(sync);
+    r.WaitForFence(r.accessFence);
+
     //Init Internal Status
     r.frameReady = false;
     r.vertexCount = 0;
+    r.vertexFirst = 0;
+    r.vertexSegment = 0;
 
     //Init Video Status
     r.displayState.displayRes = { 256, 240 };
@@ -37,6 +55,26 @@ bool Renderer::Init()
 
     //Init renderingState to match currentState
     r.renderingState = r.currentState;
+    r.renderingGeneration++;
+
+    //Software and Null Backends keep VRAM in a plain host buffer
+    if (r.backend != RendererBackend::OpenGL)
+    {
+        r.vramHostBuffer.assign(1024 * 512, 0);
+        r.vramAccessBuffer = r.vramHostBuffer.data();
+        r.mappedVertex = nullptr;
+
+        if (r.backend == RendererBackend::Software)
+            r.StartRasterizer();
+    }
+
+    //OpenGL is only needed to draw primitives or to present the Software Backend VRAM on a window
+    r.glEnabled = (r.backend == RendererBackend::OpenGL) || (r.backend == RendererBackend::Software && !r.headless);
+    if (!r.glEnabled)
+    {
+        LOG_F(INFO, "RND - %s Backend Initialized (no OpenGL)", (r.backend == RendererBackend::Software) ? "Software" : "Null");
+        return true;
+    }
 
     //Quad for Video Rendering
     float quad[] =
@@ -52,6 +90,8 @@ bool Renderer::Init()
     {
         r.RenderShader = std::make_unique<Shader>("../src/gpu/shaders/vertexRenderShader.glsl", "../src/gpu/shaders/fragmentRenderShader.glsl");
         r.FramebufferShader = std::make_unique<Shader>("../src/gpu/shaders/vertexFramebufferShader.glsl", "../src/gpu/shaders/fragmentFramebufferShader.glsl");
+        if (r.textureCacheEnabled && r.backend == RendererBackend::OpenGL)
+            r.TextureCacheShader = std::make_unique<Shader>("../src/gpu/shaders/vertexFramebufferShader.glsl", "../src/gpu/shaders/fragmentTextureCacheShader.glsl");
     }
     catch (const std::exception& e)
     {
@@ -61,6 +101,11 @@ bool Renderer::Init()
 
     LOG_F(INFO, "RND - Shaders Compiled");
 
+    //Create Uniform Buffer holding the Rendering State, written again only when it changes
+    glCreateBuffers(1, &r.uboRenderState);
+    glNamedBufferStorage(r.uboRenderState, sizeof(RenderUniforms), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    r.uniformGeneration = r.renderingGeneration - 1;
+
     //Create Texture representing PSX VRAM
     glCreateTextures(GL_TEXTURE_2D, 1, &r.vramTexture);
     if (r.vramTexture == 0)
@@ -74,14 +119,18 @@ bool Renderer::Init()
     glTextureParameteri(r.vramTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTextureParameteri(r.vramTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         
-    // Create Persistent Mapped Array which rappresent PSX VRAM
-    glCreateBuffers(1, &r.vramAccessBufferID);
-    glNamedBufferStorage(r.vramAccessBufferID, 1024*512*sizeof(uint16_t), nullptr, GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
-    r.vramAccessBuffer = (uint16_t*)glMapNamedBufferRange(r.vramAccessBufferID, 0, 1024*512*sizeof(uint16_t), GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
-    if (r.vramAccessBuffer == nullptr)
+    // Create Persistent Mapped Array which rappresent PSX VRAM, Software Backend uses the host buffer instead
+    if (r.backend == RendererBackend::OpenGL)
     {
-        LOG_F(ERROR, "RND - glMapNamedBufferRange failed for vramAccessBuffer");
-        return false;
+        glCreateBuffers(1, &r.vramAccessBufferID);
+        glNamedBufferStorage(r.vramAccessBufferID, 1024*512*sizeof(uint16_t), nullptr, GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        r.vramAccessBuffer = (uint16_t*)glMapNamedBufferRange(r.vramAccessBufferID, 0, 1024*512*sizeof(uint16_t), GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+        if (r.vramAccessBuffer == nullptr)
+        {
+            LOG_F(ERROR, "RND - glMapNamedBufferRange failed for vramAccessBuffer");
+            return false;
+        }
+        r.vramDirty.fill(0);
     }
 
     //Create Framebuffer Object for VRAM Texture, Shader renders to this FBO to update VRAM Texture
@@ -95,6 +144,32 @@ bool Renderer::Init()
     }
     glNamedFramebufferDrawBuffer(r.vramFrameBuffer, GL_COLOR_ATTACHMENT0);
 
+    //Create Texture Cache, one 256x256 direct color layer per decoded Texture Page, the layer is attached to its Framebuffer when decoded
+    r.textureCacheLayer = -1;
+    r.uniformCacheLayer = -1;
+    r.textureCacheDirty.reset();
+    for (auto& entry : r.textureCache)
+        entry.valid = false;
+    if (r.textureCacheEnabled && r.backend == RendererBackend::OpenGL)
+    {
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &r.textureCacheArray);
+        glTextureStorage3D(r.textureCacheArray, 1, GL_R16UI, 256, 256, TEXTURE_CACHE_LAYERS);
+        glTextureParameteri(r.textureCacheArray, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(r.textureCacheArray, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glCreateFramebuffers(1, &r.textureCacheFrameBuffer);
+        glNamedFramebufferTextureLayer(r.textureCacheFrameBuffer, GL_COLOR_ATTACHMENT0, r.textureCacheArray, 0, 0);
+        fbStatus = glCheckNamedFramebufferStatus(r.textureCacheFrameBuffer, GL_FRAMEBUFFER);
+        if (fbStatus != GL_FRAMEBUFFER_COMPLETE)
+        {
+            LOG_F(ERROR, "RND - Texture Cache framebuffer incomplete: 0x%X", fbStatus);
+            return false;
+        }
+        glNamedFramebufferDrawBuffer(r.textureCacheFrameBuffer, GL_COLOR_ATTACHMENT0);
+
+        LOG_F(INFO, "RND - Texture Cache Enabled (%d Texture Pages)", TEXTURE_CACHE_LAYERS);
+    }
+
     //Create Vertex Array Object & Vertex Buffer Object for Video Output Quad
     glCreateVertexArrays(1, &r.vaoFrameBuffer);
     glCreateBuffers(1, &r.vboFrameBuffer);
@@ -177,7 +252,8 @@ bool Renderer::Reset()
     r.currentState.dither = false;
 
     //Init renderingState to match currentState
-    r.renderingState = r.currentState;   
+    r.renderingState = r.currentState;
+    r.renderingGeneration++;
 
     return true;
 }
@@ -197,12 +273,11 @@ void Renderer::PushVertex(const RendererVertex& v)
         return;
     }
 
-    r.mappedVertex[r.vertexCount++] = v;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v;
 
-    if (r.vertexCount > MAX_VERTICES - 6)
-    {
-        r.FlushBatch();
-    }
+    //Current Ring Segment is full, draw it and move on to the next one
+    if (r.vertexFirst + r.vertexCount > (r.vertexSegment + 1) * VERTEX_SEGMENT_SIZE - 6)
+        r.NextVertexSegment();
 }
 
 void Renderer::PushTriangle(const RendererVertex& v0, const RendererVertex& v1, const RendererVertex& v2)
@@ -215,14 +290,13 @@ void Renderer::PushTriangle(const RendererVertex& v0, const RendererVertex& v1,
         return;
     }
 
-    r.mappedVertex[r.vertexCount++] = v0;
-    r.mappedVertex[r.vertexCount++] = v1;
-    r.mappedVertex[r.vertexCount++] = v2;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v0;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v1;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v2;
 
-    if (r.vertexCount > MAX_VERTICES - 6)
-    {
-        r.FlushBatch();
-    }
+    //Current Ring Segment is full, draw it and move on to the next one
+    if (r.vertexFirst + r.vertexCount > (r.vertexSegment + 1) * VERTEX_SEGMENT_SIZE - 6)
+        r.NextVertexSegment();
 }
 
 void Renderer::PushQuad(const RendererVertex& v0, const RendererVertex& v1, const RendererVertex& v2, const RendererVertex& v3)
@@ -235,24 +309,44 @@ void Renderer::PushQuad(const RendererVertex& v0, const RendererVertex& v1, cons
         return;
     }
 
-    r.mappedVertex[r.vertexCount++] = v0;
-    r.mappedVertex[r.vertexCount++] = v1;
-    r.mappedVertex[r.vertexCount++] = v2;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v0;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v1;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v2;
 
-    r.mappedVertex[r.vertexCount++] = v1;
-    r.mappedVertex[r.vertexCount++] = v2;
-    r.mappedVertex[r.vertexCount++] = v3;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v1;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v2;
+    r.mappedVertex[r.vertexFirst + r.vertexCount++] = v3;
 
-    if (r.vertexCount > MAX_VERTICES - 6)
-    {
-        r.FlushBatch();
-    }
+    //Current Ring Segment is full, draw it and move on to the next one
+    if (r.vertexFirst + r.vertexCount > (r.vertexSegment + 1) * VERTEX_SEGMENT_SIZE - 6)
+        r.NextVertexSegment();
 }
 
 void Renderer::DrawPolygon(GpuVertex *vertex, uint16_t vertexNum)
 {
+    PROFILE_ZONE(ProfileZone::Rasterizer);
+
     auto& r = instance();  // Alias al singleton
 
+    if (r.backend == RendererBackend::Software)
+    {
+        RasterCommand command;
+        command.type = RasterCommand::Type::Triangle;
+        command.state = r.currentState;
+
+        std::copy(vertex, vertex + 3, command.vertex);
+        r.SubmitRaster(command);
+        if (vertexNum == 4)
+        {
+            std::copy(vertex + 1, vertex + 4, command.vertex);
+            r.SubmitRaster(command);
+        }
+        return;
+    }
+
+    if (r.backend == RendererBackend::Null)
+        return;
+
     RendererVertex v[4];
     
     r.BeginBatch();
@@ -288,8 +382,26 @@ void Renderer::DrawPolygon(GpuVertex *vertex, uint16_t vertexNum)
 
 void Renderer::DrawRectangle(GpuVertex *vertex)
 {
+    PROFILE_ZONE(ProfileZone::Rasterizer);
+
     auto& r = instance();  // Alias al singleton
 
+    if (r.backend == RendererBackend::Software)
+    {
+        //Rectangle size is limited to 1023x511
+        RasterCommand command;
+        command.type = RasterCommand::Type::Rectangle;
+        command.vertex[0] = vertex[0];
+        command.width = static_cast<uint16_t>(vertex[1].x - vertex[0].x) & 0x3ff;
+        command.height = static_cast<uint16_t>(vertex[2].y - vertex[0].y) & 0x1ff;
+        command.state = r.currentState;
+        r.SubmitRaster(command);
+        return;
+    }
+
+    if (r.backend == RendererBackend::Null)
+        return;
+
     RendererVertex v[4];
     
     r.BeginBatch();
@@ -313,8 +425,25 @@ void Renderer::DrawRectangle(GpuVertex *vertex)
 
 void Renderer::DrawPoint(GpuVertex *vertex)
 {
+    PROFILE_ZONE(ProfileZone::Rasterizer);
+
     auto& r = instance();  // Alias al singleton
 
+    if (r.backend == RendererBackend::Software)
+    {
+        RasterCommand command;
+        command.type = RasterCommand::Type::Rectangle;
+        command.vertex[0] = vertex[0];
+        command.width = 1;
+        command.height = 1;
+        command.state = r.currentState;
+        r.SubmitRaster(command);
+        return;
+    }
+
+    if (r.backend == RendererBackend::Null)
+        return;
+
     RendererVertex v[4];
 
     r.BeginBatch();
@@ -348,8 +477,24 @@ void Renderer::DrawPoint(GpuVertex *vertex)
 
 void Renderer::DrawLine(GpuVertex *vertex)
 {
+    PROFILE_ZONE(ProfileZone::Rasterizer);
+
     auto& r = instance();  // Alias al singleton
 
+    if (r.backend == RendererBackend::Software)
+    {
+        RasterCommand command;
+        command.type = RasterCommand::Type::Line;
+        command.vertex[0] = vertex[0];
+        command.vertex[1] = vertex[1];
+        command.state = r.currentState;
+        r.SubmitRaster(command);
+        return;
+    }
+
+    if (r.backend == RendererBackend::Null)
+        return;
+
     RendererVertex v[4];
     glm::vec2 p0, p1, d, n, dir;
     
@@ -402,16 +547,31 @@ bool Renderer::CommitAccessBuffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h
 {   
     auto& r = instance();  // Alias al singleton
 
+    //Software and Null Backends VRAM is the Access Buffer itself
+    if (r.backend != RendererBackend::OpenGL)
+        return true;
+
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, r.vramAccessBufferID);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 1024);
 
-    size_t offset = (y * 1024 + x) * sizeof(uint16_t);
-    glTextureSubImage2D(r.vramTexture, 0, x, y, w, h, GL_RED_INTEGER, GL_UNSIGNED_SHORT, (void*)offset);
+    glm::ivec4 areas[4];
+    int count = TransferAreas(x, y, w, h, areas);
+    for (int i = 0; i < count; i++)
+    {
+        size_t offset = (areas[i].y * 1024 + areas[i].x) * sizeof(uint16_t);
+        glTextureSubImage2D(r.vramTexture, 0, areas[i].x, areas[i].y, areas[i].z - areas[i].x + 1, areas[i].w - areas[i].y + 1, GL_RED_INTEGER, GL_UNSIGNED_SHORT, (void*)offset);
+        r.MarkTextureCacheDirty(areas[i]);
+    }
     
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
     glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
 
+    //The upload reads the Access Buffer asynchronously, the next CPU write to it must wait for it
+    if (r.accessFence)
+        glDeleteSync(r.accessFence);
+    r.accessFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
     LOG_F(2, "RND - VRAM Write Committed! [x: %d, y: %d, w: %d, h: %d]", x, y, w, h);
 
     return true;
@@ -420,21 +580,70 @@ bool Renderer::CommitAccessBuffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h
 bool Renderer::SyncAccessBuffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
     auto& r = instance();  // Alias al singleton
-     
-    // Flush any pending primitives BEFORE updating VRAM texture
-    r.FlushBatch();
 
-    // Wait for any pending rendering to complete
-    r.WaitForFence();
+    //Software and Null Backends VRAM is the Access Buffer itself, only queued primitives need to land first
+    if (r.backend != RendererBackend::OpenGL)
+    {
+        r.WaitForRasterizer();
+        return true;
+    }
+
+    glm::ivec4 areas[4];
+    int count = TransferAreas(x, y, w, h, areas);
+
+    //Batched primitives drawing over the rectangle must reach the VRAM Texture first
+    for (int i = 0; i < count && r.vertexCount > 0; i++)
+    {
+        if (AreasOverlap(r.renderingState.drawingArea, areas[i]))
+            r.FlushBatch();
+    }
+
+    //Only tiles drawn since their last read back are copied, the rest of the Access Buffer already matches the Texture
+    bool dirty = false;
+    for (int i = 0; i < count; i++)
+        dirty |= r.ReadbackVRAM(areas[i]);
+
+    if (!dirty)
+    {
+        LOG_F(3, "RND - VRAM Persistent Buffer already in sync [x: %d, y: %d, w: %d, h: %d]", x, y, w, h);
+        return true;
+    }
 
-	//Sync Persistent Buffer with VRAM Texture data before reading/writing to it, to ensure coherence between them
-	GLsizei size = w * h * sizeof(uint16_t);
-    glGetTextureSubImage(r.vramTexture, x, y, 0, 0, w, h, 1, GL_RED_INTEGER, GL_UNSIGNED_SHORT, size, r.vramAccessBuffer);
+    //Wait for the GPU to land the read back tiles in the mapped Access Buffer
+    r.WaitForFence();
+    glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+    r.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    r.WaitForFence();
        
     LOG_F(2, "RND - VRAM Persistent Buffer Synced! [x: %d, y: %d, w: %d, h: %d]", x, y, w, h);
     return true;
 }
 
+bool Renderer::CopyVRAM(uint16_t srcX, uint16_t srcY, uint16_t dstX, uint16_t dstY, uint16_t w, uint16_t h)
+{
+    auto& r = instance();  // Alias al singleton
+
+    //Software and Null Backends copy through the Access Buffer, as do copies testing or forcing the Mask Bit
+    if (r.backend != RendererBackend::OpenGL || r.currentState.checkMask || r.currentState.forceMask)
+        return false;
+
+    //Wrapping or overlapping rectangles depend on the PSX pixel copy order
+    glm::ivec4 src = { srcX, srcY, srcX + w - 1, srcY + h - 1 };
+    glm::ivec4 dst = { dstX, dstY, dstX + w - 1, dstY + h - 1 };
+    if (src.z > 1023 || src.w > 511 || dst.z > 1023 || dst.w > 511 || AreasOverlap(src, dst))
+        return false;
+
+    //Primitives batched before the copy may draw over or sample either rectangle
+    r.FlushBatch();
+
+    glCopyImageSubData(r.vramTexture, GL_TEXTURE_2D, 0, srcX, srcY, 0, r.vramTexture, GL_TEXTURE_2D, 0, dstX, dstY, 0, w, h, 1);
+    r.MarkVRAMDirty(dst);
+    r.MarkTextureCacheDirty(dst);
+
+    LOG_F(2, "RND - VRAM Copied on GPU! [src: %d, %d, dst: %d, %d, w: %d, h: %d]", srcX, srcY, dstX, dstY, w, h);
+    return true;
+}
+
 bool Renderer::WriteVRAM(uint16_t x, uint16_t y, uint16_t data)
 {
     auto& r = instance();  // Alias al singleton
@@ -444,6 +653,9 @@ bool Renderer::WriteVRAM(uint16_t x, uint16_t y, uint16_t data)
         LOG_F(ERROR, "RND - VRAM Access Buffer is null in WriteVRAM");
         return false;
     }
+
+    r.WaitForRasterizer();
+    r.WaitForFence(r.accessFence);
     r.vramAccessBuffer[y * 1024 + x] = data;
 
     return true;
@@ -459,6 +671,11 @@ bool Renderer::WriteVRAMMasked(uint16_t x, uint16_t y, uint16_t data)
         return false;
     }
 
+    r.WaitForRasterizer();
+    r.WaitForFence(r.accessFence);
+    if (r.currentState.checkMask)
+        SyncAccessBuffer(x, y, 1, 1);
+
 	//Get current value in VRAM Access Buffer
 	uint16_t currentValue = r.vramAccessBuffer[y * 1024 + x];
 	bool maskbit = (currentValue & 0x8000) != 0;
@@ -475,6 +692,68 @@ bool Renderer::WriteVRAMMasked(uint16_t x, uint16_t y, uint16_t data)
     return true;
 }
 
+bool Renderer::WriteVRAMBlock(uint16_t x, uint16_t y, std::span<const uint16_t> data, bool masked)
+{
+    auto& r = instance();  // Alias al singleton
+
+    if (r.vramAccessBuffer == nullptr)
+    {
+        LOG_F(ERROR, "RND - VRAM Access Buffer is null in WriteVRAMBlock");
+        return false;
+    }
+
+    r.WaitForRasterizer();
+    r.WaitForFence(r.accessFence);
+
+    uint16_t* dst = r.vramAccessBuffer + y * 1024 + x;
+    const uint16_t* src = data.data();
+    size_t count = data.size();
+
+    //Plain copy unless the Mask Bit settings get in the way
+    if (!masked || (!r.currentState.checkMask && !r.currentState.forceMask))
+    {
+        std::memcpy(dst, src, count * sizeof(uint16_t));
+        return true;
+    }
+
+    //Pixels with the mask bit set are kept when checkMask is enabled, the others get the forced mask bit
+    uint16_t force = r.currentState.forceMask ? 0x8000 : 0x0000;
+    bool check = r.currentState.checkMask;
+    size_t i = 0;
+
+    //Mask bit test reads the pixels already there, OpenGL may have drawn them since the last read back
+    if (check)
+        SyncAccessBuffer(x, y, static_cast<uint16_t>(count), 1);
+
+#if defined(__AVX2__)
+    const __m256i forceBits = _mm256_set1_epi16(static_cast<int16_t>(force));
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i pixels = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), forceBits);
+        __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i keep = check ? _mm256_srai_epi16(current, 15) : _mm256_setzero_si256();
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(_mm256_and_si256(keep, current), _mm256_andnot_si256(keep, pixels)));
+    }
+#elif defined(RENDERER_SSE2)
+    const __m128i forceBits = _mm_set1_epi16(static_cast<int16_t>(force));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i pixels = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), forceBits);
+        __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i keep = check ? _mm_srai_epi16(current, 15) : _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_and_si128(keep, current), _mm_andnot_si128(keep, pixels)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (!check || !(dst[i] & 0x8000))
+            dst[i] = src[i] | force;
+    }
+
+    return true;
+}
+
 uint16_t Renderer::ReadVRAM(uint16_t x, uint16_t y)
 {
     auto& r = instance();  // Alias al singleton
@@ -485,13 +764,158 @@ uint16_t Renderer::ReadVRAM(uint16_t x, uint16_t y)
         return 0;
     }
 
+    r.WaitForRasterizer();
+
     return r.vramAccessBuffer[y * 1024 + x];
 }
 
+bool Renderer::SaveVRAM(std::span<uint16_t> vram)
+{
+    auto& r = instance();  // Alias al singleton
+
+    if (vram.size() < 1024 * 512 || r.vramAccessBuffer == nullptr)
+        return false;
+
+    //Software and Null Backends VRAM is the Access Buffer itself
+    if (r.backend != RendererBackend::OpenGL)
+    {
+        r.WaitForRasterizer();
+        std::memcpy(vram.data(), r.vramAccessBuffer, 1024 * 512 * sizeof(uint16_t));
+        return true;
+    }
+
+    //Read the Texture directly, the Access Buffer may hold an unfinished CPU to VRAM transfer
+    r.FlushBatch();
+    r.WaitForFence();
+    glGetTextureImage(r.vramTexture, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, 1024 * 512 * sizeof(uint16_t), vram.data());
+
+    return true;
+}
+
+bool Renderer::LoadVRAM(std::span<const uint16_t> vram)
+{
+    auto& r = instance();  // Alias al singleton
+
+    if (vram.size() < 1024 * 512 || r.vramAccessBuffer == nullptr)
+        return false;
+
+    //Primitives queued before the load belong to the discarded state. Batches already flushed are drawn before
+    //the upload below in command order, only a previous upload still reading the Access Buffer must be waited for
+    r.WaitForFence(r.accessFence);
+    r.WaitForRasterizer();
+    r.vertexCount = 0;
+
+    std::memcpy(r.vramAccessBuffer, vram.data(), 1024 * 512 * sizeof(uint16_t));
+    r.vramDirty.fill(0);
+
+    return CommitAccessBuffer(0, 0, 1024, 512);
+}
+
+void Renderer::MarkVRAMDirty(glm::ivec4 area)
+{
+    if (area.z < area.x || area.w < area.y)
+        return;
+
+    //Drawing Areas reaching past the VRAM edges wrap around, as in AreasOverlap
+    if (area.z > 1023)
+        area.x = 0, area.z = 1023;
+    if (area.w > 511)
+        area.y = 0, area.w = 511;
+
+    uint64_t columns = TileColumns(area.x, area.z);
+    for (int row = area.y / VRAM_TILE_SIZE; row <= area.w / VRAM_TILE_SIZE; row++)
+        vramDirty[row] |= columns;
+}
+
+bool Renderer::ReadbackVRAM(glm::ivec4 area)
+{
+    if (area.z < area.x || area.w < area.y)
+        return false;
+
+    uint64_t columns = TileColumns(area.x, area.z);
+    int lastRow = area.w / VRAM_TILE_SIZE;
+    bool issued = false;
+
+    for (int row = area.y / VRAM_TILE_SIZE; row <= lastRow; row++)
+    {
+        uint64_t tiles = vramDirty[row] & columns;
+        if (tiles == 0)
+            continue;
+
+        //Following tile rows with the same dirty tiles are read back together
+        int rows = 1;
+        while (row + rows <= lastRow && (vramDirty[row + rows] & columns) == tiles)
+            rows++;
+        for (int i = 0; i < rows; i++)
+            vramDirty[row + i] &= ~tiles;
+
+        if (!issued)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, vramAccessBufferID);
+            glPixelStorei(GL_PACK_ROW_LENGTH, 1024);
+            issued = true;
+        }
+
+        //Each run of dirty tiles is packed by the GPU straight into the Access Buffer, no copy goes through client memory
+        while (tiles != 0)
+        {
+            int first = std::countr_zero(tiles);
+            int count = std::countr_one(tiles >> first);
+            tiles &= (count == 64) ? 0 : ~(((1ull << count) - 1) << first);
+
+            int x = first * VRAM_TILE_SIZE;
+            int y = row * VRAM_TILE_SIZE;
+            size_t offset = (y * 1024 + x) * sizeof(uint16_t);
+            glGetTextureSubImage(vramTexture, 0, x, y, 0, count * VRAM_TILE_SIZE, rows * VRAM_TILE_SIZE, 1, GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+                static_cast<GLsizei>(1024 * 512 * sizeof(uint16_t) - offset), (void*)offset);
+        }
+
+        row += rows - 1;
+    }
+
+    if (issued)
+    {
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    return issued;
+}
+
+uint64_t Renderer::TileColumns(int x1, int x2)
+{
+    int first = x1 / VRAM_TILE_SIZE;
+    int last = x2 / VRAM_TILE_SIZE;
+    return (~0ull >> (63 - last)) & (~0ull << first);
+}
+
+int Renderer::TransferAreas(uint16_t x, uint16_t y, uint16_t w, uint16_t h, glm::ivec4 (&areas)[4])
+{
+    //Transfer rectangles wrap around the VRAM edges, split them where they do
+    int w1 = std::min(static_cast<int>(w), 1024 - x);
+    int h1 = std::min(static_cast<int>(h), 512 - y);
+    int count = 0;
+
+    areas[count++] = { x, y, x + w1 - 1, y + h1 - 1 };
+    if (w1 < w)
+        areas[count++] = { 0, y, w - w1 - 1, y + h1 - 1 };
+    if (h1 < h)
+    {
+        areas[count++] = { x, 0, x + w1 - 1, h - h1 - 1 };
+        if (w1 < w)
+            areas[count++] = { 0, 0, w - w1 - 1, h - h1 - 1 };
+    }
+
+    return count;
+}
+
 GLuint Renderer::GetVRAMTextureObject()
 {
     auto& r = instance();  // Alias al singleton
 
+    if (!r.glEnabled)
+        return 0;
+
     // Read from rendered vramTexture and upload to debug texture
     static std::vector<uint16_t> vramData(1024 * 512);
     glGetTextureImage(r.vramTexture, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, vramData.size() * sizeof(uint16_t), vramData.data());
@@ -538,6 +962,16 @@ void Renderer::vBlank()
 void Renderer::ScreenUpdate()
 {
     auto& r = instance();  // Alias al singleton       
+
+    if (!r.glEnabled)
+        return;
+
+    //Software Backend draws on the CPU, upload the whole host VRAM before presenting it
+    if (r.backend == RendererBackend::Software)
+    {
+        r.WaitForRasterizer();
+        glTextureSubImage2D(r.vramTexture, 0, 0, 0, 1024, 512, GL_RED_INTEGER, GL_UNSIGNED_SHORT, r.vramHostBuffer.data());
+    }
    
     //Flush Remaining Vertex to VRAM before rendering to Video
     r.FlushBatch();
@@ -583,6 +1017,7 @@ void Renderer::BeginBatch()
         r.FlushBatch();    
         
         r.renderingState = r.currentState;
+        r.renderingGeneration++;
         LOG_F(2, "RND - Begin new Vertex Batch! - Rendering State Changed!");
         LOG_F(2, "RND - Updated renderingState: textured=%d, texPageCoords=[%d,%d], clutCoords=[%d,%d]", 
             r.renderingState.textured, r.renderingState.texPageCoords.x, r.renderingState.texPageCoords.y,
@@ -593,11 +1028,9 @@ void Renderer::BeginBatch()
 bool Renderer::FlushBatch()
 {
     auto& r = instance();  // Alias al singleton
-    
-    //Wait for previous batch rendering to end before start rendering the next
-    //Right now this wait only for Video Rendering to end since we are stalling waiting
-    //for the batch to be rendered before rendering to Video in ScreenUpdate().
-    r.WaitForFence();
+
+    if (r.backend != RendererBackend::OpenGL)
+        return false;
 
     //Skip if there's no vertex to flush
     if (r.vertexCount == 0)
@@ -608,31 +1041,54 @@ bool Renderer::FlushBatch()
 
     //Draw to FrameBuffer
     glBindVertexArray(r.vaoRenderBuffer);
-    glDrawArrays(GL_TRIANGLES, 0, r.vertexCount);
-    r.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-    glFlush();
-   
-    // Flush sets a new fence; wait before reusing the buffer from offset 0.
-    // TODO: implement a ring buffer to avoid stalls.
-    r.WaitForFence();
+    glDrawArrays(GL_TRIANGLES, r.vertexFirst, r.vertexCount);
+    r.MarkVRAMDirty(r.renderingState.drawingArea);
+    r.MarkTextureCacheDirty(r.renderingState.drawingArea);
+
+    //Shader samples the VRAM Texture it draws to, following Batches must see what this one has drawn
+    glTextureBarrier();
 
+    //Next Batch follows in the same Ring Segment, no need to wait for this one to be drawn
     LOG_F(2, "RND - Flushed Vertex Batch (VertexNum: %d)", r.vertexCount);
+    r.vertexFirst += r.vertexCount;
     r.vertexCount = 0;
 
     return true;
 }
 
+void Renderer::NextVertexSegment()
+{
+    auto& r = instance();  // Alias al singleton
+
+    r.FlushBatch();
+
+    //Fence the draws reading the Segment being left, then start over on the next one
+    r.vertexFence[r.vertexSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    r.vertexSegment = (r.vertexSegment + 1) % VERTEX_RING_SEGMENTS;
+    r.vertexFirst = r.vertexSegment * VERTEX_SEGMENT_SIZE;
+
+    //Only stalls when the GPU is a whole ring behind
+    r.WaitForFence(r.vertexFence[r.vertexSegment]);
+}
+
 void Renderer::WaitForFence()
 {
     auto& r = instance();  // Alias al singleton
 
-    if (!r.fence)
+    r.WaitForFence(r.fence);
+}
+
+void Renderer::WaitForFence(GLsync& sync)
+{
+    if (!sync)
         return;
 
     GLenum status;
     do {
         status = glClientWaitSync(
-            r.fence,
+            sync,
             GL_SYNC_FLUSH_COMMANDS_BIT,
             GL_SYNC_TIMEOUT
         );
@@ -645,13 +1101,16 @@ void Renderer::WaitForFence()
         LOG_F(3, "RND - Still waiting for OpenGL command end!");
     } while (status == GL_TIMEOUT_EXPIRED);
 
-    glDeleteSync(r.fence);
-    r.fence = nullptr;
+    glDeleteSync(sync);
+    sync = nullptr;
 }
 
 void Renderer::SetupRenderShader()
 {
     auto& r = instance();  // Alias al singleton
+
+    //Decoding a Texture Page draws into the Texture Cache, it must be done before binding the VRAM Framebuffer
+    r.textureCacheLayer = r.CachedTexturePage();
     
     glBindFramebuffer(GL_FRAMEBUFFER, r.vramFrameBuffer);
     glViewport(0, 0, 1024, 512); //Viewport is the size of the VRAM
@@ -663,37 +1122,153 @@ void Renderer::SetupRenderShader()
 
     r.RenderShader->Use();
 
-    //Set Drawing Area and Drawing Offset for Vertex Shader
-    r.RenderShader->setUniformi("uDrawArea", r.renderingState.drawingArea);
-    r.RenderShader->setUniformi("uDrawOffset", r.renderingState.drawingOffset);
-    r.RenderShader->setUniformb("uDrawEnable", r.renderingState.drawingOnDisplayEnabled);
+    //Rendering State reaches both shader stages through one Uniform Buffer, uploaded only when it has changed
+    if (r.uniformGeneration != r.renderingGeneration || r.uniformCacheLayer != r.textureCacheLayer)
+    {
+        const RendererState& state = r.renderingState;
+        RenderUniforms uniforms;
+
+        uniforms.drawArea = state.drawingArea;
+        uniforms.drawOffset = state.drawingOffset;
+        uniforms.texPage = state.texPageCoords;
+        uniforms.clut = state.clutTableCoords;
+        uniforms.texMask = state.texMask;
+        uniforms.texOffset = state.texOffset;
+        uniforms.texColorMode = state.texColorMode;
+        uniforms.semiTransMode = state.semiTransparentMode;
+        uniforms.texCacheLayer = r.textureCacheLayer;
+        uniforms.drawEnable = state.drawingOnDisplayEnabled;
+        uniforms.textured = state.textured;
+        uniforms.texBlending = state.texBlending;
+        uniforms.texDisable = state.texDisable;
+        uniforms.semiTrans = state.semiTranparent;
+        uniforms.checkMask = state.checkMask;
+        uniforms.forceMask = state.forceMask;
+        uniforms.dither = state.dither;
+
+        glNamedBufferSubData(r.uboRenderState, 0, sizeof(RenderUniforms), &uniforms);
+        r.uniformGeneration = r.renderingGeneration;
+        r.uniformCacheLayer = r.textureCacheLayer;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, RENDER_STATE_BINDING, r.uboRenderState);
 
-    //Bind VRAM Texture, Shader reads PSX CLUT and TEXPAGE value from this Texture
+    //Bind VRAM Texture to unit 0, Shader reads PSX CLUT and TEXPAGE value from this Texture
     glBindTextureUnit(0, r.vramTexture); 
-    r.RenderShader->setUniformi("uVRAM", 0);
-
-    //Set CLUT and TEXPAGE parameters
-    r.RenderShader->setUniformi("uTPage", r.renderingState.texPageCoords);
-    r.RenderShader->setUniformi("uClut", r.renderingState.clutTableCoords);
-    r.RenderShader->setUniformi("uTexColorMode", r.renderingState.texColorMode);
-    r.RenderShader->setUniformi("uTexMask", r.renderingState.texMask);
-    r.RenderShader->setUniformi("uTexOffset", r.renderingState.texOffset);
-
-    //Set Texture Flags
-    r.RenderShader->setUniformb("uTextured", r.renderingState.textured);
-    r.RenderShader->setUniformb("uTexBlending", r.renderingState.texBlending);
-    r.RenderShader->setUniformb("uTexDisable", r.renderingState.texDisable);
-    
-    //Set Semi Transparency Flags and Mode
-    r.RenderShader->setUniformb("uSemiTrans", r.renderingState.semiTranparent);
-    r.RenderShader->setUniformi("uSemiTransMode", r.renderingState.semiTransparentMode);
 
-    //Set Mask bit Flags
-    r.RenderShader->setUniformb("uCheckMaskBit", r.renderingState.checkMask);
-    r.RenderShader->setUniformb("uForceMaskBit", r.renderingState.forceMask);
+    //Bind Texture Cache to unit 1, Shader reads decoded Texture Page texels from the layer in uTexCacheLayer
+    if (r.textureCacheEnabled)
+        glBindTextureUnit(1, r.textureCacheArray);
+}
 
-    //Set Dither Flag
-    r.RenderShader->setUniformb("uDither", r.renderingState.dither);
+//--------------------------------------------------------------------------------------------------------------------
+//
+// Texture Cache Functions, 4 and 8 bit Texture Pages decoded to direct colors on the OpenGL Backend
+//
+//--------------------------------------------------------------------------------------------------------------------
+int Renderer::CachedTexturePage()
+{
+    auto& r = instance();  // Alias al singleton
+
+    if (!r.textureCacheEnabled)
+        return -1;
+
+    //Drop entries reading any block written since the last lookup
+    if (r.textureCacheDirty.any())
+    {
+        for (auto& entry : r.textureCache)
+        {
+            if (entry.valid && (entry.blocks & r.textureCacheDirty).any())
+                entry.valid = false;
+        }
+        r.textureCacheDirty.reset();
+    }
+
+    //Only CLUT Textures need decoding. Primitives drawing over their own Texture Page or CLUT
+    //see their own writes and can't use a copy taken before them
+    const RendererState& state = r.renderingState;
+    if (!state.textured || state.texDisable || state.texColorMode > 1 || TextureOverlaps(state, state.drawingArea))
+        return -1;
+
+    //Look up the Texture Page, or replace the least recently used layer
+    int layer = 0;
+    for (int i = 0; i < TEXTURE_CACHE_LAYERS; i++)
+    {
+        const TextureCacheEntry& entry = r.textureCache[i];
+        if (entry.valid && entry.texPage == state.texPageCoords && entry.clut == state.clutTableCoords && entry.colorMode == state.texColorMode)
+        {
+            r.textureCache[i].lastUse = ++r.textureCacheClock;
+            return i;
+        }
+
+        if (!entry.valid || (r.textureCache[layer].valid && entry.lastUse < r.textureCache[layer].lastUse))
+            layer = i;
+    }
+
+    if (!r.DecodeTexturePage(layer))
+        return -1;
+
+    TextureCacheEntry& entry = r.textureCache[layer];
+    entry.texPage = state.texPageCoords;
+    entry.clut = state.clutTableCoords;
+    entry.colorMode = state.texColorMode;
+    entry.blocks = AreaBlocks(TexturePageArea(state)) | AreaBlocks(ClutArea(state));
+    entry.lastUse = ++r.textureCacheClock;
+    entry.valid = true;
+
+    LOG_F(2, "RND - Texture Page Decoded [layer: %d, tpage: %d, %d, clut: %d, %d, mode: %d]", layer, entry.texPage.x, entry.texPage.y, entry.clut.x, entry.clut.y, entry.colorMode);
+    return layer;
+}
+
+bool Renderer::DecodeTexturePage(int layer)
+{
+    auto& r = instance();  // Alias al singleton
+
+    const RendererState& state = r.renderingState;
+
+    glNamedFramebufferTextureLayer(r.textureCacheFrameBuffer, GL_COLOR_ATTACHMENT0, r.textureCacheArray, 0, layer);
+    glBindFramebuffer(GL_FRAMEBUFFER, r.textureCacheFrameBuffer);
+    glViewport(0, 0, 256, 256); //Viewport is the size of a Texture Page
+
+    r.TextureCacheShader->Use();
+    r.TextureCacheShader->setUniformi("uTPage", state.texPageCoords);
+    r.TextureCacheShader->setUniformi("uClut", state.clutTableCoords);
+    r.TextureCacheShader->setUniformi("uTexColorMode", state.texColorMode);
+
+    //Decode reads the VRAM Texture, every texel of the layer is written by the Framebuffer Quad
+    glBindTextureUnit(0, r.vramTexture);
+    glBindVertexArray(r.vaoFrameBuffer);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+    return true;
+}
+
+void Renderer::MarkTextureCacheDirty(glm::ivec4 area)
+{
+    auto& r = instance();  // Alias al singleton
+
+    if (r.textureCacheEnabled)
+        r.textureCacheDirty |= AreaBlocks(area);
+}
+
+Renderer::TextureBlocks Renderer::AreaBlocks(glm::ivec4 area)
+{
+    TextureBlocks blocks;
+    if (area.z < area.x || area.w < area.y)
+        return blocks;
+
+    //Drawing Areas reaching past the VRAM edges wrap around, as in AreasOverlap
+    if (area.z > 1023)
+        area.x = 0, area.z = 1023;
+    if (area.w > 511)
+        area.y = 0, area.w = 511;
+
+    constexpr int columns = 1024 / TEXTURE_CACHE_BLOCK;
+    for (int by = area.y / TEXTURE_CACHE_BLOCK; by <= area.w / TEXTURE_CACHE_BLOCK; by++)
+    {
+        for (int bx = area.x / TEXTURE_CACHE_BLOCK; bx <= area.z / TEXTURE_CACHE_BLOCK; bx++)
+            blocks.set(by * columns + bx);
+    }
+    return blocks;
 }
 
 void Renderer::SetupFramebufferShader()
@@ -728,6 +1303,251 @@ void Renderer::SetupFramebufferShader()
     r.displayState.evenfield = !r.displayState.evenfield;
 }
 
+//--------------------------------------------------------------------------------------------------------------------
+//
+// Software Rasterizer Thread Functions
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Renderer::StartRasterizer()
+{
+    auto& r = instance();  // Alias al singleton
+
+    //One worker per spare core unless requested otherwise. Workers are a power of two so that
+    //y % workers matches the wrapped VRAM line (y & 0x1ff) and no line is owned twice
+    int threads = r.rasterThreads;
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    threads = std::clamp(threads, 1, RASTER_MAX_THREADS);
+    while (threads & (threads - 1))
+        threads &= threads - 1;
+
+    r.rasterSubmitted = 0;
+    r.rasterQueued = 0;
+    r.rasterIdle = true;
+    r.rasterizer = std::make_unique<Rasterizer>(r.vramHostBuffer.data());
+
+    for (int i = 0; i < threads; i++)
+    {
+        auto worker = std::make_unique<RasterWorker>();
+        worker->rasterizer = std::make_unique<Rasterizer>(r.vramHostBuffer.data());
+        worker->rasterizer->setLineSlice(i, threads);
+        worker->thread = std::thread(&Renderer::RasterizerLoop, &r, std::ref(*worker));
+        r.rasterWorkers.push_back(std::move(worker));
+    }
+
+    LOG_F(INFO, "RND - Software Rasterizer running on %d threads", threads);
+}
+
+void Renderer::StopRasterizer()
+{
+    auto& r = instance();  // Alias al singleton
+
+    if (r.rasterWorkers.empty())
+        return;
+
+    //Stop is queued behind the pending primitives, they are all drawn before the threads exit
+    RasterCommand command;
+    command.type = RasterCommand::Type::Stop;
+    r.SubmitRaster(command);
+
+    for (auto& worker : r.rasterWorkers)
+        worker->thread.join();
+
+    r.rasterWorkers.clear();
+    r.rasterizer.reset();
+}
+
+void Renderer::SubmitRaster(const RasterCommand& command)
+{
+    auto& r = instance();  // Alias al singleton
+
+    //A texture fetch may read lines another worker hasn't drawn yet
+    bool textured = command.type != RasterCommand::Type::Line && command.state.textured && !command.state.texDisable;
+    if (textured && r.rasterWorkers.size() > 1)
+    {
+        //Sampling its own Drawing Area depends on the lines drawn before, the whole primitive is drawn here in order
+        if (TextureOverlaps(command.state, command.state.drawingArea))
+        {
+            r.WaitForRasterizer();
+            Rasterize(*r.rasterizer, command);
+            return;
+        }
+
+        //Otherwise only the previous primitives must be done
+        if (!r.rasterIdle && TextureOverlaps(command.state, r.rasterDirty))
+            r.WaitForRasterizer();
+    }
+
+    //A worker ahead of the others must not draw over texels they may still sample
+    if (r.rasterWorkers.size() > 1 && !r.rasterIdle)
+    {
+        if (AreasOverlap(command.state.drawingArea, r.rasterPages) || AreasOverlap(command.state.drawingArea, r.rasterCluts))
+            r.WaitForRasterizer();
+    }
+
+    for (auto& worker : r.rasterWorkers)
+    {
+        //Queue is full, wait for the worker to finish some primitives
+        while (!worker->queue.push(&command, 1))
+        {
+            PROFILE_ZONE(ProfileZone::Rasterizer);
+            worker->completed.wait(worker->completed.load(std::memory_order_acquire), std::memory_order_acquire);
+        }
+    }
+
+    //Track the areas the queued primitives may still write to and sample from
+    if (r.rasterIdle)
+    {
+        r.rasterDirty = { 0, 0, -1, -1 };
+        r.rasterPages = { 0, 0, -1, -1 };
+        r.rasterCluts = { 0, 0, -1, -1 };
+    }
+    MergeArea(r.rasterDirty, command.state.drawingArea);
+    if (textured)
+    {
+        MergeArea(r.rasterPages, TexturePageArea(command.state));
+        MergeArea(r.rasterCluts, ClutArea(command.state));
+    }
+    r.rasterIdle = false;
+
+    r.rasterSubmitted++;
+    r.rasterQueued.store(r.rasterSubmitted, std::memory_order_release);
+    r.rasterQueued.notify_all();
+}
+
+void Renderer::WaitForRasterizer()
+{
+    auto& r = instance();  // Alias al singleton
+
+    if (r.rasterIdle)
+        return;
+
+    //Acquiring each worker completed count makes the pixels it has drawn visible to the emulation thread
+    PROFILE_ZONE(ProfileZone::Rasterizer);
+    for (auto& worker : r.rasterWorkers)
+    {
+        uint64_t completed = worker->completed.load(std::memory_order_acquire);
+        while (completed != r.rasterSubmitted)
+        {
+            worker->completed.wait(completed, std::memory_order_acquire);
+            completed = worker->completed.load(std::memory_order_acquire);
+        }
+    }
+
+    r.rasterIdle = true;
+}
+
+bool Renderer::TextureOverlaps(const RendererState& state, glm::ivec4 area)
+{
+    return AreasOverlap(area, TexturePageArea(state)) || AreasOverlap(area, ClutArea(state));
+}
+
+glm::ivec4 Renderer::TexturePageArea(const RendererState& state)
+{
+    //Texture Page spans 256 texels, 4 and 8 bit texels are packed in 16 bit VRAM pixels. Reads wrapping around VRAM cover its whole width
+    int x = state.texPageCoords.x;
+    int y = state.texPageCoords.y;
+    int w = (state.texColorMode == 0) ? 64 : (state.texColorMode == 1) ? 128 : 256;
+    int h = 256;
+
+    glm::ivec4 area = { x, y, x + w - 1, y + h - 1 };
+    if (x + w > 1024)
+        area.x = 0, area.z = 1023;
+    if (y + h > 512)
+        area.y = 0, area.w = 511;
+    return area;
+}
+
+glm::ivec4 Renderer::ClutArea(const RendererState& state)
+{
+    //15 bit Textures don't use any CLUT
+    if (state.texColorMode >= 2)
+        return { 0, 0, -1, -1 };
+
+    int x = state.clutTableCoords.x;
+    int y = state.clutTableCoords.y;
+    int w = (state.texColorMode == 0) ? 16 : 256;
+
+    glm::ivec4 area = { x, y, x + w - 1, y };
+    if (x + w > 1024)
+        area.x = 0, area.z = 1023;
+    return area;
+}
+
+bool Renderer::AreasOverlap(glm::ivec4 area, glm::ivec4 box)
+{
+    //Empty areas (x2 < x1 or y2 < y1) never overlap
+    if (area.z < area.x || area.w < area.y || box.z < box.x || box.w < box.y)
+        return false;
+
+    //Drawing Areas reaching past the VRAM edges wrap around, treat them as covering the whole VRAM
+    if (area.z > 1023)
+        area.x = 0, area.z = 1023;
+    if (area.w > 511)
+        area.y = 0, area.w = 511;
+
+    return box.x <= area.z && box.z >= area.x && box.y <= area.w && box.w >= area.y;
+}
+
+void Renderer::MergeArea(glm::ivec4& into, glm::ivec4 area)
+{
+    if (area.z < area.x || area.w < area.y)
+        return;
+
+    if (into.z < into.x || into.w < into.y)
+        into = area;
+    else
+        into = { std::min(into.x, area.x), std::min(into.y, area.y), std::max(into.z, area.z), std::max(into.w, area.w) };
+}
+
+void Renderer::Rasterize(Rasterizer& rasterizer, const RasterCommand& command)
+{
+    switch (command.type)
+    {
+    case RasterCommand::Type::Triangle:
+        rasterizer.drawTriangle(command.vertex[0], command.vertex[1], command.vertex[2], command.state);
+        break;
+    case RasterCommand::Type::Rectangle:
+        rasterizer.drawRectangle(command.vertex[0], command.width, command.height, command.state);
+        break;
+    case RasterCommand::Type::Line:
+        rasterizer.drawLine(command.vertex[0], command.vertex[1], command.state);
+        break;
+    case RasterCommand::Type::Stop:
+        break;
+    }
+}
+
+void Renderer::RasterizerLoop(RasterWorker& worker)
+{
+    constexpr size_t batchSize = 64;
+
+    RasterCommand batch[batchSize];
+    uint64_t completed = 0;
+    bool running = true;
+
+    while (running)
+    {
+        //Sleep until the emulation thread queues something
+        rasterQueued.wait(completed, std::memory_order_acquire);
+
+        size_t count;
+        while (running && (count = worker.queue.pop(batch, std::min(worker.queue.length(), batchSize))) != 0)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                Rasterize(*worker.rasterizer, batch[i]);
+                running = running && batch[i].type != RasterCommand::Type::Stop;
+            }
+
+            //Publish the drawn pixels, the emulation thread may be waiting on them
+            completed += count;
+            worker.completed.store(completed, std::memory_order_release);
+            worker.completed.notify_all();
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------------------------
 //
 // Video Display State Setting Functions
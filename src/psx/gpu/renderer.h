@@ -3,17 +3,35 @@
 #include <cstring>
 #include <cstdint>
 #include <memory>
+#include <array>
 #include <vector>
 #include <span>
+#include <atomic>
+#include <thread>
+#include <bitset>
 
 #include "GL/glew.h"
 #include "glm/glm.hpp"
 
 #include "shader.h"
 #include "gpu_utils.h"
+#include "rasterizer.h"
 
 static constexpr auto MAX_VERTICES = 65536;
+static constexpr auto VERTEX_RING_SEGMENTS = 4;
+static constexpr auto VERTEX_SEGMENT_SIZE = MAX_VERTICES / VERTEX_RING_SEGMENTS;
 static constexpr auto GL_SYNC_TIMEOUT = 500000;
+static constexpr auto RENDER_STATE_BINDING = 0;         //Uniform Buffer binding of the RenderState block, as declared in the Render Shaders
+static constexpr auto RASTER_QUEUE_SIZE = 4096;
+static constexpr auto RASTER_MAX_THREADS = 8;
+static constexpr auto VRAM_TILE_SIZE = 16;
+static constexpr auto TEXTURE_CACHE_LAYERS = 32;
+static constexpr auto TEXTURE_CACHE_BLOCK = 64;
+static constexpr auto TEXTURE_CACHE_BLOCKS = (1024 / TEXTURE_CACHE_BLOCK) * (512 / TEXTURE_CACHE_BLOCK);
+
+//Renderer Backends, Software rasterizes on the CPU into host memory VRAM,
+//Null keeps VRAM in host memory and discards all drawing (headless runs)
+enum class RendererBackend { OpenGL, Software, Null };
 
 struct RendererVertex
 {
@@ -65,6 +83,42 @@ struct RendererState
     }
 };
 
+//std140 layout of the RenderState Uniform Block in the Render Shaders, bools take 4 bytes
+struct RenderUniforms
+{
+    glm::ivec4  drawArea;
+    glm::ivec2  drawOffset;
+    glm::ivec2  texPage;
+    glm::ivec2  clut;
+    glm::ivec2  texMask;
+    glm::ivec2  texOffset;
+    GLint       texColorMode;
+    GLint       semiTransMode;
+    GLint       texCacheLayer;
+    GLuint      drawEnable;
+    GLuint      textured;
+    GLuint      texBlending;
+    GLuint      texDisable;
+    GLuint      semiTrans;
+    GLuint      checkMask;
+    GLuint      forceMask;
+    GLuint      dither;
+    GLuint      padding[3];
+};
+static_assert(sizeof(RenderUniforms) == 112, "RenderUniforms must match the std140 RenderState block");
+
+//Primitive queued by the Software Backend, carries the Rendering State it was submitted with
+struct RasterCommand
+{
+    enum class Type : uint8_t { Triangle, Rectangle, Line, Stop };
+
+    Type            type;
+    GpuVertex       vertex[3];
+    int32_t         width;
+    int32_t         height;
+    RendererState   state;
+};
+
 class Renderer
 {
     public:
@@ -74,6 +128,16 @@ class Renderer
             return *instance;
         }
     
+        //Renderer Backend Selection, must be set before Init(). Headless renderers never touch OpenGL
+        static void SetBackend(RendererBackend backend, bool headless = false) { instance().backend = backend; instance().headless = headless; }
+        static RendererBackend GetBackend() { return instance().backend; }
+
+        //Software Backend Rasterizer Threads, must be set before Init(). 0 picks one per spare core
+        static void SetRasterizerThreads(int threads) { instance().rasterThreads = threads; }
+
+        //OpenGL Backend Texture Cache of decoded CLUT Texture Pages, must be set before Init()
+        static void SetTextureCache(bool enabled) { instance().textureCacheEnabled = enabled; }
+
         //Renderer Interface
         static bool Init();
         static bool Reset();
@@ -119,7 +183,11 @@ class Renderer
 		static bool SyncAccessBuffer(uint16_t x, uint16_t y, uint16_t w, uint16_t h);     //Copy VRAM Texture to Access Buffer, to sync them before reading
         static bool WriteVRAM(uint16_t x, uint16_t y, uint16_t data);
         static bool WriteVRAMMasked(uint16_t x, uint16_t y, uint16_t data);
+        static bool WriteVRAMBlock(uint16_t x, uint16_t y, std::span<const uint16_t> data, bool masked);   //Run of pixels on one VRAM line, x + size <= 1024
+        static bool CopyVRAM(uint16_t srcX, uint16_t srcY, uint16_t dstX, uint16_t dstY, uint16_t w, uint16_t h);  //Copy done by OpenGL, false when it has to go through the Access Buffer
         static uint16_t ReadVRAM(uint16_t x, uint16_t y);
+        static bool SaveVRAM(std::span<uint16_t> vram);                                   //Copy the whole VRAM out, pending primitives are drawn first
+        static bool LoadVRAM(std::span<const uint16_t> vram);                             //Replace the whole VRAM, pending primitives are dropped
         static GLuint GetVRAMTextureObject();
         
  
@@ -131,10 +199,44 @@ class Renderer
         void PushVertex(const RendererVertex& v);
         void PushTriangle(const RendererVertex& v0, const RendererVertex& v1, const RendererVertex& v2);
         void PushQuad(const RendererVertex& v0, const RendererVertex& v1, const RendererVertex& v2, const RendererVertex& v3);
+        void NextVertexSegment();
         void WaitForFence();
+        void WaitForFence(GLsync& sync);
         void SetupRenderShader();
         void SetupFramebufferShader();
+
+        //Software Backend Rasterizer Threads
+        struct RasterWorker;
+        void StartRasterizer();
+        void StopRasterizer();
+        void SubmitRaster(const RasterCommand& command);
+        void WaitForRasterizer();
+        void RasterizerLoop(RasterWorker& worker);
+        static void Rasterize(Rasterizer& rasterizer, const RasterCommand& command);
+        static bool TextureOverlaps(const RendererState& state, glm::ivec4 area);
+        static glm::ivec4 TexturePageArea(const RendererState& state);
+        static glm::ivec4 ClutArea(const RendererState& state);
+        static bool AreasOverlap(glm::ivec4 area, glm::ivec4 box);
+        static void MergeArea(glm::ivec4& into, glm::ivec4 area);
+
+        //OpenGL Backend VRAM Tiles drawn since the Access Buffer last read them back
+        void MarkVRAMDirty(glm::ivec4 area);
+        bool ReadbackVRAM(glm::ivec4 area);
+        static uint64_t TileColumns(int x1, int x2);
+        static int TransferAreas(uint16_t x, uint16_t y, uint16_t w, uint16_t h, glm::ivec4 (&areas)[4]);
+
+        //OpenGL Backend Texture Cache
+        using TextureBlocks = std::bitset<TEXTURE_CACHE_BLOCKS>;
+        int CachedTexturePage();
+        bool DecodeTexturePage(int layer);
+        void MarkTextureCacheDirty(glm::ivec4 area);
+        static TextureBlocks AreaBlocks(glm::ivec4 area);
                 
+        //Active Backend
+        RendererBackend         backend = RendererBackend::OpenGL;
+        bool                    headless = false;
+        bool                    glEnabled = false;          //OpenGL resources are available (OpenGL Backend or Software Backend with a window)
+
         //Frame Status
         bool                    frameReady;
 
@@ -146,26 +248,82 @@ class Renderer
         DisplayState            displayState;               //Current Display configuration
         RendererState           currentState;               //Current Rendering State being set
         RendererState           renderingState;             //Actual State used for rendering
+        uint32_t                renderingGeneration = 0;    //Bumped on every renderingState change
+        uint32_t                uniformGeneration = ~0u;    //renderingState generation held by the RenderState Uniform Buffer
 
         //Internal Structures
         GLuint                  vaoRenderBuffer;            //VAO for Rendering
         GLuint                  vboRenderBuffer;            //Vertex Persistent Buffer Object for Rendering
         GLuint                  vaoFrameBuffer;             //VAO for Framebuffer Quad
         GLuint                  vboFrameBuffer;             //Vertex Buffer Object for Framebuffer Quad
+        GLuint                  uboRenderState;             //Uniform Buffer Object with renderingState for the Render Shaders
         GLuint                  vramTexture;                //Texture Object representing PSX VRAM
         GLuint                  vramAccessBufferID;         //VRAM Persistent Buffer Object
         GLuint                  vramFrameBuffer;            //Frame Buffer Object for Primitive Rendering
 		GLuint                  vramDebugTexture;           //Texture Used to render VRAM content for debugging purposes on ImGui Widget
 
-        //Persistent Vertex Buffer for Rendering Primitives
+        //Persistent Vertex Buffer for Rendering Primitives, a ring of VERTEX_RING_SEGMENTS segments.
+        //Batches are appended to the current segment while the GPU still draws the previous ones,
+        //a segment is written again only once the fence placed when leaving it has signaled
         RendererVertex*         mappedVertex = nullptr;     //Mapped Vertex Container, cointains the actual data.
         int                     vertexCount = 0;            //Number of Vertex on the current Batch
-        GLsync                  fence = nullptr;            //OpenGL Sync object
+        int                     vertexFirst = 0;            //First Vertex of the current Batch
+        int                     vertexSegment = 0;          //Ring Segment being written
+        std::array<GLsync, VERTEX_RING_SEGMENTS> vertexFence{};    //Fence after the last draw reading each Segment
+        GLsync                  fence = nullptr;            //Fence after the last read back or presented frame
+        GLsync                  accessFence = nullptr;      //Fence after the last upload reading the Access Buffer, CPU writes to it wait for this
 
         uint16_t*               vramAccessBuffer;           //Mapped PersiObject Container, contains the actual VRAM data
+        std::vector<uint16_t>   vramHostBuffer;             //Host VRAM used in place of the Persistent Buffer by Software and Null Backends
+
+        //OpenGL Backend draws into the VRAM Texture only, the Access Buffer is stale where primitives landed since the last read back.
+        //One bit per VRAM_TILE_SIZE square tile, each 64 bit row covers the whole VRAM width
+        std::array<uint64_t, 512 / VRAM_TILE_SIZE> vramDirty{};
+
+        //OpenGL Backend Texture Cache, 4 and 8 bit Texture Pages decoded through their CLUT into a layer of textureCacheArray.
+        //Writes to VRAM mark its TEXTURE_CACHE_BLOCK square blocks dirty, entries reading any dirty block are dropped before the next lookup
+        struct TextureCacheEntry
+        {
+            glm::ivec2          texPage;                    //Texture Page base
+            glm::ivec2          clut;                       //CLUT base
+            int                 colorMode;                  //0 = 4bit, 1 = 8bit
+            TextureBlocks       blocks;                     //VRAM blocks read by the decoded layer (Texture Page and CLUT)
+            uint64_t            lastUse = 0;                //textureCacheClock of the last lookup, least recently used layer is replaced
+            bool                valid = false;
+        };
+        bool                    textureCacheEnabled = false;
+        std::array<TextureCacheEntry, TEXTURE_CACHE_LAYERS> textureCache;
+        TextureBlocks           textureCacheDirty;          //Blocks written since the last lookup
+        uint64_t                textureCacheClock = 0;
+        int                     textureCacheLayer = -1;     //Layer used by renderingState, -1 reads VRAM directly
+        int                     uniformCacheLayer = -1;     //Layer held by the RenderState Uniform Buffer
+        GLuint                  textureCacheArray = 0;      //GL_TEXTURE_2D_ARRAY of TEXTURE_CACHE_LAYERS 256x256 direct color layers
+        GLuint                  textureCacheFrameBuffer = 0;    //Frame Buffer Object used to decode a Texture Page into a layer
+
+        //Software Backend primitives are drawn by the Rasterizer Threads, the emulation thread waits for them only before touching VRAM.
+        //Every worker gets every primitive in submission order and draws only the VRAM lines it owns (y % workers == index),
+        //so each pixel still sees the exact PSX draw order and mask bit sequence.
+        using RasterQueue = lite::spscring<RasterCommand, RASTER_QUEUE_SIZE>;
+        struct RasterWorker
+        {
+            std::unique_ptr<Rasterizer> rasterizer;         //Draws into vramHostBuffer, restricted to the worker lines
+            RasterQueue             queue;                  //Primitives waiting for this worker
+            std::thread             thread;
+            std::atomic<uint64_t>   completed = 0;          //Primitives drawn, written by the worker only
+        };
+        std::vector<std::unique_ptr<RasterWorker>> rasterWorkers;
+        std::unique_ptr<Rasterizer> rasterizer;             //Draws whole primitives on the emulation thread when workers can't split them
+        int                     rasterThreads = 0;          //Requested worker count, 0 is automatic
+        uint64_t                rasterSubmitted = 0;        //Primitives pushed, written by the emulation thread only
+        bool                    rasterIdle = true;          //Every submitted primitive is drawn, emulation thread only
+        glm::ivec4              rasterDirty;                //Drawing Areas of the primitives not known to be drawn yet (x1, y1, x2, y2)
+        glm::ivec4              rasterPages;                //Texture Pages sampled by the same primitives, a worker ahead must not draw over them
+        glm::ivec4              rasterCluts;                //CLUTs sampled by the same primitives
+        std::atomic<uint64_t>   rasterQueued = 0;           //Published copy of rasterSubmitted, wakes the workers
 
         std::unique_ptr<Shader> FramebufferShader;          //Framebuffer Rendering Shader Program   
         std::unique_ptr<Shader> RenderShader;               //Primitive Rendering Shader Program
+        std::unique_ptr<Shader> TextureCacheShader;         //Texture Page Decoding Shader Program
 
         //Helpers
         static constexpr auto DEFAULT_HRES = 256.0f;
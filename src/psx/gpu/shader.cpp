@@ -79,6 +79,23 @@ Shader::Shader(const GLchar* vertexSourcePath, const GLchar* fragmentSourcePath)
     //Delete shader
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    //Resolve Uniform Locations once, setters look them up here instead of asking the driver by name.
+    //Uniform Block members have no location and are not cached
+    GLint uniformCount = 0;
+    GLchar uniformName[256];
+    glGetProgramiv(this->programId, GL_ACTIVE_UNIFORMS, &uniformCount);
+    for (GLint i = 0; i < uniformCount; i++)
+    {
+        GLsizei length;
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(this->programId, i, sizeof(uniformName), &length, &size, &type, uniformName);
+
+        GLint location = glGetUniformLocation(this->programId, uniformName);
+        if (location != -1)
+            this->uniformLocations[std::string(uniformName, length)] = location;
+    }
 }
 
 void Shader::Use()
@@ -86,71 +103,78 @@ void Shader::Use()
     glUseProgram(this->programId);
 }
 
+GLint Shader::getUniformLocation(const std::string &name) const
+{
+    //Unknown names get -1, glUniform ignores it as it does for names the linker dropped
+    auto it = this->uniformLocations.find(name);
+    return (it != this->uniformLocations.end()) ? it->second : -1;
+}
+
 void Shader::setUniformb(const std::string &name, bool value) const
 {         
-    glUniform1i(glGetUniformLocation(this->programId, name.c_str()), (int)value); 
+    glUniform1i(getUniformLocation(name), (int)value); 
 }
 
 // Overloaded setUniform methods for different int types
 void Shader::setUniformi(const std::string &name, int value) const
 { 
-    glUniform1i(glGetUniformLocation(this->programId, name.c_str()), value); 
+    glUniform1i(getUniformLocation(name), value); 
 }
 
 void Shader::setUniformi(const std::string &name, const glm::ivec2& value) const
 { 
-    glUniform2i(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y); 
+    glUniform2i(getUniformLocation(name), value.x, value.y); 
 }
 
 void Shader::setUniformi(const std::string &name, const glm::ivec3& value) const
 { 
-    glUniform3i(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y, value.z); 
+    glUniform3i(getUniformLocation(name), value.x, value.y, value.z); 
 }
 
 void Shader::setUniformi(const std::string &name, const glm::ivec4& value) const
 { 
-    glUniform4i(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y, value.z, value.w); 
+    glUniform4i(getUniformLocation(name), value.x, value.y, value.z, value.w); 
 }
 
 // Overloaded setUniform methods for different unsigned int types
 void Shader::setUniformui(const std::string &name, unsigned int value) const
 { 
-    glUniform1ui(glGetUniformLocation(this->programId, name.c_str()), value); 
+    glUniform1ui(getUniformLocation(name), value); 
 }
 
 void Shader::setUniformui(const std::string &name, const glm::uvec2& value) const
 { 
-    glUniform2ui(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y); 
+    glUniform2ui(getUniformLocation(name), value.x, value.y); 
 }
 
 void Shader::setUniformui(const std::string &name, const glm::uvec3& value) const
 { 
-    glUniform3ui(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y, value.z); 
+    glUniform3ui(getUniformLocation(name), value.x, value.y, value.z); 
 }
 
 void Shader::setUniformui(const std::string &name, const glm::uvec4& value) const
 { 
-    glUniform4ui(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y, value.z, value.w); 
+    glUniform4ui(getUniformLocation(name), value.x, value.y, value.z, value.w); 
 }
 
 // Overloaded setUniform methods for different float types
 void Shader::setUniform(const std::string &name, float value) const
 { 
-    glUniform1f(glGetUniformLocation(this->programId, name.c_str()), value); 
+    glUniform1f(getUniformLocation(name), value); 
 }
 
 void Shader::setUniform(const std::string &name, const glm::vec2 &value) const
 { 
-    glUniform2f(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y); 
+    glUniform2f(getUniformLocation(name), value.x, value.y); 
 } 
 
 void Shader::setUniform(const std::string &name, const glm::vec3 &value) const
 { 
-    glUniform3f(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y, value.z); 
+    glUniform3f(getUniformLocation(name), value.x, value.y, value.z); 
 } 
 
 void Shader::setUniform(const std::string &name, const glm::vec4 &value) const
 { 
-    glUniform4f(glGetUniformLocation(this->programId, name.c_str()), value.x, value.y, value.z, value.w); 
+    glUniform4f(getUniformLocation(name), value.x, value.y, value.z, value.w); 
 } 
 
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
 
 #include "GL/glew.h"
 #include "glm/glm.hpp"
@@ -14,6 +15,8 @@ class Shader
         Shader(const GLchar* vertexSourcePath, const GLchar* fragmentSourcePath);
 
         void Use();
+        GLint getUniformLocation(const std::string &name) const;
+
         void setUniformb(const std::string &name, bool value) const;
         
         void setUniformi(const std::string &name, int value) const;
@@ -33,5 +36,6 @@ class Shader
 
     private:
         GLuint programId;      
+        std::unordered_map<std::string, GLint> uniformLocations;   //Active Uniform Locations, resolved once after linking
 };
 
@@ -18,35 +18,45 @@ layout(location = 0) out uvec4 outColor;   // RGB555 + mask bit
 // Uniforms (PSX GPU state)
 // ------------------------------------------------------------
 
-// VRAM as integer texture (GL_R16UI)
-uniform usampler2D uVRAM;
+// VRAM as integer texture (GL_R16UI), bound to texture unit 0
+layout(binding = 0) uniform usampler2D uVRAM;
 
-// Drawing area (clip rectangle)
-uniform ivec4 uDrawArea;            // x0, y0, x1, y1
-uniform bool  uDrawEnable;          // Set by renderer but not used yet, enable/disable writing inside Drawing Area    
+// Texture Cache, CLUT Texture Pages decoded to direct colors (GL_R16UI, 256x256 layers), bound to texture unit 1
+layout(binding = 1) uniform usampler2DArray uTexCache;
 
-// Texture page and CLUT
-uniform ivec2 uTPage;               // texture page base (x, y)
-uniform ivec2 uClut;                // CLUT base (x, y)
-uniform int   uTexColorMode;        // 4, 8, or 16
-uniform ivec2 uTexMask;             // UV = (UV AND (NOT (Mask*8))) OR ((Offset AND Mask)*8)
-uniform ivec2 uTexOffset;           // UV = (UV AND (NOT (Mask*8))) OR ((Offset AND Mask)*8)
+// Rendering State, std140 block shared with the vertex shader and
+// mirrored by RenderUniforms in renderer.h, keep the three in sync
+layout(std140, binding = 0) uniform RenderState
+{
+    ivec4 uDrawArea;            // x0, y0, x1, y1
+    ivec2 uDrawOffset;          // Drawing offset register
+
+    // Texture page and CLUT
+    ivec2 uTPage;               // texture page base (x, y)
+    ivec2 uClut;                // CLUT base (x, y)
+    ivec2 uTexMask;             // UV = (UV AND (NOT (Mask*8))) OR ((Offset AND Mask)*8)
+    ivec2 uTexOffset;           // UV = (UV AND (NOT (Mask*8))) OR ((Offset AND Mask)*8)
+    int   uTexColorMode;        // 4, 8, or 16
+    int   uSemiTransMode;
+    int   uTexCacheLayer;       // Texture Cache layer holding the decoded Texture Page, -1 if none
+
+    bool  uDrawEnable;          // Set by renderer but not used yet, enable/disable writing inside Drawing Area
 
-// Texture flags
-uniform bool uTextured;
-uniform bool uTexBlending;         
-uniform bool uTexDisable;
+    // Texture flags
+    bool  uTextured;
+    bool  uTexBlending;
+    bool  uTexDisable;
 
-// Semi-transparency
-uniform bool uSemiTrans;
-uniform int  uSemiTransMode;        
+    // Semi-transparency
+    bool  uSemiTrans;
 
-// Mask bit
-uniform bool uCheckMask;
-uniform bool uForceMask;
+    // Mask bit
+    bool  uCheckMask;
+    bool  uForceMask;
 
-// Dithering
-uniform bool uDither;
+    // Dithering
+    bool  uDither;
+};
 
 // ------------------------------------------------------------
 // PSX dithering matrix (4x4)
@@ -87,6 +97,10 @@ uint pack555(uvec3 c, bool mask)
 
 uint fetchTexel(ivec2 uv)
 {
+    //Decoded Texture Page, UVs outside of it keep reading VRAM
+    if (uTexCacheLayer >= 0 && all(greaterThanEqual(uv, ivec2(0))) && all(lessThan(uv, ivec2(256))))
+        return texelFetch(uTexCache, ivec3(uv, uTexCacheLayer), 0).r;
+
     uvec2 p;
     if (uTexColorMode == 2 || uTexColorMode == 3)   //Raw 1-5-5-5 format
     {
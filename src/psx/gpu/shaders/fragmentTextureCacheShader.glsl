@@ -0,0 +1,52 @@
+#version 460 core
+
+// ------------------------------------------------------------
+// Decodes a 4 or 8 bit Texture Page through its CLUT into one
+// 256x256 layer of the Texture Cache, texel (u, v) is the
+// direct color the Render Shader would fetch for UV (u, v)
+// ------------------------------------------------------------
+
+layout(location = 0) out uvec4 outColor;
+
+// VRAM as integer texture (GL_R16UI), bound to texture unit 0
+layout(binding = 0) uniform usampler2D uVRAM;
+
+// Texture page and CLUT
+uniform ivec2 uTPage;               // texture page base (x, y)
+uniform ivec2 uClut;                // CLUT base (x, y)
+uniform int   uTexColorMode;        // 0 = CLUT 4bit, 1 = CLUT 8bit
+
+// ------------------------------------------------------------
+// Texture fetch, same as the CLUT paths of fragmentRenderShader
+// ------------------------------------------------------------
+
+uint fetchTexel(ivec2 uv)
+{
+    uvec2 p;
+    if (uTexColorMode == 1)                         //CLUT 8bit
+    {
+        p = uTPage + uvec2(uv.x / 2, uv.y);
+        uint w = texelFetch(uVRAM, ivec2(p.x, p.y), 0).r;
+        uint idx = (uv.x & 1) == 0 ? (w & 0xffu) : (w >> 8);
+        p = uClut + uvec2(int(idx), 0);
+        return texelFetch(uVRAM, ivec2(p.x, p.y), 0).r;
+    }
+    else                                            //CLUT 4bit
+    {
+        p = uTPage + ivec2(uv.x / 4, uv.y);
+        uint w = texelFetch(uVRAM, ivec2(p.x, p.y), 0).r;
+        uint shift = uint((uv.x & 3) * 4);
+        uint idx = (w >> shift) & 0x0fu;
+        p = uClut + uvec2(int(idx), 0);
+        return texelFetch(uVRAM, ivec2(p.x, p.y), 0).r;
+    }
+}
+
+// ------------------------------------------------------------
+// MAIN
+// ------------------------------------------------------------
+
+void main()
+{
+    outColor = uvec4(fetchTexel(ivec2(gl_FragCoord.xy)), 0u, 0u, 1u);
+}
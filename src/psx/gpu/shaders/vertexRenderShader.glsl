@@ -13,11 +13,28 @@ layout(location = 2) in vec2 aUV;        // Texture UV in VRAM space (pixel coor
 // Uniforms (PSX GPU state)
 // ------------------------------------------------------------
 
-// Drawing offset register
-uniform ivec2 uDrawOffset;
-
-// Drawing area (clip rectangle)
-//uniform ivec4 uDrawArea; // x0, y0, x1, y1 NOT USED HERE
+// Rendering State, same std140 block as the fragment shader, only the
+// drawing offset register is used here
+layout(std140, binding = 0) uniform RenderState
+{
+    ivec4 uDrawArea;
+    ivec2 uDrawOffset;
+    ivec2 uTPage;
+    ivec2 uClut;
+    ivec2 uTexMask;
+    ivec2 uTexOffset;
+    int   uTexColorMode;
+    int   uSemiTransMode;
+    int   uTexCacheLayer;
+    bool  uDrawEnable;
+    bool  uTextured;
+    bool  uTexBlending;
+    bool  uTexDisable;
+    bool  uSemiTrans;
+    bool  uCheckMask;
+    bool  uForceMask;
+    bool  uDither;
+};
 
 // ------------------------------------------------------------
 // Outputs to fragment shader
@@ -1,4 +1,5 @@
 #include <loguru.hpp>
+#include <cstdlib>
 #include "psxemu.h"
 
 constexpr auto DEFAULT_SCREEN_WIDTH = 1024;
@@ -14,7 +15,19 @@ int main(int argc, char* argv[])
     //loguru::add_file("debug.log", loguru::Truncate, 2);
 
     if (!commandline::instance().parse(argc, argv))
-        return 0;
+        return commandline::instance().isHeadless() ? EXIT_FAILURE : 0;
+
+    //Headless Mode, exit status reports the outcome of the run
+    if (commandline::instance().isHeadless())
+    {
+        if (!emu.initHeadless())
+        {
+            LOG_F(ERROR, "Failed to Initialize PSX Emulator in Headless Mode!\n");
+            return EXIT_FAILURE;
+        }
+
+        return emu.runHeadless(commandline::instance().getFrames()) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
         
     if (!emu.init(DEFAULT_SCREEN_WIDTH, DEFAULT_SCREEN_HEIGHT))
     {
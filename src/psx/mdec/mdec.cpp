@@ -0,0 +1,594 @@
+#include <loguru.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "mdec.h"
+#include "profiler.h"
+#include "psx.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MDEC_SSE2
+#endif
+
+//Natural (row major) position of each Coefficient in Zigzag order
+constexpr uint8_t zigzag[MDEC_BLOCK_SIZE] = {
+	 0,  1,  8, 16,  9,  2,  3, 10,
+	17, 24, 32, 25, 18, 11,  4,  5,
+	12, 19, 26, 33, 40, 48, 41, 34,
+	27, 20, 13,  6,  7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36,
+	29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46,
+	53, 60, 61, 54, 47, 55, 62, 63
+};
+
+//IDCT Rounding, the column pass keeps 15 bits of the 32 bits scale so the row pass products still fit 32 bits
+constexpr int IDCT_COLUMN_SHIFT = 15;
+constexpr int IDCT_ROW_SHIFT = 17;
+
+static inline int32_t signed10(uint16_t value)
+{
+	return static_cast<int32_t>(static_cast<int16_t>(value << 6)) >> 6;
+}
+
+static inline int16_t saturate16(int32_t value)
+{
+	return static_cast<int16_t>(std::clamp(value, -0x8000, 0x7fff));
+}
+
+static inline int32_t clamp8(int32_t value)
+{
+	return std::clamp(value, -0x80, 0x7f);
+}
+
+MDEC::MDEC()
+{
+	psx = nullptr;
+	reset();
+}
+
+MDEC::~MDEC()
+{
+}
+
+bool MDEC::reset()
+{
+	inputEnabled = false;
+	outputEnabled = false;
+	currentCommand = 0x0;
+	remaining = 0;
+	parameters.clear();
+	output.clear();
+	outputPos = 0;
+	currentBlock = 4;
+
+	memset(quantLuma, 0x00, sizeof(quantLuma));
+	memset(quantChroma, 0x00, sizeof(quantChroma));
+
+	//Standard IDCT Matrix, the one uploaded by the BIOS and the libraries (5A82h, 7D8Ah, ...)
+	for (int u = 0; u < 8; u++)
+	{
+		for (int x = 0; x < 8; x++)
+		{
+			double c = (u == 0) ? std::sqrt(0.5) : std::cos((2 * x + 1) * u * 3.14159265358979323846 / 16.0);
+			scaleTable[u * 8 + x] = static_cast<int16_t>(std::lround(c * 0x8000));
+		}
+	}
+	setScaleTable();
+
+	return true;
+}
+
+bool MDEC::serialize(SaveState& state)
+{
+	state.section("MDEC");
+
+	//Registers and Command being received
+	state.value(inputEnabled);
+	state.value(outputEnabled);
+	state.value(currentCommand);
+	state.value(remaining);
+	state.vector(parameters);
+
+	//Tables
+	state.value(quantLuma);
+	state.value(quantChroma);
+	state.value(scaleTable);
+
+	//Decoded Pixels
+	state.vector(output);
+	state.value(outputPos);
+	state.value(currentBlock);
+
+	if (state.isLoading())
+	{
+		outputPos = std::min(outputPos, output.size());
+		setScaleTable();
+	}
+
+	return state.isValid();
+}
+
+bool MDEC::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
+{
+	switch (addr)
+	{
+	case 0x1f801820:	//MDEC Command/Parameter Register
+		writeData(std::span<const uint32_t>(&data, 1));
+		break;
+
+	case 0x1f801824:	//MDEC Control/Reset Register
+		if (data & 0x80000000)
+		{
+			//Abort any Command and set Status to 80040000h, the Tables are kept
+			currentCommand = 0x0;
+			remaining = 0;
+			parameters.clear();
+			output.clear();
+			outputPos = 0;
+			currentBlock = 4;
+		}
+		inputEnabled = data & 0x40000000;
+		outputEnabled = data & 0x20000000;
+		break;
+
+	default:
+		LOG_F(ERROR, "MDEC - Unknown Parameter Set addr: 0x%08x (%d), data: 0x%08x", addr, bytes, data);
+		return false;
+	}
+
+	LOG_F(3, "MDEC - Write to Register:\t\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
+	return true;
+}
+
+uint32_t MDEC::readAddr(uint32_t addr, uint8_t bytes)
+{
+	uint32_t data = 0;
+	mdec::status status;
+
+	switch (addr)
+	{
+	case 0x1f801820:	//MDEC Data/Response Register
+		readData(std::span<uint32_t>(&data, 1));
+		break;
+
+	case 0x1f801824:	//MDEC Status Register
+		status.word = 0;
+		status.remaining = remaining - 1;
+		status.currentBlock = currentBlock;
+		status.bit15 = (bool)(currentCommand & 0x02000000);
+		status.outputSigned = (bool)(currentCommand & 0x04000000);
+		status.outputDepth = (currentCommand >> 27) & 0x3;
+		status.dataOutRequest = outputEnabled && getOutputWords() > 0;
+		status.dataInRequest = inputEnabled;
+		status.commandBusy = remaining > 0;
+		status.dataOutEmpty = getOutputWords() == 0;
+		data = status.word;
+		break;
+
+	default:
+		LOG_F(ERROR, "MDEC - Unknown Parameter Get addr: 0x%08x (%d)", addr, bytes);
+		return 0x0;
+	}
+
+	LOG_F(3, "MDEC - Read from Register:\t\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
+	return data;
+}
+
+bool MDEC::writeData(std::span<const uint32_t> data)
+{
+	size_t i = 0;
+
+	while (i < data.size())
+	{
+		if (remaining == 0)
+		{
+			command(data[i++]);
+			continue;
+		}
+
+		//Parameters are collected in bulk, the Command runs once all of them are in
+		size_t count = std::min<size_t>(remaining, data.size() - i);
+		parameters.insert(parameters.end(), data.begin() + i, data.begin() + i + count);
+		remaining -= static_cast<uint32_t>(count);
+		i += count;
+
+		if (remaining == 0)
+			execute();
+	}
+
+	return true;
+}
+
+bool MDEC::readData(std::span<uint32_t> data)
+{
+	size_t count = std::min<size_t>(data.size(), getOutputWords());
+
+	std::copy(output.begin() + outputPos, output.begin() + outputPos + count, data.begin());
+	std::fill(data.begin() + count, data.end(), 0);
+	outputPos += count;
+
+	//Drop the FIFO storage once it has been drained
+	if (outputPos == output.size())
+	{
+		output.clear();
+		outputPos = 0;
+	}
+
+	return count == data.size();
+}
+
+void MDEC::command(uint32_t word)
+{
+	currentCommand = word;
+	parameters.clear();
+
+	switch (word >> 29)
+	{
+	case 1:		//Decode Macroblocks, number of Parameter Words in the low half
+		remaining = word & 0xffff;
+		break;
+	case 2:		//Set Quant Tables, Luminance only or Luminance and Color
+		remaining = (word & 0x1) ? 32 : 16;
+		break;
+	case 3:		//Set Scale Table
+		remaining = 32;
+		break;
+
+	default:
+		LOG_F(2, "MDEC - Ignored Command: 0x%08x", word);
+		remaining = 0;
+		break;
+	}
+
+	if (remaining == 0)
+		execute();
+}
+
+void MDEC::execute()
+{
+	switch (currentCommand >> 29)
+	{
+	case 1:
+		decodeMacroblocks();
+		break;
+
+	case 2:
+		memcpy(quantLuma, parameters.data(), sizeof(quantLuma));
+		if (currentCommand & 0x1)
+			memcpy(quantChroma, parameters.data() + sizeof(quantLuma) / sizeof(uint32_t), sizeof(quantChroma));
+		break;
+
+	case 3:
+		memcpy(scaleTable, parameters.data(), sizeof(scaleTable));
+		setScaleTable();
+		break;
+
+	default:
+		break;
+	}
+
+	parameters.clear();
+}
+
+void MDEC::setScaleTable()
+{
+	for (int k = 0; k < 4; k++)
+	{
+		for (int y = 0; y < 8; y++)
+		{
+			int16_t* column = &idctColumn[y >> 1][k][(y & 1) * 8];
+			for (int i = 0; i < 8; i += 2)
+			{
+				column[i] = scaleTable[(2 * k) * 8 + y];
+				column[i + 1] = scaleTable[(2 * k + 1) * 8 + y];
+			}
+		}
+
+		for (int x = 0; x < 8; x++)
+		{
+			idctRow[k][x * 2] = scaleTable[(2 * k) * 8 + x];
+			idctRow[k][x * 2 + 1] = scaleTable[(2 * k + 1) * 8 + x];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------
+//
+//                               M A C R O B L O C K S
+//
+//-----------------------------------------------------------------------------------------------------
+void MDEC::decodeMacroblocks()
+{
+	PROFILE_ZONE(ProfileZone::Mdec);
+
+	const uint16_t* src = reinterpret_cast<const uint16_t*>(parameters.data());
+	const uint16_t* end = src + parameters.size() * 2;
+	mdec::Depth depth = static_cast<mdec::Depth>((currentCommand >> 27) & 0x3);
+	bool color = (depth == mdec::Depth::Bit24 || depth == mdec::Depth::Bit15);
+
+	//Cr, Cb and Y1..Y4 of a color Macroblock, or a single Y Block in monochrome
+	alignas(32) int16_t blocks[6][MDEC_BLOCK_SIZE];
+
+	//Whole Macroblocks only, a truncated one at the end of the data is dropped
+	while (src < end)
+	{
+		if (color)
+		{
+			bool complete = decodeBlock(src, end, quantChroma, blocks[0])
+				&& decodeBlock(src, end, quantChroma, blocks[1])
+				&& decodeBlock(src, end, quantLuma, blocks[2])
+				&& decodeBlock(src, end, quantLuma, blocks[3])
+				&& decodeBlock(src, end, quantLuma, blocks[4])
+				&& decodeBlock(src, end, quantLuma, blocks[5]);
+			if (!complete)
+				break;
+
+			outputColor(blocks[0], blocks[1], blocks[2]);
+		}
+		else
+		{
+			if (!decodeBlock(src, end, quantLuma, blocks[0]))
+				break;
+
+			outputMono(blocks[0]);
+		}
+	}
+
+	currentBlock = 4;
+}
+
+// Run Length decoding and dequantization of one 8x8 Block, followed by the IDCT. The first halfword holds
+// the Quantization Scale and the DC value, then each halfword skips a run of zeroes and sets the next
+// Coefficient. FE00h ends the Block (and pads the data in between Blocks).
+bool MDEC::decodeBlock(const uint16_t*& src, const uint16_t* end, const uint8_t* quant, int16_t* blk)
+{
+	while (src < end && *src == 0xfe00)
+		src++;
+	if (src >= end)
+		return false;
+
+	memset(blk, 0x00, MDEC_BLOCK_SIZE * sizeof(int16_t));
+
+	uint16_t n = *src++;
+	int32_t scale = n >> 10;
+	int32_t value = (scale == 0) ? signed10(n) * 2 : signed10(n) * quant[0];
+	uint32_t k = 0;
+
+	while (true)
+	{
+		//Quantization Scale 0 stores the Coefficients in natural order, without Quant Table
+		blk[(scale == 0) ? k : zigzag[k]] = static_cast<int16_t>(std::clamp(value, -0x400, 0x3ff));
+
+		if (src >= end)
+			return false;
+
+		n = *src++;
+		k += (n >> 10) + 1;
+		if (k >= MDEC_BLOCK_SIZE)
+			break;
+
+		value = (scale == 0) ? signed10(n) * 2 : (signed10(n) * quant[k] * scale + 4) / 8;
+	}
+
+	idct(blk);
+	return true;
+}
+
+// Inverse DCT as two 8x8 matrix products with the Scale Table S: blk = (S' * blk * S) >> 32, split in
+// a column pass rounded to 15 bits and a row pass rounded to the remaining 17. Every path gives the
+// same results, pairs of 16 bits Coefficients are multiplied and added in 32 bits (_mm_madd_epi16).
+void MDEC::idct(int16_t* blk)
+{
+#if defined(__AVX2__)
+	alignas(32) int16_t tmp[MDEC_BLOCK_SIZE];
+	const __m128i* in = reinterpret_cast<const __m128i*>(blk);
+
+	//Column Pass, tmp[y][x] = sum(S[u][y] * blk[u][x]), two rows of tmp at a time
+	__m256i pairsLo[4], pairsHi[4];
+	for (int k = 0; k < 4; k++)
+	{
+		__m128i r0 = _mm_load_si128(in + 2 * k);
+		__m128i r1 = _mm_load_si128(in + 2 * k + 1);
+		pairsLo[k] = _mm256_broadcastsi128_si256(_mm_unpacklo_epi16(r0, r1));
+		pairsHi[k] = _mm256_broadcastsi128_si256(_mm_unpackhi_epi16(r0, r1));
+	}
+
+	const __m256i roundColumn = _mm256_set1_epi32(1 << (IDCT_COLUMN_SHIFT - 1));
+	for (int y = 0; y < 8; y += 2)
+	{
+		__m256i sumLo = roundColumn;
+		__m256i sumHi = roundColumn;
+		for (int k = 0; k < 4; k++)
+		{
+			__m256i c = _mm256_load_si256(reinterpret_cast<const __m256i*>(idctColumn[y >> 1][k]));
+			sumLo = _mm256_add_epi32(sumLo, _mm256_madd_epi16(pairsLo[k], c));
+			sumHi = _mm256_add_epi32(sumHi, _mm256_madd_epi16(pairsHi[k], c));
+		}
+
+		//Lanes hold rows y and y + 1, packing within the lanes puts x = 0..7 back in order
+		__m256i rows = _mm256_packs_epi32(_mm256_srai_epi32(sumLo, IDCT_COLUMN_SHIFT), _mm256_srai_epi32(sumHi, IDCT_COLUMN_SHIFT));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(tmp + y * 8), rows);
+	}
+
+	//Row Pass, blk[y][x] = sum(tmp[y][u] * S[u][x]), two rows at a time
+	const __m256i roundRow = _mm256_set1_epi32(1 << (IDCT_ROW_SHIFT - 1));
+	__m256i scaleLo[4], scaleHi[4];
+	for (int k = 0; k < 4; k++)
+	{
+		scaleLo[k] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(idctRow[k])));
+		scaleHi[k] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(idctRow[k] + 8)));
+	}
+
+	for (int y = 0; y < 8; y += 2)
+	{
+		__m256i rows = _mm256_load_si256(reinterpret_cast<const __m256i*>(tmp + y * 8));
+		__m256i p0 = _mm256_shuffle_epi32(rows, 0x00);
+		__m256i p1 = _mm256_shuffle_epi32(rows, 0x55);
+		__m256i p2 = _mm256_shuffle_epi32(rows, 0xaa);
+		__m256i p3 = _mm256_shuffle_epi32(rows, 0xff);
+
+		__m256i sumLo = _mm256_add_epi32(_mm256_add_epi32(_mm256_madd_epi16(p0, scaleLo[0]), _mm256_madd_epi16(p1, scaleLo[1])),
+										 _mm256_add_epi32(_mm256_madd_epi16(p2, scaleLo[2]), _mm256_madd_epi16(p3, scaleLo[3])));
+		__m256i sumHi = _mm256_add_epi32(_mm256_add_epi32(_mm256_madd_epi16(p0, scaleHi[0]), _mm256_madd_epi16(p1, scaleHi[1])),
+										 _mm256_add_epi32(_mm256_madd_epi16(p2, scaleHi[2]), _mm256_madd_epi16(p3, scaleHi[3])));
+		sumLo = _mm256_srai_epi32(_mm256_add_epi32(sumLo, roundRow), IDCT_ROW_SHIFT);
+		sumHi = _mm256_srai_epi32(_mm256_add_epi32(sumHi, roundRow), IDCT_ROW_SHIFT);
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(blk + y * 8), _mm256_packs_epi32(sumLo, sumHi));
+	}
+#elif defined(MDEC_SSE2)
+	alignas(16) int16_t tmp[MDEC_BLOCK_SIZE];
+	const __m128i* in = reinterpret_cast<const __m128i*>(blk);
+
+	//Column Pass, tmp[y][x] = sum(S[u][y] * blk[u][x])
+	__m128i pairsLo[4], pairsHi[4];
+	for (int k = 0; k < 4; k++)
+	{
+		__m128i r0 = _mm_load_si128(in + 2 * k);
+		__m128i r1 = _mm_load_si128(in + 2 * k + 1);
+		pairsLo[k] = _mm_unpacklo_epi16(r0, r1);
+		pairsHi[k] = _mm_unpackhi_epi16(r0, r1);
+	}
+
+	const __m128i roundColumn = _mm_set1_epi32(1 << (IDCT_COLUMN_SHIFT - 1));
+	for (int y = 0; y < 8; y++)
+	{
+		__m128i sumLo = roundColumn;
+		__m128i sumHi = roundColumn;
+		for (int k = 0; k < 4; k++)
+		{
+			__m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(&idctColumn[y >> 1][k][(y & 1) * 8]));
+			sumLo = _mm_add_epi32(sumLo, _mm_madd_epi16(pairsLo[k], c));
+			sumHi = _mm_add_epi32(sumHi, _mm_madd_epi16(pairsHi[k], c));
+		}
+
+		__m128i row = _mm_packs_epi32(_mm_srai_epi32(sumLo, IDCT_COLUMN_SHIFT), _mm_srai_epi32(sumHi, IDCT_COLUMN_SHIFT));
+		_mm_store_si128(reinterpret_cast<__m128i*>(tmp + y * 8), row);
+	}
+
+	//Row Pass, blk[y][x] = sum(tmp[y][u] * S[u][x])
+	const __m128i roundRow = _mm_set1_epi32(1 << (IDCT_ROW_SHIFT - 1));
+	__m128i scaleLo[4], scaleHi[4];
+	for (int k = 0; k < 4; k++)
+	{
+		scaleLo[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(idctRow[k]));
+		scaleHi[k] = _mm_load_si128(reinterpret_cast<const __m128i*>(idctRow[k] + 8));
+	}
+
+	for (int y = 0; y < 8; y++)
+	{
+		__m128i row = _mm_load_si128(reinterpret_cast<const __m128i*>(tmp + y * 8));
+		__m128i p0 = _mm_shuffle_epi32(row, 0x00);
+		__m128i p1 = _mm_shuffle_epi32(row, 0x55);
+		__m128i p2 = _mm_shuffle_epi32(row, 0xaa);
+		__m128i p3 = _mm_shuffle_epi32(row, 0xff);
+
+		__m128i sumLo = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(p0, scaleLo[0]), _mm_madd_epi16(p1, scaleLo[1])),
+									  _mm_add_epi32(_mm_madd_epi16(p2, scaleLo[2]), _mm_madd_epi16(p3, scaleLo[3])));
+		__m128i sumHi = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(p0, scaleHi[0]), _mm_madd_epi16(p1, scaleHi[1])),
+									  _mm_add_epi32(_mm_madd_epi16(p2, scaleHi[2]), _mm_madd_epi16(p3, scaleHi[3])));
+		sumLo = _mm_srai_epi32(_mm_add_epi32(sumLo, roundRow), IDCT_ROW_SHIFT);
+		sumHi = _mm_srai_epi32(_mm_add_epi32(sumHi, roundRow), IDCT_ROW_SHIFT);
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(blk + y * 8), _mm_packs_epi32(sumLo, sumHi));
+	}
+#else
+	int16_t tmp[MDEC_BLOCK_SIZE];
+
+	//Sums wrap around in 32 bits like the SIMD ones
+	for (int y = 0; y < 8; y++)
+	{
+		for (int x = 0; x < 8; x++)
+		{
+			uint32_t sum = 1 << (IDCT_COLUMN_SHIFT - 1);
+			for (int u = 0; u < 8; u++)
+				sum += static_cast<uint32_t>(scaleTable[u * 8 + y] * blk[u * 8 + x]);
+			tmp[y * 8 + x] = saturate16(static_cast<int32_t>(sum) >> IDCT_COLUMN_SHIFT);
+		}
+	}
+
+	for (int y = 0; y < 8; y++)
+	{
+		for (int x = 0; x < 8; x++)
+		{
+			uint32_t sum = 1 << (IDCT_ROW_SHIFT - 1);
+			for (int u = 0; u < 8; u++)
+				sum += static_cast<uint32_t>(tmp[y * 8 + u] * scaleTable[u * 8 + x]);
+			blk[y * 8 + x] = saturate16(static_cast<int32_t>(sum) >> IDCT_ROW_SHIFT);
+		}
+	}
+#endif
+}
+
+// YUV to RGB of a 16x16 Macroblock, Cr and Cb are shared by 2x2 Pixels. Output in 24 bits (R, G, B bytes)
+// or 15 bits (BGR555 halfwords), the signed results are moved to unsigned unless the Command asks otherwise.
+void MDEC::outputColor(const int16_t* cr, const int16_t* cb, const int16_t* y)
+{
+	uint8_t flip = (currentCommand & 0x04000000) ? 0x00 : 0x80;
+	uint16_t bit15 = (currentCommand & 0x02000000) ? 0x8000 : 0x0000;
+	bool depth24 = static_cast<mdec::Depth>((currentCommand >> 27) & 0x3) == mdec::Depth::Bit24;
+
+	alignas(4) uint8_t rgb[16 * 16 * 3];
+	alignas(4) uint16_t bgr[16 * 16];
+
+	for (int py = 0; py < 16; py++)
+	{
+		const int16_t* luma = y + ((py >> 3) * 2) * MDEC_BLOCK_SIZE + (py & 7) * 8;
+		const int16_t* chromaR = cr + (py >> 1) * 8;
+		const int16_t* chromaB = cb + (py >> 1) * 8;
+
+		for (int px = 0; px < 16; px++)
+		{
+			//Y2 and Y4 are on the right half
+			int32_t l = luma[(px >> 3) * MDEC_BLOCK_SIZE + (px & 7)];
+			int32_t r = chromaR[px >> 1];
+			int32_t b = chromaB[px >> 1];
+
+			//R = 1.402 * Cr, G = -0.3437 * Cb - 0.7143 * Cr, B = 1.772 * Cb in 8 bits fixed point
+			uint8_t red = static_cast<uint8_t>(clamp8(l + ((r * 359) >> 8))) ^ flip;
+			uint8_t green = static_cast<uint8_t>(clamp8(l + ((-b * 88 - r * 183) >> 8))) ^ flip;
+			uint8_t blue = static_cast<uint8_t>(clamp8(l + ((b * 454) >> 8))) ^ flip;
+
+			int i = py * 16 + px;
+			if (depth24)
+			{
+				rgb[i * 3] = red;
+				rgb[i * 3 + 1] = green;
+				rgb[i * 3 + 2] = blue;
+			}
+			else
+				bgr[i] = bit15 | ((blue >> 3) << 10) | ((green >> 3) << 5) | (red >> 3);
+		}
+	}
+
+	size_t words = depth24 ? sizeof(rgb) / sizeof(uint32_t) : sizeof(bgr) / sizeof(uint32_t);
+	size_t start = output.size();
+	output.resize(start + words);
+	memcpy(output.data() + start, depth24 ? static_cast<const void*>(rgb) : static_cast<const void*>(bgr), words * sizeof(uint32_t));
+}
+
+// Monochrome 8x8 Block, 8 bits or 4 bits (low nibble first) per Pixel
+void MDEC::outputMono(const int16_t* y)
+{
+	uint8_t flip = (currentCommand & 0x04000000) ? 0x00 : 0x80;
+	bool depth8 = static_cast<mdec::Depth>((currentCommand >> 27) & 0x3) == mdec::Depth::Bit8;
+
+	alignas(4) uint8_t pixels[MDEC_BLOCK_SIZE];
+	for (int i = 0; i < MDEC_BLOCK_SIZE; i++)
+		pixels[i] = static_cast<uint8_t>(clamp8(y[i])) ^ flip;
+
+	if (!depth8)
+	{
+		for (int i = 0; i < MDEC_BLOCK_SIZE / 2; i++)
+			pixels[i] = (pixels[i * 2] >> 4) | (pixels[i * 2 + 1] & 0xf0);
+	}
+
+	size_t words = (depth8 ? MDEC_BLOCK_SIZE : MDEC_BLOCK_SIZE / 2) / sizeof(uint32_t);
+	size_t start = output.size();
+	output.resize(start + words);
+	memcpy(output.data() + start, pixels, words * sizeof(uint32_t));
+}
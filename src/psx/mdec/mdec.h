@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <span>
+
+#include "litelib.h"
+#include "savestate.h"
+
+//MDEC Constant Definitions
+constexpr auto MDEC_BLOCK_SIZE		= 64;			//8x8 Coefficients or Pixels
+constexpr auto MDEC_STATUS_RESET	= 0x80040000;	//Output FIFO empty, current Block Y, no Parameters left
+
+namespace mdec
+{
+	union status
+	{
+		uint32_t		word;
+
+		lite::bitfield<0, 16>	remaining;			//Number of Parameter Words remaining minus 1 (FFFFh=None)
+		lite::bitfield<16, 3>	currentBlock;		//Current Block (0..3=Y1..Y4, 4=Cr, 5=Cb) (or for mono: always 4=Y)
+		lite::bitfield<23, 1>	bit15;				//Data Output Bit15 (0=Clear, 1=Set) (for 15bit depth only)
+		lite::bitfield<24, 1>	outputSigned;		//Data Output Signed (0=Unsigned, 1=Signed)
+		lite::bitfield<25, 2>	outputDepth;		//Data Output Depth (0=4bit, 1=8bit, 2=24bit, 3=15bit)
+		lite::bitfield<27, 1>	dataOutRequest;		//Data-Out Request (set when DMA1 enabled and ready to send data)
+		lite::bitfield<28, 1>	dataInRequest;		//Data-In Request (set when DMA0 enabled and ready to receive data)
+		lite::bitfield<29, 1>	commandBusy;		//Command Busy (0=Ready, 1=Busy receiving or processing parameters)
+		lite::bitfield<30, 1>	dataInFull;			//Data-In Fifo Full (0=No, 1=Full, or Last word received)
+		lite::bitfield<31, 1>	dataOutEmpty;		//Data-Out Fifo Empty (0=No, 1=Empty)
+	};
+
+	enum class Depth : uint8_t { Bit4, Bit8, Bit24, Bit15 };
+}
+
+class Psx;
+
+class MDEC
+{
+public:
+	MDEC();
+	~MDEC();
+
+	bool reset();
+	bool serialize(SaveState& state);
+
+	bool writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes);
+	uint32_t readAddr(uint32_t addr, uint8_t bytes);
+
+	//DMA Channel 0 (Commands and Parameters) and Channel 1 (Decoded Pixels) Bursts
+	bool writeData(std::span<const uint32_t> data);
+	bool readData(std::span<uint32_t> data);
+
+	//DMA Request Lines, Channel 1 moves whole Blocks only
+	bool dataOutRequest(uint32_t words) const { return outputEnabled && getOutputWords() >= words; }
+	uint32_t getOutputWords() const { return static_cast<uint32_t>(output.size() - outputPos); }
+
+	//Connect to PSX Instance
+	void link(Psx* instance) { psx = instance; }
+
+private:
+	void command(uint32_t word);
+	void parameter(uint32_t word);
+	void execute();
+	void setScaleTable();
+
+	//Macroblock Decoding
+	void decodeMacroblocks();
+	bool decodeBlock(const uint16_t*& src, const uint16_t* end, const uint8_t* quant, int16_t* blk);
+	void idct(int16_t* blk);
+	void outputColor(const int16_t* cr, const int16_t* cb, const int16_t* y);
+	void outputMono(const int16_t* y);
+
+private:
+	//Link to Bus Object
+	Psx* psx;
+
+	//Control Register (0x1f801824 write)
+	bool		inputEnabled;				//Enable Data-In Request (DMA0)
+	bool		outputEnabled;				//Enable Data-Out Request (DMA1)
+
+	//Command being received (0x1f801820 write)
+	uint32_t	currentCommand;
+	uint32_t	remaining;					//Parameter Words still expected
+	std::vector<uint32_t>	parameters;
+
+	//Tables uploaded by the Commands 2 and 3
+	uint8_t		quantLuma[MDEC_BLOCK_SIZE];		//Zigzag order
+	uint8_t		quantChroma[MDEC_BLOCK_SIZE];	//Zigzag order
+	int16_t		scaleTable[MDEC_BLOCK_SIZE];	//IDCT Matrix, row major
+
+	//IDCT Coefficients rearranged for the 16 bits pairwise multiply-add (_mm_madd_epi16), rebuilt from scaleTable.
+	//Column pass: (S[2k][y], S[2k+1][y]) repeated, two output rows y side by side.
+	//Row pass: (S[2k][x], S[2k+1][x]) for x = 0..3 followed by x = 4..7
+	alignas(32) int16_t idctColumn[4][4][16];
+	alignas(32) int16_t idctRow[4][16];
+
+	//Decoded Pixels waiting for DMA1 or the CPU, consumed from outputPos on
+	std::vector<uint32_t>	output;
+	size_t		outputPos;
+	uint8_t		currentBlock;
+};
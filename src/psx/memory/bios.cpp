@@ -3,6 +3,7 @@
 
 Bios::Bios()
 {
+	loaded = false;
 }
 
 Bios::~Bios()
@@ -41,6 +42,7 @@ bool Bios::loadBios(const std::string& fileName)
 		LOG_F(INFO, "PSP Bios Patched - Enable std_io");
 #endif
 
+		loaded = true;
 		return true;
 	}
 	LOG_F(ERROR, "PSP Bios Not Found");
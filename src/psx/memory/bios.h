@@ -17,6 +17,7 @@ public:
 	~Bios();
 
 	bool loadBios(const std::string& fileName);
+	bool isLoaded() const { return loaded; }
 	
 	uint32_t read(uint32_t phAddr, uint8_t bytes = 4);
 	
@@ -28,5 +29,7 @@ public:
 private:
 	//Link to PSP Object
 	Psx* psx;
+
+	bool		loaded;
 };
 
@@ -1,5 +1,6 @@
 #include <loguru.hpp>
 #include "dma.h"
+#include "profiler.h"
 #include "psx.h"
 
 Dma::Dma()
@@ -25,6 +26,7 @@ Dma::Dma()
 	runningSize = 0;
 	runningBlockAmount = 0;
 	runningBlockSize = 0;
+	runningCycles = 0;
 }
 
 Dma::~Dma()
@@ -54,77 +56,167 @@ bool Dma::reset()
 	runningSize = 0;
 	runningBlockAmount = 0;
 	runningBlockSize = 0;
+	runningCycles = 0;
 
 	return true;
 }
 
-bool Dma::execute()
+bool Dma::serialize(SaveState& state)
 {
-	//Check if DMA is already Running
-	if (isRunning)
+	state.section("DMA ");
+	serializeSync(state);
+
+	//DMA Registers
+	state.value(dmaStatus);
+	state.value(dmaChannel);
+	state.value(dmaDpcr);
+	state.value(dmaDicr);
+
+	//Running Transfer
+	state.value(isRunning);
+	state.value(runningChannel);
+	state.value(runningAddr);
+	state.value(runningIncrement);
+	state.value(runningFromRam);
+	state.value(runningSize);
+	state.value(runningBlockAmount);
+	state.value(runningBlockSize);
+	state.value(runningSyncMode);
+	state.value(runningCycles);
+
+	return state.isValid();
+}
+
+bool Dma::dmaStart()
+{
+	//Start the highest priority pending Channel, the last one on the list sorted by DPCR
+	for (auto e = dmaStatus.rbegin(); e != dmaStatus.rend(); e++)
 	{
+		if (!e->enabled || !(bool)dmaChannel[e->channel].chanChcr.dmaStart || !isReady(e->channel))
+			continue;
+
+		isRunning = true;
+		runningChannel = e->channel;
+		runningSyncMode = (uint8_t)dmaChannel[e->channel].chanChcr.syncMode;
+
+		runningAddr = dmaChannel[e->channel].chanMadr & 0x001ffffc;
+		runningIncrement = ((bool)dmaChannel[e->channel].chanChcr.memStep) ? -4 : +4;
+		runningFromRam = (bool)dmaChannel[e->channel].chanChcr.fromRam;
+
 		switch (runningSyncMode)
 		{
 		case 0:
-			syncmode0();		//SyncMode 0 - Immediate Block Transfer
+			runningSize = dmaChannel[e->channel].chanBcr.blockSize;
+			runningSize = (runningSize == 0) ? 0x10000 : runningSize;	//Block Size 0 stands for 10000h words
+			runningBlockAmount = dmaChannel[e->channel].chanBcr.blockAmount;
+			runningBlockSize = dmaChannel[e->channel].chanBcr.blockSize;
 			break;
 		case 1:
-			syncmode1();		//SyncMode 1 - Triggered Block Transfer
+			runningSize = dmaChannel[e->channel].chanBcr.blockSize * dmaChannel[e->channel].chanBcr.blockAmount;
+			runningBlockAmount = dmaChannel[e->channel].chanBcr.blockAmount;
+			runningBlockSize = dmaChannel[e->channel].chanBcr.blockSize;
 			break;
 		case 2:
-			syncmode2();		//SyncMode 2 - Linked List
+			runningSize = 0;
+			runningBlockAmount = dmaChannel[e->channel].chanBcr.blockAmount;
+			runningBlockSize = dmaChannel[e->channel].chanBcr.blockSize;
 			break;
 
 		default:
-			LOG_F(ERROR, "DMA - Channel %d Unknown Sync Mode!", runningChannel);
-			return false;
+			break;
 		}
+		LOG_F(2, "DMA - Start Request [Channel: %d, SyncMode: %d, BlockSize: %d, BlockAmount: %d, TotalSize: %d, MemoryAddr: %08x, Increment: %d, FromMemory: %s, Chopping: %s]", 
+			      runningChannel, runningSyncMode, runningBlockSize, runningBlockAmount, runningSize, runningAddr, runningIncrement,
+			      runningFromRam ? "true" : "false", (bool)dmaChannel[runningChannel].chanChcr.chopEnable ? "true" : "false");
+		
+		//Stop CPU access to Address Bus and move the first burst
+		psx->dataBusBusy = true;
+		runningCycles = transfer();
 
 		return true;
 	}
 
-	//Check for any Active DMA Channel
-	for (auto& e : dmaStatus)
+	return false;
+}
+
+// Moves the next burst of the running transfer in one go. Returns its cost in cycles,
+// one per word plus one per Linked List header, the bus is held for that long.
+uint32_t Dma::transfer()
+{
+	switch (runningSyncMode)
 	{
-		if (e.enabled && (bool)dmaChannel[e.channel].chanChcr.dmaStart)
-		{
-			isRunning = true;
-			runningChannel = e.channel;
-			runningSyncMode = (uint8_t)dmaChannel[e.channel].chanChcr.syncMode;
+	case 0:
+		return syncmode0();		//SyncMode 0 - Immediate Block Transfer
+	case 1:
+		return syncmode1();		//SyncMode 1 - Triggered Block Transfer
+	case 2:
+		return syncmode2();		//SyncMode 2 - Linked List
 
-			runningAddr = dmaChannel[e.channel].chanMadr;
-			runningIncrement = ((bool)dmaChannel[e.channel].chanChcr.memStep) ? -4 : +4;
-			runningFromRam = (bool)dmaChannel[e.channel].chanChcr.fromRam;
+	default:
+		LOG_F(ERROR, "DMA - Channel %d Unknown Sync Mode!", runningChannel);
+		runningSize = 0;
+		return 1;
+	}
+}
 
-			switch (runningSyncMode)
-			{
-			case 0:
-				runningSize = dmaChannel[e.channel].chanBcr.blockSize;
-				runningBlockAmount = dmaChannel[e.channel].chanBcr.blockAmount;
-				runningBlockSize = dmaChannel[e.channel].chanBcr.blockSize;
-				break;
-			case 1:
-				runningSize = dmaChannel[e.channel].chanBcr.blockSize * dmaChannel[e.channel].chanBcr.blockAmount;
-				runningBlockAmount = dmaChannel[e.channel].chanBcr.blockAmount;
-				runningBlockSize = dmaChannel[e.channel].chanBcr.blockSize;
-				break;
-			case 2:
-				runningSize = 0;
-				runningBlockAmount = dmaChannel[e.channel].chanBcr.blockAmount;
-				runningBlockSize = dmaChannel[e.channel].chanBcr.blockSize;
-				break;
-
-			default:
-				break;
-			}
-			LOG_F(2, "DMA - Start Request [Channel: %d, SyncMode: %d, BlockSize: %d, BlockAmount: %d, TotalSize: %d, MemoryAddr: %08x, Increment: %d, FromMemory: %s, Chopping: %s]", 
-				      runningChannel, runningSyncMode, runningBlockSize, runningBlockAmount, runningSize, runningAddr, runningIncrement,
-				      runningFromRam ? "true" : "false", (bool)dmaChannel[runningChannel].chanChcr.chopEnable ? "true" : "false");
-			
-			//Stop CPU access to Address Bus
+bool Dma::isFinished() const
+{
+	if (runningSyncMode == 2)
+		return dmaChannel[runningChannel].chanMadr == 0x00ffffff;
+
+	return runningSize == 0;
+}
+
+bool Dma::runTicks(uint32_t cycles)
+{
+	PROFILE_ZONE(ProfileZone::Dma);
+
+	//A transfer holds the bus for the cost of each burst (DMA Window). When chopping is enabled
+	//the bus goes back to the CPU between bursts (CPU Window).
+	while (isRunning || dmaStart())
+	{
+		uint32_t elapsed = std::min(cycles, runningCycles);
+		runningCycles -= elapsed;
+		cycles -= elapsed;
+		if (runningCycles > 0)
+			break;
+
+		if (!psx->dataBusBusy)
+		{
+			//CPU Window is over
 			psx->dataBusBusy = true;
-		}	
+			runningCycles = transfer();
+		}
+		else if (isFinished())
+		{
+			LOG_F(2, "DMA - Channel %d, Syncmode %d: Stop Writing Packet %s RAM", runningChannel, runningSyncMode, runningFromRam ? "from" : "to");
+			dmaStop();
+		}
+		else if (!isReady(runningChannel))
+		{
+			//The device has nothing more to move, the Channel waits for its request with the remaining Blocks
+			LOG_F(2, "DMA - Channel %d, Syncmode %d: Waiting for Device Request", runningChannel, runningSyncMode);
+			dmaPause();
+		}
+		else if (!(bool)dmaChannel[runningChannel].chanChcr.chopEnable)
+		{
+			//Without chopping there is no CPU Window, the next burst holds the bus right away
+			runningCycles = transfer();
+		}
+		else
+		{
+			//DMA Window is over
+			psx->dataBusBusy = false;
+			runningCycles = 1 << dmaChannel[runningChannel].chanChcr.chopCpuWnd;
+		}
 	}
+
+	//Wake up at the end of the current Window
+	if (isRunning)
+		psx->scheduler->schedule(SchedulerEvent::Dma, runningCycles);
+	else
+		psx->scheduler->cancel(SchedulerEvent::Dma);
+
 	return true;
 }
 
@@ -207,167 +299,225 @@ uint32_t Dma::readAddr(uint32_t addr, uint8_t bytes)
 //------------------------------------------------------------------------------------------
 //  S Y N C M O D E 0
 //------------------------------------------------------------------------------------------
-bool Dma::syncmode0()
+uint32_t Dma::syncmode0()
 {
-	uint32_t data;
+	//Whole Block at once, or one DMA Window when chopping
+	uint32_t words = runningSize;
+	if ((bool)dmaChannel[runningChannel].chanChcr.chopEnable)
+		words = std::min<uint32_t>(words, 1 << dmaChannel[runningChannel].chanChcr.chopDmaWnd);
 
 	if (runningFromRam)
 	{
 		//TODO
 		//Sync Mode 0 should not support reading From RAM
 		LOG_F(ERROR, "DMA - Channel %d - Sync Mode 0 read from Ram not supported!", runningChannel);
-		return false;
+		runningSize = 0;
+		return 1;
 	}
-	else
+
+	buffer.resize(words);
+	switch (runningChannel)
 	{
-		switch (runningChannel)
+	case 3: //Channel 3 - Syncmode 0: CDROM - Read from CDROM Data Buffer and write to RAM
+		if (runningIncrement > 0 && runningAddr + words * sizeof(uint32_t) <= RAM_SIZE)
 		{
-		case 3: //Channel 3 - Syncmode 0: CDROM - Read 4 byte from CDROM ReadFifo and write to RAM
-			data = psx->cdrom->readAddr(0x1f801802, 1);
-			data += (psx->cdrom->readAddr(0x1f801802, 1) << 8);
-			data += (psx->cdrom->readAddr(0x1f801802, 1) << 16);
-			data += (psx->cdrom->readAddr(0x1f801802, 1) << 24);
-			LOG_F(3, "DMA - Channel 3, Syncmode 0: Copying from CDROM to RAM [0x%08x: 0x%08x]", runningAddr, data);
-			break;
-		case 6:	//Channel 6 - Syncmode 0: OTC - Reset Linked List in RAM. Linked is list is used to send rendering Command to GPU with DMA Channel 2 - Syncmode 2
-			data = (runningSize == 1) ? 0x00ffffff : (runningAddr + runningIncrement) & 0x001ffffc;
-			LOG_F(3, "DMA - Channel 6, Syncmode 0: Writing OTC to RAM [0x%08x: 0x%08x]", runningAddr, data);
-			break;
-
-		default:
-			data = 0x0;
-			LOG_F(ERROR, "DMA - Channel %d not supported in Sync Mode 0", runningChannel);
-			return false;
+			//Straight from the Sector into RAM, no intermediate buffer
+			uint32_t size = words * sizeof(uint32_t);
+			psx->cdrom->readData(std::span<uint8_t>(psx->mem->ram + runningAddr, size));
+			invalidateRam(runningAddr, size);
+
+			LOG_F(3, "DMA - Channel 3, Syncmode 0: Writing %d words to RAM [0x%08x]", words, runningAddr);
+			runningAddr = (runningAddr + size) & 0x001ffffc;
+			runningSize -= words;
+			return words;
 		}
+		psx->cdrom->readData(std::span<uint8_t>(reinterpret_cast<uint8_t*>(buffer.data()), words * sizeof(uint32_t)));
+		break;
 
-		//Write data to RAM
-		psx->mem->write(runningAddr, data);  //Write data directly to RAM
-		runningAddr = (runningAddr + runningIncrement) & 0x001ffffc;
-		runningSize--;
-
-		//Check if all data have been written
-		if (runningSize == 0)
+	case 6:	//Channel 6 - Syncmode 0: OTC - Reset Linked List in RAM. Linked is list is used to send rendering Command to GPU with DMA Channel 2 - Syncmode 2
+		for (uint32_t i = 0; i < words; i++)
 		{
-			LOG_F(2, "DMA - Channel %d, Syncmode 0: Stop Writing Packet %s RAM", runningChannel, runningFromRam ? "from" : "to");
-			dmaStop();
+			uint32_t addr = runningAddr + i * runningIncrement;
+			buffer[i] = (runningSize - i == 1) ? 0x00ffffff : (addr + runningIncrement) & 0x001ffffc;
 		}
+		break;
+
+	default:
+		LOG_F(ERROR, "DMA - Channel %d not supported in Sync Mode 0", runningChannel);
+		runningSize = 0;
+		return 1;
 	}
-	
-	return true;
+
+	LOG_F(3, "DMA - Channel %d, Syncmode 0: Writing %d words to RAM [0x%08x]", runningChannel, words, runningAddr);
+	writeRam(buffer);
+	runningSize -= words;
+
+	return words;
 }
 
 //------------------------------------------------------------------------------------------
 //  S Y N C M O D E 1
 //------------------------------------------------------------------------------------------
-bool Dma::syncmode1()
+uint32_t Dma::syncmode1()
 {
-	uint32_t data = 0;
+	uint32_t words = runningSize;
 
-	if (runningFromRam)
+	//MDEC output is produced a Macroblock at a time, move the whole Blocks that are ready
+	if (runningChannel == 1 && runningBlockSize != 0)
+		words = std::min(words, psx->mdec->getOutputWords() / runningBlockSize * runningBlockSize);
+
+	buffer.resize(words);
+	switch (runningChannel)
 	{
-		//Read data from current Address
-		data = psx->mem->read(runningAddr);
+	case 0:
+		//Channel 0 - Syncmode 1: MDEC - Read from RAM and write to MDEC Commands and Parameters
+		LOG_F(3, "DMA - Channel 0, Syncmode 1: Copying %d words to MDEC [0x%08x]", words, runningAddr);
+		readRam(buffer);
+		psx->mdec->writeData(buffer);
+		break;
+
+	case 1:
+		//Channel 1 - Syncmode 1: MDEC - Read decoded Macroblocks and write to RAM
+		LOG_F(3, "DMA - Channel 1, Syncmode 1: Copying %d words from MDEC [0x%08x]", words, runningAddr);
+		psx->mdec->readData(buffer);
+		writeRam(buffer);
+		break;
 
-		switch (runningChannel)
+	case 2:
+		LOG_F(3, "DMA - Channel 2, Syncmode 1: Copying %d words %s GPU [0x%08x]", words, runningFromRam ? "to" : "from", runningAddr);
+		if (runningFromRam)
 		{
-		case 2:	//Channel 2 - Syncmode 1: GPU - Read 4 byte from RAM and write to GPU Command and Data (Used to copy data to VRAM)
-			psx->gpu->writeAddr(0x1f801810, data); //Write to GP0
-			LOG_F(3, "DMA - Channel 2, Syncmode 1: Copying from RAM to GPU [0x%08x: 0x%08x]", runningAddr, data);
-			break;
+			//Channel 2 - Syncmode 1: GPU - Read from RAM and write to GPU Command and Data (Used to copy data to VRAM)
+			if (runningIncrement > 0 && runningAddr + words * sizeof(uint32_t) <= RAM_SIZE)
+			{
+				//Straight from RAM, no intermediate buffer
+				psx->gpu->writeGP0(std::span<const uint32_t>(reinterpret_cast<const uint32_t*>(psx->mem->ram + runningAddr), words));
+				runningAddr = (runningAddr + words * sizeof(uint32_t)) & 0x001ffffc;
+			}
+			else
+			{
+				readRam(buffer);
+				psx->gpu->writeGP0(buffer);
+			}
+		}
+		else
+		{
+			//Channel 2 - Syncmode 1: GPU - Read from GPU Command and Data and write to RAM (Used to read data from VRAM)
+			psx->gpu->readGP0(buffer);
+			writeRam(buffer);
+		}
+		break;
 
-		default:
-			LOG_F(ERROR, "DMA - Channel %d not supported in Sync Mode 0", runningChannel);
-			return false;
+	case 4:
+		LOG_F(3, "DMA - Channel 4, Syncmode 1: Copying %d words %s SPU [0x%08x]", words, runningFromRam ? "to" : "from", runningAddr);
+		if (runningFromRam)
+		{
+			//Channel 4 - Syncmode 1: SPU - Read from RAM and write to Sound RAM
+			readRam(buffer);
+			psx->spu->writeRAM(buffer);
 		}
-	}
-	else
-	{
-		switch (runningChannel)
+		else
 		{
-			case 2:	//Channel 2 - Syncmode 1: GPU - Read 4 byte from GPU Command and Data and write to RAM (Used to read data from VRAM)
-				
-				//Read data from GPU (VRAM)
-				data = psx->gpu->readAddr(0x1f801810);
-				//Write data to current Address
-				psx->mem->write(runningAddr, data);
-				LOG_F(3, "DMA - Channel 2, Syncmode 1: Copying from GPU to RAM [0x%08x] 0x%08x]", runningAddr, data);
-				break;
-			default:
-				LOG_F(ERROR, "DMA - Channel %d not supported in Sync Mode 1", runningChannel);
+			//Channel 4 - Syncmode 1: SPU - Read from Sound RAM and write to RAM
+			psx->spu->readRAM(buffer);
+			writeRam(buffer);
 		}
+		break;
+
+	default:
+		LOG_F(ERROR, "DMA - Channel %d not supported in Sync Mode 1", runningChannel);
+		runningAddr = (runningAddr + words * runningIncrement) & 0x001ffffc;
 	}
 
-	//Update Current Address and DMA Channel Registers
-	runningAddr += runningIncrement;
+	//Update DMA Channel Registers as they are at the end of the last Block moved
+	runningSize -= words;
 	dmaChannel[runningChannel].chanMadr = runningAddr;
-	if ((runningSize % dmaChannel[runningChannel].chanBcr.blockSize) == 0)
+	dmaChannel[runningChannel].chanBcr.blockAmount = (runningBlockSize != 0) ? runningSize / runningBlockSize : 0;
+
+	return std::max<uint32_t>(words, 1);
+}
+
+//------------------------------------------------------------------------------------------
+//  S Y N C M O D E 2
+//------------------------------------------------------------------------------------------
+uint32_t Dma::syncmode2()
+{
+	DmaChannel& channel = dmaChannel[runningChannel];
+	uint32_t cycles = 0;
+
+	if (!runningFromRam || runningChannel != 2)
 	{
-		dmaChannel[runningChannel].chanBcr.blockAmount--;
+		//TODO - I dont't know if we ever need to receive packet to Ram.
+		LOG_F(ERROR, "DMA - Channel %d - Sync Mode 2 %s Ram not supported!", runningChannel, runningFromRam ? "from" : "to");
+		channel.chanMadr = 0x00ffffff;	//Nothing to walk, end of the linked list
+		return 1;
 	}
-	runningSize--;
 
-	if (runningSize == 0)
+	//Whole packets at a time, up to the end of the linked list or the burst size
+	while (channel.chanMadr != 0x00ffffff && cycles < DMA_BURST_WORDS)
 	{
-		LOG_F(2, "DMA - Channel %d, Syncmode 1: Stop Writing Packet %s RAM", runningChannel, runningFromRam ? "from" : "to");
-		dmaStop();
+		//Read Linked List Header content and send the packet
+		uint32_t header = psx->mem->read(channel.chanMadr & 0x001ffffc);
+		runningSize = header >> 24;											//Size of the packet in words
+		runningAddr = (channel.chanMadr + 4) & 0x001ffffc;					//Address of the first word of the packet
+		LOG_F(3, "DMA - Channel 2, Syncmode 2: Writing Packet to GPU [Current Packet: 0x%08x, Size: %d] (Next Packet Header: 0x%08x)", channel.chanMadr, runningSize, header & 0x00ffffff);
+		channel.chanMadr = header & 0x00ffffff;								//Next Header
+
+		buffer.resize(runningSize);
+		readRam(buffer);
+		psx->gpu->writeGP0(buffer);
+
+		cycles += runningSize + 1;
+		runningSize = 0;
 	}
-		
 
-	return true;
+	return std::max<uint32_t>(cycles, 1);
 }
 
-//------------------------------------------------------------------------------------------
-//  S Y N C M O D E 2
-//------------------------------------------------------------------------------------------
-bool Dma::syncmode2()
+// RAM side of a burst, words follow the channel address step and wrap around within the 2 MB RAM
+void Dma::readRam(std::span<uint32_t> data)
 {
-	uint32_t data;
-	
-	//Check if we are finished to send packet and need to read the next header
-	if (runningSize == 0)
+	uint32_t size = static_cast<uint32_t>(data.size_bytes());
+
+	if (runningIncrement > 0 && runningAddr + size <= RAM_SIZE)
 	{
-		//Check if we are at the end of the linked list
-		if (dmaChannel[runningChannel].chanMadr == 0x00ffffff)
-		{
-			LOG_F(2, "DMA - Channel %d, Syncmode 2: Stop Writing Packet %s RAM", runningChannel, runningFromRam ? "from" : "to");
-			dmaStop();
-			return true;
-		}
+		std::memcpy(data.data(), psx->mem->ram + runningAddr, size);
+		runningAddr = (runningAddr + size) & 0x001ffffc;
+		return;
+	}
 
-		//Read Linked List Header content and prepare to send packets
-		data = psx->mem->read(dmaChannel[runningChannel].chanMadr);					//Read from Channel Base Address the Header of the linked list
-		runningSize = data >> 24;													//Extract the size of the packet in words
-		runningAddr = (dmaChannel[runningChannel].chanMadr + 4) & 0x001ffffc;		//Contains address of the first word of the packet
-		LOG_F(3, "DMA - Channel 2, Syncmode 2: Start Writing Packet to GPU [Current Packet: 0x%08x, Size: %d] (Next Packet Header: 0x%08x)", dmaChannel[runningChannel].chanMadr, runningSize, data &0x00ffffff);
-		
-		dmaChannel[runningChannel].chanMadr = data & 0x00ffffff;					//Update Channel Base Address to point the next Header
+	for (uint32_t& word : data)
+	{
+		std::memcpy(&word, psx->mem->ram + runningAddr, sizeof(word));
+		runningAddr = (runningAddr + runningIncrement) & 0x001ffffc;
 	}
-	else
+}
+
+void Dma::writeRam(std::span<const uint32_t> data)
+{
+	uint32_t size = static_cast<uint32_t>(data.size_bytes());
+
+	if (runningIncrement > 0 && runningAddr + size <= RAM_SIZE)
 	{
-		if (runningFromRam)
-		{
-			switch (runningChannel)
-			{
-			case 2:	//Channel 2 - Syncmode 2: GPU - Read from Linked List write to GPU (Used for Rendering Command)
-				data = psx->mem->read(runningAddr);
-				LOG_F(3, "DMA - Channel 2, Syncmode 2: Copying Linked List from RAM to GPU [0x%08x : 0x%08x]", runningAddr, data);
-				psx->gpu->writeAddr(0x1f801810, data); //Write to GP0
-				runningAddr = (runningAddr + runningIncrement) & 0x001ffffc; 
-				runningSize--;
-				break;
-
-			default:
-				LOG_F(ERROR, "DMA - Channel %d - Sync Mode 2 write From Ram not supported!", runningChannel);
-			}
-		}
-		else
-		{
-			//TODO - I dont't know if we ever need to receive packet to Ram.
-			LOG_F(ERROR, "DMA - Channel %d - Sync Mode 2 write to Ram not supported!", runningChannel);
-		}
+		std::memcpy(psx->mem->ram + runningAddr, data.data(), size);
+		invalidateRam(runningAddr, size);
+		runningAddr = (runningAddr + size) & 0x001ffffc;
+		return;
 	}
 
-	return true;
+	for (uint32_t word : data)
+	{
+		std::memcpy(psx->mem->ram + runningAddr, &word, sizeof(word));
+		psx->cpu->invalidateBlocks(runningAddr);
+		runningAddr = (runningAddr + runningIncrement) & 0x001ffffc;
+	}
+}
+
+//Drop any compiled code on the written pages
+void Dma::invalidateRam(uint32_t addr, uint32_t size)
+{
+	for (uint32_t page = addr & ~(CODE_PAGE_SIZE - 1); page < addr + size; page += CODE_PAGE_SIZE)
+		psx->cpu->invalidateBlocks(page);
 }
 
 inline bool Dma::updateDicr(uint32_t data)
@@ -384,6 +534,33 @@ inline bool Dma::updateDicr(uint32_t data)
 	return true;
 }
 
+// Devices holding their DMA Request low. The Channel keeps its Start bit and does not take the bus until they are ready
+bool Dma::isReady(uint8_t channel) const
+{
+	switch (channel)
+	{
+	case 1:		//MDEC Data-Out Request, at least one Block decoded
+		return psx->mdec->dataOutRequest(std::max<uint32_t>(dmaChannel[channel].chanBcr.blockSize, 1));
+
+	default:
+		return true;
+	}
+}
+
+// Release the bus in the middle of a transfer, MADR and BCR already point to the remaining Blocks
+// and the next dmaStart() resumes from there
+bool Dma::dmaPause()
+{
+	isRunning = false;
+	runningSize = 0;
+	runningAddr = 0x00000000;
+
+	//Release CPU access to Address Bus
+	psx->dataBusBusy = false;
+
+	return true;
+}
+
 bool Dma::dmaStop()
 {
 	dmaChannel[runningChannel].chanChcr.dmaStart = 0;
@@ -6,12 +6,16 @@
 #include <array>
 #include <algorithm>
 #include <memory>
+#include <vector>
+#include <span>
 
 #include "dmachannel.h"
 #include "litelib.h"
+#include "device.h"
 
 //DMA Constant Definitions
 constexpr auto DMA_CHANNEL_NUMBER	= 7;				//4 KB
+constexpr auto DMA_BURST_WORDS		= 0x10000;			//Linked List words moved at once, a looping list must not hang the emulator
 
 // DMA Channel Registers Fields
 namespace dma
@@ -38,20 +42,21 @@ namespace dma
 //PSX Object Forward Declaration
 class Psx;
 
-class Dma
+class Dma : public Device
 {
 public:
 	Dma();
 	~Dma();
 
 	bool reset();
-	bool execute();
+	bool runTicks(uint32_t cycles) override;
+	bool serialize(SaveState& state) override;
 
 	bool writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes);
 	uint32_t readAddr(uint32_t addr, uint8_t bytes);
 	
 	//Connect to PSX Instance
-	void link(Psx* instance) { psx = instance; }
+	void link(Psx* instance) override { psx = instance; }
 
 public:
 	//DMA Internal Registers
@@ -61,10 +66,18 @@ public:
 	dma::dicr					dmaDicr;
 	
 private:
-	bool syncmode0();
-	bool syncmode1();
-	bool syncmode2();
+	bool dmaStart();
+	uint32_t transfer();
+	bool isFinished() const;
+	uint32_t syncmode0();
+	uint32_t syncmode1();
+	uint32_t syncmode2();
+	void readRam(std::span<uint32_t> data);
+	void writeRam(std::span<const uint32_t> data);
+	void invalidateRam(uint32_t addr, uint32_t size);
 	bool updateDicr(uint32_t data);
+	bool isReady(uint8_t channel) const;
+	bool dmaPause();
 	bool dmaStop();
 
 private:
@@ -80,6 +93,9 @@ private:
 	uint16_t	runningBlockAmount;
 	uint16_t	runningBlockSize;
 	uint8_t		runningSyncMode;
+	uint32_t	runningCycles;		//Cycles left in the current DMA or CPU (chopping) Window
+
+	std::vector<uint32_t>	buffer;	//Words of the burst being moved
 
 	//Memory Mapping
 	lite::range memRangeChannelRegs =  lite::range(0x1f801080, 0x70);
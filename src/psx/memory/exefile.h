@@ -29,6 +29,7 @@ public:
 
     bool loadExe(const std::string& fileName, const uint8_t * memory);
     bool setRegisters(uint32_t * pc, uint32_t * gpr);
+    bool isPresent() const { return exeInfo.isPresent; }
 
 private:
     uint8_t     header[EXE_HEADER_SIZE];
@@ -1,5 +1,6 @@
 #include <loguru.hpp>
 #include "memory.h"
+#include "psx.h"
 
 Memory::Memory()
 {
@@ -21,6 +22,16 @@ bool Memory::reset()
 	return true;
 }
 
+bool Memory::serialize(SaveState& state)
+{
+	state.section("RAM ");
+	state.buffer(ram, sizeof(ram));
+	state.buffer(cache, sizeof(cache));
+	state.value(ramSize);
+
+	return state.isValid();
+}
+
 uint32_t Memory::read(uint32_t phAddr, uint8_t bytes)
 {
 	uint32_t data = 0;
@@ -39,6 +50,9 @@ bool Memory::write(uint32_t phAddr, uint32_t& data, uint8_t bytes)
 	{
 		ram[phAddr + i] = (uint8_t)(data >> (8 * i));
 	}
+
+	//Drop any compiled code on the written page (self modifying code, DMA transfers)
+	psx->cpu->invalidateBlocks(phAddr);
 	
 	return true;
 }
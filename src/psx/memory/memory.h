@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "litelib.h"
+#include "savestate.h"
 
 constexpr auto RAM_SIZE = 0x200000;	//2 MB
 constexpr auto CACHE_SIZE = 0x400; //1KB
@@ -20,6 +21,7 @@ public:
 	~Memory();
 
 	bool reset();
+	bool serialize(SaveState& state);
 
 	uint32_t read(uint32_t phAddr, uint8_t bytes = 4);
 	bool write(uint32_t phAddr, uint32_t& data, uint8_t bytes = 4);
@@ -30,7 +32,7 @@ public:
 	void link(Psx* instance) { psx = instance; }
 
 public:
-	uint8_t		ram[RAM_SIZE];
+	alignas(4) uint8_t	ram[RAM_SIZE];		//Word aligned, DMA reads words straight from it
 	uint8_t		cache[CACHE_SIZE];
 
 private:
@@ -1,5 +1,7 @@
 #include <loguru.hpp>
+#include <algorithm>
 #include "cdrom.h"
+#include "profiler.h"
 #include "psx.h"
 
 Cdrom::Cdrom()
@@ -15,9 +17,9 @@ Cdrom::Cdrom()
 	commandFifo.flush();
 	adpcmFifo.flush();
 	parameterFifo.flush();
-	dataFifo.flush();
 	responseFifo.flush();
 	interruptFifo.flush();
+	clearDataBuffer();
 
 	//Init Internal Status
 	cdImageLoaded = false;	
@@ -25,6 +27,7 @@ Cdrom::Cdrom()
 	cdMotorOn = false;
 	isStreamingData = false;
 	int1DelayTime = 0;
+	clockTicks = 0;
 
 	//Init COMMAND Dictionary
 	commandSet = 
@@ -295,8 +298,9 @@ Cdrom::~Cdrom()
 
 bool Cdrom::loadImage(const std::string& fileName)
 {
-	//Load Game Image
+	//Load Game Image, the Data Buffer is a view of the previous one
 	LOG_F(INFO, "PSP Game (%s) Loading...", fileName.c_str());
+	clearDataBuffer();
 
 	if (cdImage.openImage(fileName))
 	{
@@ -333,34 +337,156 @@ bool Cdrom::reset()
 	commandFifo.flush();
 	adpcmFifo.flush();
 	parameterFifo.flush();
-	dataFifo.flush();
 	responseFifo.flush();
 	interruptFifo.flush();
+	clearDataBuffer();
 
 	//Init Internal Status
 	cdShellOpen = false;
 	cdMotorOn = false;
 	isStreamingData = false;
 	int1DelayTime = 0;
+	clockTicks = 0;
 	
 	return true;
 }
 
-bool Cdrom::execute()
+bool Cdrom::serialize(SaveState& state)
 {
-	bool bResult;
-	uint8_t interruptNum;
+	state.section("CDR ");
+	serializeSync(state);
+
+	//Internal Status Flags
+	state.value(cdShellOpen);
+	state.value(cdMotorOn);
+	state.value(isStreamingData);
+	state.value(int1DelayTime);
+	state.value(clockTicks);
+
+	//Internal Registers
+	state.value(statusCode);
+	state.value(statusRegister);
+	state.value(requestRegister);
+	state.value(modeRegister);
+	state.value(interruptMaskRegister);
+	state.value(interruptStatusRegister);
+
+	//Internal Fifo
+	state.value(commandFifo);
+	state.value(parameterFifo);
+	state.value(responseFifo);
+	state.value(adpcmFifo);
+	state.value(interruptFifo);
+
+	//CD Image Position, the image itself is the one given on the command line
+	bool imageLoaded = cdImageLoaded;
+	uint32_t sectorTarget = cdImage.getSectorTarget();
+	uint32_t readSector = cdImage.getReadSector();
+	state.value(imageLoaded);
+	state.value(sectorTarget);
+	state.value(readSector);
+
+	//Data Buffer, the Sector is read again from the CD Image
+	uint32_t dataSize = static_cast<uint32_t>(dataBuffer.size());
+	state.value(dataSector);
+	state.value(dataOffset);
+	state.value(dataSize);
+	state.value(dataPos);
+
+	if (state.isLoading() && state.isValid())
+	{
+		if (imageLoaded != cdImageLoaded)
+			LOG_F(WARNING, "CDR - Save State was taken with%s a CD Image loaded!", imageLoaded ? "" : "out");
+		cdImage.setReadSector(sectorTarget, readSector);
+
+		std::span<const uint8_t> sector = (dataSize > 0) ? cdImage.getSectorRaw(dataSector) : std::span<const uint8_t>();
+		dataBuffer = (sector.size() >= dataOffset + dataSize) ? sector.subspan(dataOffset, dataSize) : std::span<const uint8_t>();
+		dataPos = std::min<uint32_t>(dataPos, static_cast<uint32_t>(dataBuffer.size()));
+	}
+
+	return state.isValid();
+}
+
+bool Cdrom::runTicks(uint32_t cycles)
+{
+	PROFILE_ZONE(ProfileZone::Cdrom);
+
+	//CDROM Controller runs at half the CPU Clock, on even cycles
+	uint64_t ticks = (clockTicks + cycles + 1) / 2 - (clockTicks + 1) / 2;
+	clockTicks += cycles;
+
+	while (ticks > 0)
+	{
+		uint64_t quiet = std::min<uint64_t>(quietTicks(), ticks);
+		if (quiet == 0)
+		{
+			execute();
+			ticks--;
+			continue;
+		}
+
+		//Only the pending delays count down until the next Interrupt or Sector
+		updateStatusRegister();
+		if (!interruptFifo.isempty() && (interruptStatusRegister.byte & 0x1f) == 0x00)
+			interruptFifo.elapse(static_cast<int>(quiet));
+		if (isStreamingData)
+			int1DelayTime -= static_cast<uint32_t>(quiet);
+		ticks -= quiet;
+	}
+
+	//Wake up on the cycle running the next busy tick
+	uint32_t quiet = quietTicks();
+	if (quiet != UINT32_MAX)
+	{
+		uint64_t nextTicks = static_cast<uint64_t>(quiet) + 1;
+		psx->scheduler->schedule(SchedulerEvent::Cdrom, nextTicks * 2 - ((clockTicks % 2) ? 0 : 1));
+	}
+	else
+		psx->scheduler->cancel(SchedulerEvent::Cdrom);
+
+	return true;
+}
+
+// Number of upcoming ticks that only count down delays: no command to run,
+// no interrupt to raise and no sector to read.
+uint32_t Cdrom::quietTicks()
+{
+	//A queued command runs on the next tick, unless an interrupt is still pending
+	if (!commandFifo.isempty() && interruptFifo.isempty())
+		return 0;
+
+	uint32_t quiet = UINT32_MAX;
+
+	//Queued interrupts wait for the CPU to acknowledge the previous one
+	if (!interruptFifo.isempty() && (interruptStatusRegister.byte & 0x1f) == 0x00)
+		quiet = static_cast<uint32_t>(interruptFifo.delayleft());
+
+	if (isStreamingData && int1DelayTime > 0)
+		quiet = std::min(quiet, int1DelayTime - 1);
+
+	return quiet;
+}
 
+void Cdrom::updateStatusRegister()
+{
 	//Update Status Register
 	statusRegister.adpbusy = (adpcmFifo.isempty()) ? 0 : 1;
 	statusRegister.prmempt = (parameterFifo.isempty()) ? 1 : 0;
 	statusRegister.prmwrdy = (parameterFifo.isfull()) ? 0 : 1;
 	statusRegister.rslrrdy = (responseFifo.isempty()) ? 0 : 1;
-	statusRegister.drqsts = (dataFifo.isempty()) ? 0 : 1;
+	statusRegister.drqsts = (dataPos < dataBuffer.size()) ? 1 : 0;
 
 	//Update Status Code
 	statusCode.spindlemotor = cdMotorOn;
 	statusCode.shellopen = cdShellOpen;
+}
+
+bool Cdrom::execute()
+{
+	bool bResult;
+	uint8_t interruptNum;
+
+	updateStatusRegister();
 
 	//Check for pending Interrupts
 	if (!interruptFifo.isempty())
@@ -409,15 +535,9 @@ bool Cdrom::execute()
 		int1DelayTime--;
 		if (int1DelayTime == 0)
 		{
-			int sectorSize = (modeRegister.sector_size) ? payload_size_raw : payload_size_mode2;
-			char sectorData[total_sector_size];
-
-			//Read Sector
-			cdImage.readSector(sectorData);  //TODO read always 2048 bytes, add supporto for raw size.
-
-			//Push Sector Data to Data Fifo
-			for(int i = 0; i < sectorSize;  i++)
-				dataFifo.push((uint8_t)sectorData[i]);
+			//Read Sector, it replaces the one in the Data Buffer
+			uint32_t lba = cdImage.getReadSector();
+			loadDataBuffer(lba, cdImage.readSectorRaw());
 
 			//Push INT1(stat)
 			interruptFifo.push(cdrom::INT1, 0); //Fire immediately, delay is already handled by streamingINT1Delay
@@ -544,6 +664,53 @@ bool Cdrom::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
 	return true;
 }
 
+// Same as reading RDDATA once per byte, an empty Data FIFO reads as zero.
+// Returns the number of bytes actually taken from the FIFO.
+size_t Cdrom::readData(std::span<uint8_t> data)
+{
+	size_t count = std::min(data.size(), dataBuffer.size() - dataPos);
+	std::copy_n(dataBuffer.begin() + dataPos, count, data.begin());
+	std::fill(data.begin() + count, data.end(), 0);
+	dataPos += static_cast<uint32_t>(count);
+
+	LOG_F(3, "CDR - Read RDDATA Burst:\t\t%d bytes (%d left)", (int)count, (int)(dataBuffer.size() - dataPos));
+	return count;
+}
+
+// Whole Sector mode skips the Sync bytes only, otherwise the payload follows the Header (and Subheader in Mode 2)
+void Cdrom::loadDataBuffer(uint32_t lba, std::span<const uint8_t> sector)
+{
+	dataSector = lba;
+	dataPos = 0;
+
+	if (sector.size() < total_sector_size)
+	{
+		LOG_F(ERROR, "CDR - Unable to read Sector %d!", lba);
+		dataOffset = 0;
+		dataBuffer = {};
+		return;
+	}
+
+	if (modeRegister.sector_size)
+	{
+		dataOffset = sector_sync_size;
+		dataBuffer = sector.subspan(dataOffset, payload_size_raw);
+	}
+	else
+	{
+		dataOffset = (sector[15] == 1) ? sector_header_size : sector_header_size + sector_subheader_size;
+		dataBuffer = sector.subspan(dataOffset, payload_size_mode2);
+	}
+}
+
+void Cdrom::clearDataBuffer()
+{
+	dataBuffer = {};
+	dataSector = 0;
+	dataOffset = 0;
+	dataPos = 0;
+}
+
 uint32_t Cdrom::readAddr(uint32_t addr, uint8_t bytes)
 {
 	uint32_t data = 0;
@@ -563,9 +730,9 @@ uint32_t Cdrom::readAddr(uint32_t addr, uint8_t bytes)
 		break;
 	
 	case 0x1f801802:
-		if (dataFifo.pop(tmp))
-			data = tmp;
-		LOG_F(3, "CDR - Read RDDATA Register:\t\t0x%08x (%d, %d), data: 0x%08x", addr, bytes,dataFifo.length(), data); 	
+		if (dataPos < dataBuffer.size())
+			data = dataBuffer[dataPos++];
+		LOG_F(3, "CDR - Read RDDATA Register:\t\t0x%08x (%d, %d), data: 0x%08x", addr, bytes, (int)(dataBuffer.size() - dataPos), data); 	
 		break;
 
 	case 0x1f801803:
@@ -5,13 +5,16 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <span>
 
 #include "litelib.h"
 #include "libcdimage.h"
+#include "device.h"
 
 constexpr auto total_sector_size = 2352;
 constexpr auto payload_size_mode2 = 2048;
 constexpr auto payload_size_raw = 2340;
+constexpr auto sector_sync_size = 12;
 constexpr auto int2_delay_time = 20000; //Delay for INT2(stat) after command execution, used for commands that require some time to complete
 constexpr auto int3_delay_time = 2000; //Delay for INT3(stat) after command execution, used for acknowledge commands and commands that complete immediately
 
@@ -112,7 +115,7 @@ namespace cdrom
 
 class Psx;
 
-class Cdrom
+class Cdrom : public Device
 {
 public:
 	Cdrom();
@@ -120,13 +123,18 @@ public:
 
 	bool reset();
 	bool execute();
+	bool runTicks(uint32_t cycles) override;
+	bool serialize(SaveState& state) override;
 	bool loadImage(const std::string& fileName);
 
 	bool writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes);
 	uint32_t readAddr(uint32_t addr, uint8_t bytes);
+
+	//DMA Channel 3 Burst from the Data FIFO
+	size_t readData(std::span<uint8_t> data);
 	
 	//Connect to PSX Instance
-	void link(Psx* instance) { psx = instance; }
+	void link(Psx* instance) override { psx = instance; }
 
     //Getter & Setters
     uint8_t getStatusRegister() const { return statusRegister.byte; }
@@ -146,6 +154,7 @@ private:
 	bool cdMotorOn;
 	bool isStreamingData;
 	uint32_t int1DelayTime;
+	uint64_t clockTicks;		//CPU Clock Ticks, the controller runs on even ones
 
 	//Internal Registers
 	cdrom::StatusCode				statusCode;
@@ -158,11 +167,24 @@ private:
 	//Internal Fifo
 	lite::fifo<uint8_t, 16> 				commandFifo;   //Not really needed, used to check if multiple commands are sent before execution
 	lite::fifo<uint8_t, 16> 				parameterFifo;
-	lite::fifo<uint8_t, 2048 * 2> 			dataFifo;
 	lite::fifo<uint8_t, 16> 				responseFifo;	
 	lite::fifo<uint8_t, 2048 * 2> 			adpcmFifo;
 	lite::delayedfifo<uint8_t, 16> 			interruptFifo;
+
+	//Data Buffer, a view of the payload of the last Sector read from the CD Image (no copy)
+	std::span<const uint8_t>				dataBuffer;
+	uint32_t								dataSector;		//LBA of the Sector in the Data Buffer
+	uint32_t								dataOffset;		//Payload position in the raw Sector
+	uint32_t								dataPos;		//Payload bytes already read
 	
+	//Data Buffer Helpers
+	void loadDataBuffer(uint32_t lba, std::span<const uint8_t> sector);
+	void clearDataBuffer();
+
+	//Scheduling Helpers
+	void updateStatusRegister();
+	uint32_t quietTicks();
+
 	//Command Functions
 	bool cmd_unused();
 	bool cmd_nop();
@@ -1,6 +1,7 @@
 #include <loguru.hpp>
 
 #include "controller.h"
+#include "profiler.h"
 #include "psx.h"
 
 //Cnstructor & Destructor
@@ -44,6 +45,29 @@ bool Controller::reset()
     return true;
 }
 
+bool Controller::serialize(SaveState& state)
+{
+    state.section("JOY ");
+    serializeSync(state);
+
+    //Internal Registers
+    state.value(statRegister);
+    state.value(modeRegister);
+    state.value(ctrlRegister);
+    state.value(baudRegister);
+    state.value(baudCounter);
+    state.value(rxFifo);
+    state.value(txLatch);
+
+    //Button and Analog States follow the host, only the selection belongs to the guest
+    for (int i = 0; i < 2; i++)
+        state.value(controllerState[i].enabled);
+
+    stateMachine->serialize(state);
+
+    return state.isValid();
+}
+
 //External Signals
 bool Controller::execute()
 {
@@ -61,6 +85,72 @@ bool Controller::execute()
     return true;
 }
 
+bool Controller::runTicks(uint32_t cycles)
+{
+    PROFILE_ZONE(ProfileZone::Controller);
+
+    //Skip to the cycles raising a Clock Tick Event, the others only move the Baudrate Timer
+    while (cycles > 0)
+    {
+        uint32_t next = ticksToNextEvent();
+        if (next > cycles)
+        {
+            skipTicks(cycles);
+            break;
+        }
+
+        skipTicks(next - 1);
+        execute();
+        cycles -= next;
+    }
+
+    uint32_t next = ticksToNextEvent();
+    if (next != UINT32_MAX)
+        psx->scheduler->schedule(SchedulerEvent::Controller, next);
+    else
+        psx->scheduler->cancel(SchedulerEvent::Controller);
+
+    return true;
+}
+
+//Number of execute() calls up to the first one the State Machine reacts to
+uint32_t Controller::ticksToNextEvent() const
+{
+    uint32_t next = UINT32_MAX;
+
+    if (stateMachine->isClocked())
+    {
+        uint32_t timer = statRegister.baudratetimer;
+        next = timer ? timer : BAUDRATE_TIMER_MASK + 1;
+    }
+
+    if (stateMachine->getAckPulse() > 0)
+        next = std::min(next, stateMachine->getAckPulse());
+
+    return next;
+}
+
+//Move the Baudrate Timer and ACK Pulse, reload events are ignored by the State Machine
+void Controller::skipTicks(uint32_t cycles)
+{
+    uint32_t timer = statRegister.baudratetimer;
+    uint32_t toReload = timer ? timer : BAUDRATE_TIMER_MASK + 1;
+
+    if (cycles < toReload)
+    {
+        timer = (timer - cycles) & BAUDRATE_TIMER_MASK;
+    }
+    else
+    {
+        uint32_t reload = baudCounter & BAUDRATE_TIMER_MASK;
+        uint32_t period = reload ? reload : BAUDRATE_TIMER_MASK + 1;
+        timer = (reload - (cycles - toReload) % period) & BAUDRATE_TIMER_MASK;
+    }
+    statRegister.baudratetimer = timer;
+
+    stateMachine->skipAckPulse(cycles);
+}
+
 //-------------------------------------------------------------------------------------------------------------
 //
 // Internal Registers Read and Write Functions
@@ -271,8 +361,11 @@ void Controller::setRightTrigger(uint8_t controllerID, int value)
 //-------------------------------------------------------------------------------------------------------------
 ControllerStateMachine::ControllerStateMachine(Controller *ptr)
 {
-    controller = std::shared_ptr<Controller>(ptr);
+    controller = ptr;
     currentState = ControllerState::IDLE;
+    ackPulseCounter = 0;
+    baudTickCounter = 0;
+    currentCommand = 0;
 }
 
 ControllerStateMachine::~ControllerStateMachine()
@@ -280,12 +373,30 @@ ControllerStateMachine::~ControllerStateMachine()
     //Nothing to do
 }
 
-void ControllerStateMachine::pushEvent(ControllerEvent event, uint8_t eventData)
+void ControllerStateMachine::serialize(SaveState& state)
+{
+    state.value(currentState);
+    state.value(ackPulseCounter);
+    state.value(baudTickCounter);
+    state.value(currentCommand);
+}
+
+bool ControllerStateMachine::isClocked() const
 {
-    static int ackPulseCounter = 0;
-    static int baudTickCounter = 0;
-    static int currentCommand = 0;
+    switch (currentState)
+    {
+        case ControllerState::START_SEND_CMD_TO_PAD:
+        case ControllerState::SENDING_CMD_TO_PAD:
+        case ControllerState::START_RECV_RX_FROM_PAD:
+            return true;
 
+        default:
+            return false;
+    }
+}
+
+void ControllerStateMachine::pushEvent(ControllerEvent event, uint8_t eventData)
+{
     //------------------------------------------------------------------------------------------------------- HANDLE ACK PULSE
     if (event == ControllerEvent::CPU_CLOCK_TICK_EVENT)
     {
@@ -3,12 +3,15 @@
 #include <cstdio>
 #include <vector>
 #include <memory>
+#include <algorithm>
 
 #include "litelib.h"
+#include "device.h"
 
 constexpr auto CONTROLLER_DEADZONE = 10;            //Analog Stick Deadzone
 constexpr auto ACK_SIGNAL_DURATION = 100;           //ACK Signal Duration in CPU Clock Ticks (about 3us)
 constexpr auto CMD_TRANSMISSION_DURATION = 8;       //Command Transmission Duration in Controller Clock CONTROTicks
+constexpr auto BAUDRATE_TIMER_MASK = 0x1fffff;      //21bit Baudrate Timer
 
 enum class ControllerButton : uint8_t
 {
@@ -106,7 +109,7 @@ namespace controller
 class Psx;
 class ControllerStateMachine;
 
-class Controller
+class Controller : public Device
 {
     friend class ControllerStateMachine;  // Allow state machine to access private members
 
@@ -115,7 +118,9 @@ public:
     ~Controller();
 
     bool execute();
+    bool runTicks(uint32_t cycles) override;
     bool reset();
+    bool serialize(SaveState& state) override;
 
     bool writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes);
 	uint32_t readAddr(uint32_t addr, uint8_t bytes);
@@ -129,7 +134,11 @@ public:
 	void setRightTrigger(uint8_t controllerID, int value);
 
     //Connect to PSX Instance
-	void link(Psx* instance) { psx = instance; }
+	void link(Psx* instance) override { psx = instance; }
+
+private:
+    uint32_t ticksToNextEvent() const;
+    void skipTicks(uint32_t cycles);
 
 private:
     //Link to PSP Object
@@ -170,8 +179,17 @@ public:
 
     void pushEvent(ControllerEvent event, uint8_t eventData = 0);
     void loadCommandResponse();
+    void serialize(SaveState& state);
+
+    //Controller Clock Tick Events only matter while transferring a byte
+    bool isClocked() const;
+    uint32_t getAckPulse() const { return ackPulseCounter; }
+    void skipAckPulse(uint32_t cycles) { ackPulseCounter -= std::min<int>(ackPulseCounter, cycles); }
 
 private:
-    std::shared_ptr<Controller>     controller;
+    Controller*                     controller;         //Owner Controller, not owned by the State Machine
     ControllerState                 currentState;
+    int                             ackPulseCounter;
+    int                             baudTickCounter;
+    int                             currentCommand;
 };
\ No newline at end of file
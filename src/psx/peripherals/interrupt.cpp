@@ -23,6 +23,15 @@ bool Interrupt::reset()
     return true;
 }
 
+bool Interrupt::serialize(SaveState& state)
+{
+    state.section("INT ");
+    state.value(i_stat);
+    state.value(i_mask);
+
+    return state.isValid();
+}
+
 bool Interrupt::execute()
 {
     //Assert Hardware Interrupt 0 to CPU according to i_stat and i_mask value 
@@ -4,6 +4,8 @@
 #include <cstdio>
 #include <string> 
 
+#include "savestate.h"
+
 namespace interrupt
 {
     enum class Cause : uint8_t
@@ -32,6 +34,7 @@ public:
 
     bool reset();
     bool execute();
+    bool serialize(SaveState& state);
 
     bool request(uint32_t cause);
 
@@ -1,15 +1,20 @@
 #include <loguru.hpp>
+#include <fstream>
+#include <algorithm>
 #include "psx.h"
+#include "profiler.h"
 
 Psx::Psx()
 {
 	//Reset Master Clock
 	masterClock = 0;
+	stallClock = 0;
 
 	cpu = std::make_shared<CpuShort>();
 	//cpu = std::make_shared<CpuFull>();
 	gpu = std::make_shared<GPU>();
 	spu = std::make_shared<SPU>();
+	mdec = std::make_shared<MDEC>();
 	mem = std::make_shared<Memory>();
 	bios = std::make_shared<Bios>();
 	dma = std::make_shared<Dma>();
@@ -19,11 +24,13 @@ Psx::Psx()
 	tty = std::make_shared<Tty>();
 	interrupt = std::make_shared<Interrupt>();
 	exeFile = std::make_shared<exefile>();
+	scheduler = std::make_shared<Scheduler>();
 
 	//Link Hardware Devices
 	cpu->link(this);
 	gpu->link(this);
 	spu->link(this);
+	mdec->link(this);
 	mem->link(this);
 	bios->link(this);
 	dma->link(this);
@@ -32,6 +39,7 @@ Psx::Psx()
 	controller->link(this);
 	tty->link(this);
 	interrupt->link(this);
+	scheduler->link(this);
 
 #ifdef DEBUGGER_ENABLED
     //Init PSX Debugger
@@ -40,6 +48,20 @@ Psx::Psx()
 	cpu->setKernelCallCallback([this](KernelCallEvent e){ Debugger::instance().getCallStackInfo(e); });
 #endif
 
+	//Build Page Table: RAM is mirrored four times in the first 8 MB, BIOS is read only
+	//  - Mirrors follow the BIOS default RAM_SIZE (0x1f801060) setting, later writes to the register don't remap them
+	//  - ScratchPad is not mapped, it is 1 KB of a 4 KB Page and is decoded on the virtual address by the CPU (dCache)
+	std::memset(readPageTable, 0x00, sizeof(readPageTable));
+	std::memset(writePageTable, 0x00, sizeof(writePageTable));
+	mapPages(0x00000000, 0x800000, mem->ram, RAM_SIZE, true);
+	mapPages(0x1fc00000, BIOS_SIZE, bios->rom, BIOS_SIZE, false);
+
+	//Select CPU Execution Mode
+	if (commandline::instance().getCpuMode() == "interpreter")
+		cpu->setMode(CpuMode::Interpreter);
+	else if (commandline::instance().getCpuMode() == "jit")
+		cpu->setMode(CpuMode::Recompiler);
+
 	//Data Bus Status
 	dataBusBusy = false;
 
@@ -58,6 +80,9 @@ Psx::Psx()
 	//Load Bios and Game images
 	bios->loadBios(commandline::instance().getBiosFileName());
 	cdrom->loadImage(commandline::instance().getBinFileName());
+
+	//Schedule the first Device Events
+	syncDevices();
 }
 
 Psx::~Psx()
@@ -68,6 +93,7 @@ bool Psx::reset()
 {
 	//Reset Master Clock
 	masterClock = 0;
+	stallClock = 0;
 
 	//Reset Internal Parameters
 	exp1BaseAddr = 0x0;
@@ -87,17 +113,32 @@ bool Psx::reset()
 	mem->reset();
 	timers->reset();
 	cdrom->reset();
+	spu->reset();
+	mdec->reset();
 	tty->reset();
 	interrupt->reset();
+	scheduler->reset();
+
+	gpu->resetSync();
+	dma->resetSync();
+	controller->resetSync();
+	timers->resetSync();
+	cdrom->resetSync();
+	spu->resetSync();
 
 	//Data Bus Status
 	dataBusBusy = false;
 
+	//Schedule the first Device Events
+	syncDevices();
+
 	return true;
 }
 
 bool Psx::execute()
 {
+	PROFILE_ZONE(ProfileZone::Cpu);
+
 	//-------------------------------------------------------------------
 	// CPU Clock:			33.8688 MHz (Master Clock) [44.1KHz * 600h / 2]
 	// TIMER Clock :		33.8688 MHz (CPU Clock) [System8 Clock = 1/8 CPU Clock]
@@ -109,30 +150,215 @@ bool Psx::execute()
 	// GPU Clock (NTSC): 	53.693175 MHz
 	//-------------------------------------------------------------------
 
-	//Execute all devices
-	cpu->execute();
-	gpu->runticks();
-	dma->execute();
-	controller->execute();
-	timers->execute(ClockSource::System);
+	//Run the CPU up to the next Device Event. The recompiler retires a whole block at once and
+	//ends it at I/O stores, a DMA started or an interrupt raised by one is seen before the next block
+	do
+	{
+		//CPU is stalled while a DMA transfer holds the bus, skip straight to the end of its Window
+		if (dataBusBusy && scheduler->nextTimestamp() != SCHEDULER_NEVER)
+		{
+			uint64_t stallEnd = std::max(masterClock, scheduler->nextTimestamp());
+			stallClock += stallEnd - masterClock;
+			masterClock = stallEnd;
+			break;
+		}
+
+		if (cpu->getMode() == CpuMode::Recompiler)
+		{
+			//Instructions ahead of each stepped one are already charged, the rest of the block is returned
+			uint32_t retired = cpu->executeBlock();
+			masterClock += retired;
+		}
+		else
+		{
+			cpu->execute();
+			masterClock++;
+		}
+
+		interrupt->execute();
+
+#ifdef DEBUGGER_ENABLED
+		//Debugger checks for breakpoints after every instruction
+		break;
+#endif
+	} while (masterClock < scheduler->nextTimestamp());
+
+	//Run the devices whose event is due, each one schedules its next event
+	while (scheduler->nextTimestamp() <= masterClock)
+		syncDevice(scheduler->nextEvent());
+
+	interrupt->execute();
+
+	return true;
+}
 
-	if (!(masterClock % 2))
+void Psx::syncDevices()
+{
+	gpu->syncTo(masterClock);
+	dma->syncTo(masterClock);
+	controller->syncTo(masterClock);
+	timers->syncTo(masterClock);
+	cdrom->syncTo(masterClock);
+	spu->syncTo(masterClock);
+}
+
+void Psx::syncDevice(SchedulerEvent event)
+{
+	switch (event)
 	{
-		cdrom->execute();
+	case SchedulerEvent::Gpu:
+		gpu->syncTo(masterClock);
+		break;
+
+	case SchedulerEvent::Dma:
+		//Transfers feed GPU and CDROM word by word, keep everybody in step
+		syncDevices();
+		break;
+
+	case SchedulerEvent::Cdrom:
+		cdrom->syncTo(masterClock);
+		break;
+
+	case SchedulerEvent::Controller:
+		controller->syncTo(masterClock);
+		break;
+
+	case SchedulerEvent::Timers:
+		//Dot and hBlank Clocks come from the GPU
+		gpu->syncTo(masterClock);
+		timers->syncTo(masterClock);
+		break;
+
+	case SchedulerEvent::Spu:
+		spu->syncTo(masterClock);
+		break;
 	}
+}
 
-	if (!(masterClock % 8))
+//-----------------------------------------------------------------------------------------------------
+// 
+//                               SAVE STATES
+// 
+//-----------------------------------------------------------------------------------------------------
+bool Psx::saveState(std::vector<uint8_t>& data)
+{
+	//RAM, VRAM and Sound RAM are most of the snapshot, avoid growing the buffer while writing
+	data.reserve(RAM_SIZE + VRAM_SIZE * sizeof(uint16_t) + SOUND_RAM_SIZE + 0x10000);
+
+	SaveState state(data, StateMode::Save);
+	if (!serialize(state))
 	{
-		timers->execute(ClockSource::System8);
-	}	
+		LOG_F(ERROR, "PSX - Save State failed!");
+		return false;
+	}
 
-	interrupt->execute();
+	return true;
+}
+
+bool Psx::loadState(std::vector<uint8_t>& data)
+{
+	//Walk the whole snapshot first, one rejected halfway must not leave the machine half restored
+	SaveState check(data, StateMode::Verify);
+	if (!serialize(check))
+	{
+		LOG_F(ERROR, "PSX - Save State rejected!");
+		return false;
+	}
 
-	masterClock++;
+	SaveState state(data, StateMode::Load);
+	if (!serialize(state))
+	{
+		LOG_F(ERROR, "PSX - Save State load failed!");
+		return false;
+	}
 
 	return true;
 }
 
+bool Psx::saveStateFile(const std::string& fileName)
+{
+	std::vector<uint8_t> data;
+	if (!saveState(data))
+		return false;
+
+	std::ofstream ofs;
+	ofs.open(fileName, std::ofstream::binary);
+	if (!ofs.is_open())
+	{
+		LOG_F(ERROR, "PSX - Unable to write Save State %s!", fileName.c_str());
+		return false;
+	}
+
+	ofs.write((char*)data.data(), data.size());
+	ofs.close();
+
+	LOG_F(INFO, "PSX - Save State written to %s (%zu bytes)", fileName.c_str(), data.size());
+	return !ofs.fail();
+}
+
+bool Psx::loadStateFile(const std::string& fileName)
+{
+	std::ifstream ifs;
+	ifs.open(fileName, std::ifstream::binary);
+	if (!ifs.is_open())
+	{
+		LOG_F(ERROR, "PSX - Save State %s Not Found!", fileName.c_str());
+		return false;
+	}
+
+	ifs.seekg(0, ifs.end);
+	size_t size = (size_t)ifs.tellg();
+	ifs.seekg(0, ifs.beg);
+
+	std::vector<uint8_t> data(size);
+	ifs.read((char*)data.data(), size);
+	ifs.close();
+
+	if (!loadState(data))
+		return false;
+
+	LOG_F(INFO, "PSX - Save State loaded from %s", fileName.c_str());
+	return true;
+}
+
+bool Psx::serialize(SaveState& state)
+{
+	state.section("PSX ");
+
+	//Master Clock and Bus Status
+	state.value(masterClock);
+	state.value(dataBusBusy);
+
+	//Internal Registers
+	state.value(exp1BaseAddr);
+	state.value(exp2BaseAddr);
+	state.value(exp1DelaySize);
+	state.value(exp2DelaySize);
+	state.value(exp3DelaySize);
+	state.value(biosDelaySize);
+	state.value(spuDelaySize);
+	state.value(cdromDelaySize);
+	state.value(comDelay);
+	state.value(postStatus);
+
+	//Devices, the Scheduler Timeline goes last and matches their sync point
+	bool result = cpu->serialize(state)
+		&& mem->serialize(state)
+		&& gpu->serialize(state)
+		&& spu->serialize(state)
+		&& mdec->serialize(state)
+		&& dma->serialize(state)
+		&& cdrom->serialize(state)
+		&& timers->serialize(state)
+		&& controller->serialize(state)
+		&& interrupt->serialize(state)
+		&& scheduler->serialize(state);
+
+	state.section("END ");
+
+	return result && state.isValid();
+}
+
 uint32_t Psx::rdMem(uint32_t vAddr, uint8_t bytes)
 {
 	uint32_t phAddr;
@@ -143,19 +369,22 @@ uint32_t Psx::rdMem(uint32_t vAddr, uint8_t bytes)
 
 	cache = utility::Virtual2PhisicalAddr(vAddr, phAddr);
 
-	//ROM Read Access (BIOS)
-	if (memRangeBIOS.contains(phAddr)) return bios->read(phAddr);
-	//RAM Read Access
-	if (memRangeRAM.contains(phAddr))  return mem->read(phAddr, bytes);
-
-	//Memory Mapped I/O Devices
-	if (memRangeGPU.contains(phAddr))  return gpu->readAddr(phAddr, bytes);
-	if (memRangeSPU.contains(phAddr))  return spu->readAddr(phAddr, bytes);
-	if (memRangeDMA.contains(phAddr))  return dma->readAddr(phAddr, bytes);
-	if (memRangeTMR.contains(phAddr))  return timers->readAddr(phAddr, bytes);
-	if (memRangeCDR.contains(phAddr))  return cdrom->readAddr(phAddr, bytes);
+	//RAM and ROM Read Access (BIOS) through the Page Table
+	if (const uint8_t* host = getReadPointer(phAddr))
+	{
+		std::memcpy(&data, host, bytes);
+		return data;
+	}
+
+	//Memory Mapped I/O Devices, the accessed device is brought up to the CPU time first
+	if (memRangeGPU.contains(phAddr)) { syncDevice(SchedulerEvent::Gpu); return gpu->readAddr(phAddr, bytes); }
+	if (memRangeSPU.contains(phAddr)) { syncDevice(SchedulerEvent::Spu); return spu->readAddr(phAddr, bytes); }
+	if (memRangeMDEC.contains(phAddr)) { syncDevice(SchedulerEvent::Dma); return mdec->readAddr(phAddr, bytes); }
+	if (memRangeDMA.contains(phAddr)) { syncDevice(SchedulerEvent::Dma); return dma->readAddr(phAddr, bytes); }
+	if (memRangeTMR.contains(phAddr)) { syncDevice(SchedulerEvent::Timers); return timers->readAddr(phAddr, bytes); }
+	if (memRangeCDR.contains(phAddr)) { syncDevice(SchedulerEvent::Cdrom); return cdrom->readAddr(phAddr, bytes); }
 	if (memRangeINT.contains(phAddr))  return interrupt->readAddr(phAddr, bytes);
-	if (memRangeCNT.contains(phAddr))  return controller->readAddr(phAddr, bytes);	
+	if (memRangeCNT.contains(phAddr)) { syncDevice(SchedulerEvent::Controller); return controller->readAddr(phAddr, bytes); }
 	
 	//Debug Bios TTY
 	if (memRangeTTY.contains(phAddr))  return tty->readAddr(phAddr, bytes);
@@ -173,17 +402,23 @@ bool Psx::wrMem(uint32_t vAddr, uint32_t& data, uint8_t bytes)
 
 	cache = utility::Virtual2PhisicalAddr(vAddr, phAddr);	
 	
-	//RAM Write Access
-	if (memRangeRAM.contains(phAddr))  return mem->write(phAddr, data, bytes);
-
-	//Memory Mapped I/O Devices
-	if (memRangeGPU.contains(phAddr))  return gpu->writeAddr(phAddr, data, bytes);
-	if (memRangeSPU.contains(phAddr))  return spu->writeAddr(phAddr, data, bytes);
-	if (memRangeDMA.contains(phAddr))  return dma->writeAddr(phAddr, data, bytes);
-	if (memRangeTMR.contains(phAddr))  return timers->writeAddr(phAddr, data, bytes);
-	if (memRangeCDR.contains(phAddr))  return cdrom->writeAddr(phAddr, data, bytes);
+	//RAM Write Access through the Page Table, drop any compiled code on the written page
+	if (uint8_t* host = getWritePointer(phAddr))
+	{
+		std::memcpy(host, &data, bytes);
+		cpu->invalidateBlocks(phAddr);
+		return true;
+	}
+
+	//Memory Mapped I/O Devices, the accessed device is brought up to the CPU time first and rescheduled after the write
+	if (memRangeGPU.contains(phAddr)) { syncDevice(SchedulerEvent::Gpu); return gpu->writeAddr(phAddr, data, bytes) && gpu->runTicks(0); }
+	if (memRangeSPU.contains(phAddr)) { syncDevice(SchedulerEvent::Spu); return spu->writeAddr(phAddr, data, bytes) && spu->runTicks(0); }
+	if (memRangeMDEC.contains(phAddr)) { syncDevice(SchedulerEvent::Dma); return mdec->writeAddr(phAddr, data, bytes) && dma->runTicks(0); }
+	if (memRangeDMA.contains(phAddr)) { syncDevice(SchedulerEvent::Dma); return dma->writeAddr(phAddr, data, bytes) && dma->runTicks(0); }
+	if (memRangeTMR.contains(phAddr)) { syncDevice(SchedulerEvent::Timers); return timers->writeAddr(phAddr, data, bytes) && timers->runTicks(0); }
+	if (memRangeCDR.contains(phAddr)) { syncDevice(SchedulerEvent::Cdrom); return cdrom->writeAddr(phAddr, data, bytes) && cdrom->runTicks(0); }
 	if (memRangeINT.contains(phAddr))  return interrupt->writeAddr(phAddr, data, bytes);
-	if (memRangeCNT.contains(phAddr))  return controller->writeAddr(phAddr, data, bytes);
+	if (memRangeCNT.contains(phAddr)) { syncDevice(SchedulerEvent::Controller); return controller->writeAddr(phAddr, data, bytes) && controller->runTicks(0); }
 	
 	if (memRangeMEM1.contains(phAddr)) return this->writeAddr(phAddr, data, bytes);
 	if (memRangeMEM2.contains(phAddr)) return mem->writeAddr(phAddr, data, bytes);
@@ -196,6 +431,20 @@ bool Psx::wrMem(uint32_t vAddr, uint32_t& data, uint8_t bytes)
 
 	return false;
 }
+
+// Map a guest physical range on host memory, the host buffer is repeated
+// when the guest range is larger (mirrors).
+void Psx::mapPages(uint32_t phAddr, uint32_t size, uint8_t* host, uint32_t hostSize, bool writable)
+{
+	for (uint32_t offset = 0; offset < size; offset += (1 << BUS_PAGE_SHIFT))
+	{
+		uint32_t page = (phAddr + offset) >> BUS_PAGE_SHIFT;
+
+		readPageTable[page] = host + (offset % hostSize);
+		writePageTable[page] = writable ? host + (offset % hostSize) : nullptr;
+	}
+}
+
 bool Psx::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
 {
 	switch (addr)
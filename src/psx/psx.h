@@ -3,15 +3,20 @@
 #include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "litelib.h"
 #include "debugger.h"
 #include "commandline.h"
 #include "renderer.h"
+#include "scheduler.h"
+#include "savestate.h"
 
 #include "cpu_short_pipe.h"
 #include "gpu.h"
 #include "spu.h"
+#include "mdec.h"
 #include "memory.h"
 #include "bios.h"
 #include "dma.h"
@@ -22,6 +27,11 @@
 #include "controller.h"
 #include "exefile.h"
 
+//Page Table Bus Constants
+constexpr auto BUS_PAGE_SHIFT = 12;								//4 KB Pages
+constexpr auto BUS_PAGE_MASK = (1 << BUS_PAGE_SHIFT) - 1;
+constexpr auto BUS_PAGE_COUNT = 0x20000000 >> BUS_PAGE_SHIFT;	//Full 512 MB Physical Address Space
+
 class Psx
 {
 public:
@@ -31,12 +41,35 @@ public:
 	bool reset();
 	bool execute();
 
+	//Bring devices up to the current Master Clock
+	void syncDevices();
+	void syncDevice(SchedulerEvent event);
+
+	//Save States, the whole machine in a single versioned snapshot. A failed load leaves the machine untouched
+	bool saveState(std::vector<uint8_t>& data);
+	bool loadState(std::vector<uint8_t>& data);
+	bool saveStateFile(const std::string& fileName);
+	bool loadStateFile(const std::string& fileName);
+
 	//Memory Bus Access
 	uint32_t rdMem(uint32_t vAddr, uint8_t bytes = 4);
 	bool	 wrMem(uint32_t vAddr, uint32_t& data, uint8_t bytes = 4);
 	
 	uint32_t readAddr(uint32_t addr, uint8_t bytes = 4);
 	bool	 writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes = 4);
+
+	//Page Table Direct Access, nullptr if the address is not backed by host memory
+	uint8_t* getReadPointer(uint32_t phAddr) const
+	{
+		uint8_t* page = (phAddr < 0x20000000) ? readPageTable[phAddr >> BUS_PAGE_SHIFT] : nullptr;
+		return (page != nullptr) ? page + (phAddr & BUS_PAGE_MASK) : nullptr;
+	}
+
+	uint8_t* getWritePointer(uint32_t phAddr) const
+	{
+		uint8_t* page = (phAddr < 0x20000000) ? writePageTable[phAddr >> BUS_PAGE_SHIFT] : nullptr;
+		return (page != nullptr) ? page + (phAddr & BUS_PAGE_MASK) : nullptr;
+	}
 	
 public:
 	//PSP Memory Components
@@ -47,6 +80,7 @@ public:
 	std::shared_ptr<CpuShort>	cpu;
 	std::shared_ptr<GPU>		gpu;
 	std::shared_ptr<SPU>		spu;
+	std::shared_ptr<MDEC>		mdec;
 	std::shared_ptr<Dma>		dma;
 	std::shared_ptr<Cdrom>		cdrom;
 	std::shared_ptr<Timers>		timers;
@@ -57,12 +91,18 @@ public:
 	//Executable File
 	std::shared_ptr<exefile>	exeFile;
 
+	//Device Event Scheduler
+	std::shared_ptr<Scheduler>	scheduler;
+
 	//Data Bus Status
 	bool		dataBusBusy;
 
 	//Master Clock: CPU Clock 33.8688 MHz
 	uint64_t	masterClock;
 
+	//Master Clock cycles the CPU spent stalled on a DMA transfer
+	uint64_t	stallClock;
+
 	//Temporary Debug
 	uint32_t writingAddress;
 	uint32_t readingAddress;
@@ -80,8 +120,16 @@ public:
 	uint32_t postStatus;		//0x1f802041
 
 private:
+	bool serialize(SaveState& state);
+
+	//Page Table Helper Functions
+	void mapPages(uint32_t phAddr, uint32_t size, uint8_t* host, uint32_t hostSize, bool writable);
+
+	//Page Table, each 4 KB guest page points to host memory or is left to the I/O decoding
+	uint8_t*	readPageTable[BUS_PAGE_COUNT];
+	uint8_t*	writePageTable[BUS_PAGE_COUNT];
+
 	//Memory Mapping
-	lite::range memRangeRAM =  lite::range(0x00000000, 0x200000);
 	lite::range memRangeEXP1 = lite::range(0x1f000000, 0x800000);
 	lite::range memRangeExpROM = lite::range(0x1f000000, 0x100);
 	lite::range memRangeMEM1 = lite::range(0x1f801000, 0x24);
@@ -92,12 +140,12 @@ private:
 	lite::range memRangeTMR =  lite::range(0x1f801100, 0x30);
 	lite::range memRangeCDR =  lite::range(0x1f801800, 0x4);
 	lite::range memRangeGPU =  lite::range(0x1f801810, 0x8);
+	lite::range memRangeMDEC = lite::range(0x1f801820, 0x8);
 	lite::range memRangeSPU =  lite::range(0x1f801c00, 0x400);
 	lite::range memRangeEXP2 = lite::range(0x1f802000, 0x1000);
 	lite::range memRangeTTY = lite::range(0x1f802020, 0x10);
 	lite::range memRangePOST =  lite::range(0x1f802041, 0x1);
 	lite::range memRangeEXP3 = lite::range(0x1fa00000, 0x200000);
-	lite::range memRangeBIOS = lite::range(0x1fc00000, 0x80000);
 	lite::range memRangeCNT = lite::range(0x1f801040, 0x10);
 };
 
@@ -81,11 +81,25 @@ psxemu::psxemu()
 		
 
     pWindow = nullptr;
+    glContext = nullptr;
+    sdlAudioDevice = 0;
+    sdlAudioStream = nullptr;
+    isRunning = false;
+    isHeadless = false;
 }
 
 psxemu::~psxemu()
 {
-    // Cleanup
+    //Nothing was created on the SDL side in Headless Mode
+    if (isHeadless)
+        return;
+
+    // Cleanup, the Audio Callback must be stopped before the PSX Object goes away
+    if (sdlAudioStream != nullptr)
+        SDL_DestroyAudioStream(sdlAudioStream);
+    if (sdlAudioDevice != 0)
+        SDL_CloseAudioDevice(sdlAudioDevice);
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
@@ -102,7 +116,7 @@ bool psxemu::init(int wndWidth, int wndHeight)
     windowHeight = wndHeight;
 
     //Initialize SDL
-    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD))
+    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD | SDL_INIT_AUDIO))
     {
         LOG_F(ERROR, "SDL could not initialize! SDL_Error: %s", SDL_GetError());
         return false;
@@ -183,6 +197,14 @@ bool psxemu::init(int wndWidth, int wndHeight)
     //glEnable(GL_DEBUG_OUTPUT);
     //glDebugMessageCallback(MessageCallback, 0);
 
+    //Select Renderer Backend, it must be done before the GPU initializes it
+    if (commandline::instance().getRendererMode() == "software")
+        Renderer::SetBackend(RendererBackend::Software);
+    else if (commandline::instance().getRendererMode() == "null")
+        Renderer::SetBackend(RendererBackend::Null);
+    Renderer::SetRasterizerThreads(commandline::instance().getRasterThreads());
+    Renderer::SetTextureCache(commandline::instance().isTextureCacheEnabled());
+
     //Init PSX Emulator Object
     isRunning = true;
     psx = std::make_shared<Psx>();
@@ -190,6 +212,13 @@ bool psxemu::init(int wndWidth, int wndHeight)
     //Init Renderer Window Size
     Renderer::SetWindowsSize(windowWidth, windowHeight);
 
+    //Start Audio Output, the emulator keeps running without it
+    initAudio();
+
+    //Resume from a Save State instead of booting through the Bios
+    if (!commandline::instance().getStateFileName().empty() && !psx->loadStateFile(commandline::instance().getStateFileName()))
+        return false;
+
     return true;
 }
 
@@ -228,7 +257,9 @@ bool psxemu::run()
             if (stepMode != StepMode::Run)
 				framePerSecond = 0; // Show 0 FPS when not running
 #endif
-            std::string windowTitle = std::format("PSXemu [FPS: {}]", framePerSecond);
+            //Audio Buffer in milliseconds of Stereo Samples
+            size_t audioLevel = psx->spu->getOutputLevel() * 1000 / (2 * SPU_SAMPLE_RATE);
+            std::string windowTitle = std::format("PSXemu [FPS: {}] [Audio: {} ms, Underruns: {}]", framePerSecond, audioLevel, psx->spu->getOutputUnderruns());
             SDL_SetWindowTitle(pWindow, windowTitle.c_str());
 
             // Reset counters
@@ -240,6 +271,57 @@ bool psxemu::run()
     return true;
 }
 
+bool psxemu::initHeadless()
+{
+    isHeadless = true;
+
+    //Renderer must be switched before the GPU initializes it
+    if (commandline::instance().getRendererMode() == "software")
+        Renderer::SetBackend(RendererBackend::Software, true);
+    else
+        Renderer::SetBackend(RendererBackend::Null, true);
+    Renderer::SetRasterizerThreads(commandline::instance().getRasterThreads());
+
+    //Init PSX Emulator Object
+    isRunning = true;
+    psx = std::make_shared<Psx>();
+
+    if (!psx->bios->isLoaded())
+    {
+        LOG_F(ERROR, "Headless Mode requires a valid Bios image!");
+        return false;
+    }
+
+    //Resume from a Save State instead of booting through the Bios
+    if (!commandline::instance().getStateFileName().empty() && !psx->loadStateFile(commandline::instance().getStateFileName()))
+        return false;
+
+    LOG_F(INFO, "PSXEMU Headless Mode Initialized...");
+
+    return true;
+}
+
+bool psxemu::runHeadless(int frames)
+{
+    auto timerStart = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; frame++)
+        update();
+
+    auto elapsedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - timerStart).count();
+    LOG_F(INFO, "PSXEMU Headless Run Completed - Frames: %d, Cycles: %llu, Time: %.3fs, FPS: %.1f",
+        frames, (unsigned long long)psx->masterClock, elapsedTime, elapsedTime > 0.0 ? frames / elapsedTime : 0.0);
+
+    //An EXE was requested but the Bios never reached the Shell, or the file was rejected
+    if (!commandline::instance().getExeFileName().empty() && !psx->exeFile->isPresent())
+    {
+        LOG_F(ERROR, "Headless Run Failed - EXE not loaded!");
+        return false;
+    }
+
+    return true;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 // Private Methods
@@ -324,6 +406,12 @@ bool psxemu::handleEvents()
                 case SDLK_R:
                     psx->reset();
                     break;
+                case SDLK_F5:
+                    psx->saveStateFile(getStateFileName());
+                    break;
+                case SDLK_F9:
+                    psx->loadStateFile(getStateFileName());
+                    break;
                 case SDLK_P:
                     Debugger::setStepMode(StepMode::Halt);
                     break;
@@ -378,6 +466,52 @@ bool psxemu::handleEvents()
     return true;
 }
 
+bool psxemu::initAudio()
+{
+    SDL_AudioSpec spec = { SDL_AUDIO_S16, 2, SPU_SAMPLE_RATE };
+
+    sdlAudioDevice = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec);
+    if (sdlAudioDevice == 0)
+    {
+        LOG_F(WARNING, "Audio Device could not be opened! SDL_Error: %s", SDL_GetError());
+        return false;
+    }
+
+    //SDL converts to the Device format, samples are pulled from the SPU on the SDL Audio thread
+    sdlAudioStream = SDL_CreateAudioStream(&spec, &spec);
+    if (sdlAudioStream == nullptr
+        || !SDL_SetAudioStreamGetCallback(sdlAudioStream, audioCallback, this)
+        || !SDL_BindAudioStream(sdlAudioDevice, sdlAudioStream))
+    {
+        LOG_F(WARNING, "Audio Stream could not be created! SDL_Error: %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_ResumeAudioDevice(sdlAudioDevice);
+    LOG_F(INFO, "Audio Output Initialized...");
+
+    return true;
+}
+
+void SDLCALL psxemu::audioCallback(void* userdata, SDL_AudioStream* stream, int additionalAmount, int totalAmount)
+{
+    //Runs on the SDL Audio thread, it only touches the Consumer side of the SPU Output Ring
+    psxemu* emu = static_cast<psxemu*>(userdata);
+    int16_t samples[AUDIO_CALLBACK_SAMPLES];
+    size_t requested = additionalAmount / sizeof(int16_t);
+
+    while (requested > 0)
+    {
+        size_t count = std::min<size_t>(requested, AUDIO_CALLBACK_SAMPLES);
+        size_t read = emu->psx->spu->readSamples(samples, count);
+
+        //Underrun, play silence instead of waiting for the emulation
+        std::fill(samples + read, samples + count, 0);
+        SDL_PutAudioStreamData(stream, samples, static_cast<int>(count * sizeof(int16_t)));
+        requested -= count;
+    }
+}
+
 bool psxemu::update()
 {
     //Run PSX Emulator in Normal mode
@@ -546,3 +680,10 @@ void psxemu::updateGamepadsAxisMotion(SDL_JoystickID id, int axis, int value) co
             
 	}
 }
+
+std::string psxemu::getStateFileName() const
+{
+    std::string fileName = commandline::instance().getStateFileName();
+
+    return fileName.empty() ? std::string(QUICKSAVE_FILENAME) : fileName;
+}
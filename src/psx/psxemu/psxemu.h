@@ -5,6 +5,8 @@
 #include <string>
 #include <memory>
 #include <format>
+#include <chrono>
+#include <algorithm>
 
 #include "videolib.h"
 #include "psx.h"
@@ -12,6 +14,8 @@
 constexpr auto MINIMUM_SCREEN_WIDTH = 640;
 constexpr auto MINIMUM_SCREEN_HEIGHT = 480;
 constexpr auto MAX_GAMEPADS = 2;
+constexpr auto QUICKSAVE_FILENAME = "psxemu.state";  //Save State used by F5/F9 when --state is not given
+constexpr auto AUDIO_CALLBACK_SAMPLES = 1024;        //Samples moved to SDL in one go by the Audio Callback
 
 class psxemu
 {
@@ -22,10 +26,15 @@ public:
 	bool init(int wndWidth, int wndHeight);
 	bool run();
 
+	//Headless Mode, no Window, OpenGL Context or ImGui
+	bool initHeadless();
+	bool runHeadless(int frames);
+
 
 public:
 	//Emulator Status
 	bool	isRunning;
+	bool	isHeadless;
 	std::shared_ptr<Psx>	psx;
 
 private:
@@ -35,6 +44,9 @@ private:
 	bool render();
 	void updateGamepadsButtonsState(SDL_JoystickID id, int button, bool pressed) const;
 	void updateGamepadsAxisMotion(SDL_JoystickID id, int axis, int value) const;
+	std::string getStateFileName() const;
+	bool initAudio();
+	static void SDLCALL audioCallback(void* userdata, SDL_AudioStream* stream, int additionalAmount, int totalAmount);
 
 private:
 	//Main Window Size
@@ -46,6 +58,7 @@ private:
 	SDL_Window*			pWindow;
 	SDL_GLContext		glContext;
 	SDL_AudioDeviceID	sdlAudioDevice;
+	SDL_AudioStream*	sdlAudioStream;
 
 	//Gamepads
 	int					numGamepads;
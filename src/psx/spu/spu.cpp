@@ -1,9 +1,81 @@
 #include <loguru.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include "spu.h"
+#include "spumix.h"
+#include "profiler.h"
+#include "psx.h"
+
+//ADPCM Prediction Filters
+constexpr int32_t adpcmPositive[5] = { 0, 60, 115, 98, 122 };
+constexpr int32_t adpcmNegative[5] = { 0, 0, -52, -55, -60 };
+
+//4 Taps Interpolation Weights, oldest Sample first, for each of the 256 steps between two Samples.
+//Generated from a Gaussian curve close to the hardware one (the weights of the center taps match
+//within a few units, the real table is not reproduced bit exact).
+static const auto gaussTable = []()
+{
+	std::array<std::array<int16_t, 4>, 256> table{};
+
+	for (int i = 0; i < 256; i++)
+	{
+		double fraction = i / 256.0;
+		double distance[4] = { 2.0 + fraction, 1.0 + fraction, fraction, 1.0 - fraction };
+		double weight[4];
+		double sum = 0.0;
+
+		for (int t = 0; t < 4; t++)
+		{
+			weight[t] = std::exp(-distance[t] * distance[t] / 0.646);
+			sum += weight[t];
+		}
+
+		for (int t = 0; t < 4; t++)
+			table[i][t] = static_cast<int16_t>(std::lround(weight[t] * 0x7f80 / sum));
+	}
+
+	return table;
+}();
+
+static inline int16_t clamp16(int32_t value)
+{
+	return static_cast<int16_t>(std::clamp(value, -0x8000, 0x7fff));
+}
+
+//Volume in Fixed Mode, Sweep Mode is not emulated and keeps the last Volume
+static inline int16_t fixedVolume(uint16_t reg, int16_t current)
+{
+	if (reg & 0x8000)
+		return current;
+
+	return static_cast<int16_t>(reg << 1);
+}
+
+//Access to one half of a register holding a bit per Voice
+static inline void writeHalf(uint32_t& reg, uint32_t addr, uint16_t data)
+{
+	uint32_t shift = (addr & 0x2) * 8;
+	reg = (reg & ~(0xffff << shift)) | (data << shift);
+}
+
+static inline uint16_t readHalf(uint32_t reg, uint32_t addr)
+{
+	return static_cast<uint16_t>(reg >> ((addr & 0x2) * 8));
+}
 
 SPU::SPU()
 {
-    //Reset Internal Registers
+	reset();
+}
+
+SPU::~SPU()
+{
+}
+
+bool SPU::reset()
+{
+	//Reset Internal Registers
 	mainVolumeL = 0x0;
 	mainVolumeR = 0x0;
 	reverbVolumeL = 0x0;
@@ -29,188 +101,676 @@ SPU::SPU()
 	currentVolumeL = 0x0;
 	currentVolumeR = 0x0;
 	unknownReg2 = 0x0;
+	memset(reverbConfig, 0x00, sizeof(reverbConfig));
+
+	//Reset Voices and Sound RAM
+	memset(static_cast<void*>(voices.data()), 0x00, sizeof(voices));
+	memset(soundRam, 0x00, sizeof(soundRam));
+	memset(voiceOutput, 0x00, sizeof(voiceOutput));
+	transferAddr = 0x0;
+	sampleCycles = 0;
+	noiseTimer = 0;
+	noiseLevel = 0x0001;
+
+	//Samples mixed before the reset must not be played
+	output.drain();
+
+	return true;
 }
 
-SPU::~SPU()
+bool SPU::serialize(SaveState& state)
 {
+	state.section("SPU ");
+	serializeSync(state);
+
+	//Internal Registers
+	state.value(mainVolumeL);
+	state.value(mainVolumeR);
+	state.value(reverbVolumeL);
+	state.value(reverbVolumeR);
+	state.value(voiceKeyOn);
+	state.value(voiceKeyOff);
+	state.value(voiceChannelFM);
+	state.value(voiceChannelNoise);
+	state.value(voiceChannelReverb);
+	state.value(voiceChannelStatus);
+	state.value(unknownReg1);
+	state.value(soundRamAddr);
+	state.value(soundRamIrqAddr);
+	state.value(soundRamDataTransAddr);
+	state.value(soundRamDataTransFifo);
+	state.value(spuCnt);
+	state.value(soundRamDataTransCtrl);
+	state.value(spuStat);
+	state.value(cdromVolumeL);
+	state.value(cdromVolumeR);
+	state.value(externVolumeL);
+	state.value(externVolumeR);
+	state.value(currentVolumeL);
+	state.value(currentVolumeR);
+	state.value(unknownReg2);
+	state.value(reverbConfig);
+
+	//Voices and Sound RAM
+	state.value(voices);
+	state.buffer(soundRam, sizeof(soundRam));
+	state.value(transferAddr);
+	state.value(sampleCycles);
+	state.value(noiseTimer);
+	state.value(noiseLevel);
+
+	//Samples mixed before the load belong to another point in time
+	if (state.isLoading())
+		output.drain();
+
+	return state.isValid();
 }
 
-bool SPU::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
+bool SPU::runTicks(uint32_t cycles)
 {
-	switch (addr)
+	PROFILE_ZONE(ProfileZone::Spu);
+
+	uint64_t total = static_cast<uint64_t>(sampleCycles) + cycles;
+	uint64_t samples = total / SPU_SAMPLE_CYCLES;
+	sampleCycles = static_cast<uint32_t>(total % SPU_SAMPLE_CYCLES);
+
+	while (samples > 0)
 	{
-	case 0x1f801d80:
-		mainVolumeL = (uint16_t)data;			//Main Volume Left
-		break;
-	case 0x1f801d82:
-		mainVolumeR = (uint16_t)data;			//Main Volume Right
-		break;
-	case 0x1f801d84:
-		reverbVolumeL = (uint16_t)data;			//Reverb Output Volume Left
-		break;
-	case 0x1f801d86:
-		reverbVolumeR = (uint16_t)data;			//Reverb Output Volume Right
-		break;
-	case 0x1f801d88:
-		voiceKeyOn = data;						//Voice 0..23 Key ON (Start Attack/Decay/Sustain) (W)
-		break;
-	case 0x1f801d8c:
-		voiceKeyOff = data;						//Voice 0..23 Key OFF (Start Release) (W)
-		break;
-	case 0x1f801d90:
-		voiceChannelFM = data;					//Voice 0..23 Channel FM (pitch lfo) mode (R/W)
-		break;
-	case 0x1f801d94:
-		voiceChannelNoise = data;				//Voice 0..23 Channel Noise mode (R/W)
-		break;
-	case 0x1f801d98:
-		voiceChannelReverb = data;				//Voice 0..23 Channel Reverb mode (R/W)
-		break;
-	case 0x1f801d9c:
-		voiceChannelStatus = data;				//Voice 0..23 Channel ON/OFF (status) (R)
-		break;
-	case 0x1f801da0:
-		unknownReg1 = (uint16_t)data;			//Unknown
-		break;
-	case 0x1f801da2:
-		soundRamAddr = (uint16_t)data;			//Sound RAM Reverb Work Area Start Address
-		break;
-	case 0x1f801da4:
-		soundRamIrqAddr = (uint16_t)data;		//Sound RAM IRQ Address
+		uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(samples, SPU_BLOCK_SAMPLES));
+		mixBlock(count);
+		samples -= count;
+	}
+
+	//Wake up when a whole Block is due
+	psx->scheduler->schedule(SchedulerEvent::Spu, SPU_BLOCK_SAMPLES * SPU_SAMPLE_CYCLES - sampleCycles);
+
+	return true;
+}
+
+size_t SPU::readSamples(int16_t* data, size_t count)
+{
+	return output.pop(data, count);
+}
+
+//-----------------------------------------------------------------------------------------------------
+//
+//                               V O I C E S
+//
+//-----------------------------------------------------------------------------------------------------
+void SPU::mixBlock(uint32_t count)
+{
+	alignas(32) int32_t mixL[SPU_BLOCK_SAMPLES] = {};
+	alignas(32) int32_t mixR[SPU_BLOCK_SAMPLES] = {};
+
+	//SPU Enable, Voices are not running while the SPU is off
+	if (spuCnt & 0x8000)
+	{
+		int16_t noise[SPU_BLOCK_SAMPLES];
+		for (uint32_t i = 0; i < count; i++)
+			noise[i] = updateNoise();
+
+		for (int v = 0; v < SPU_VOICE_NUMBER; v++)
+		{
+			spu::Voice& voice = voices[v];
+
+			if (voice.phase == spu::AdsrPhase::Off)
+			{
+				//Silent Voices still feed the Pitch Modulation of the next one
+				memset(voiceOutput[v], 0x00, sizeof(voiceOutput[v]));
+				continue;
+			}
+
+			renderVoice(v, noise, count);
+			mixVoice(voiceOutput[v], voice.currentVolumeL, voice.currentVolumeR, mixL, mixR);
+		}
+	}
+
+	//Mute SPU clears the output only
+	bool unmuted = spuCnt & 0x4000;
+	int16_t volumeL = static_cast<int16_t>(currentVolumeL);
+	int16_t volumeR = static_cast<int16_t>(currentVolumeR);
+	int16_t samples[SPU_BLOCK_SAMPLES * 2];
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		samples[i * 2] = unmuted ? clamp16((clamp16(mixL[i]) * volumeL) >> 15) : 0;
+		samples[i * 2 + 1] = unmuted ? clamp16((clamp16(mixR[i]) * volumeR) >> 15) : 0;
+	}
+
+	//The whole Block is dropped when the Audio thread is not keeping up (or there's none),
+	//Left/Right pairs are never split
+	output.push(samples, count * 2);
+}
+
+void SPU::renderVoice(int v, const int16_t* noise, uint32_t count)
+{
+	spu::Voice& voice = voices[v];
+	bool modulated = (voiceChannelFM & (1 << v)) && (v > 0);
+	bool noisy = voiceChannelNoise & (1 << v);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (voice.phase == spu::AdsrPhase::Off)
+		{
+			voiceOutput[v][i] = 0;
+			continue;
+		}
+
+		//Sample, 4 taps Gaussian Interpolation of the ADPCM Samples
+		int32_t sample;
+		if (noisy)
+			sample = noise[i];
+		else
+		{
+			const int16_t* s = &voice.samples[voice.counter >> 12];
+			const auto& gauss = gaussTable[(voice.counter >> 4) & 0xff];
+			sample = (gauss[0] * s[0] + gauss[1] * s[1] + gauss[2] * s[2] + gauss[3] * s[3]) >> 15;
+		}
+
+		voiceOutput[v][i] = clamp16((sample * voice.adsrVolume) >> 15);
+		updateEnvelope(voice);
+
+		//Pitch, modulated by the output of the previous Voice
+		uint32_t step = voice.pitch;
+		if (modulated)
+		{
+			int32_t factor = voiceOutput[v - 1][i] + 0x8000;
+			step = static_cast<uint32_t>((static_cast<int16_t>(step) * factor) >> 15) & 0xffff;
+		}
+		step = std::min<uint32_t>(step, 0x4000);
+
+		voice.counter += step;
+		while ((voice.counter >> 12) >= 28)
+		{
+			voice.counter -= 28 << 12;
+			nextBlock(v);
+		}
+	}
+}
+
+void SPU::nextBlock(int v)
+{
+	spu::Voice& voice = voices[v];
+
+	if (voice.blockFlags & 0x1)
+	{
+		//Loop End, jump to the Repeat Address. Without Loop Repeat the Voice is silenced
+		voiceChannelStatus |= 1 << v;
+		voice.currentAddr = (voice.repeatAddr * 8) & (SOUND_RAM_SIZE - 1);
+
+		if (!(voice.blockFlags & 0x2))
+		{
+			voice.phase = spu::AdsrPhase::Off;
+			voice.adsrVolume = 0;
+		}
+	}
+	else
+		voice.currentAddr = (voice.currentAddr + 16) & (SOUND_RAM_SIZE - 1);
+
+	//Keep the last Samples for the Interpolation across Blocks
+	voice.samples[0] = voice.samples[28];
+	voice.samples[1] = voice.samples[29];
+	voice.samples[2] = voice.samples[30];
+	decodeBlock(voice);
+}
+
+void SPU::decodeBlock(spu::Voice& voice)
+{
+	const uint8_t* block = soundRam + voice.currentAddr;
+	checkIrq(voice.currentAddr, 16);
+
+	uint8_t shift = block[0] & 0x0f;
+	uint8_t filter = std::min((block[0] >> 4) & 0x07, 4);
+	if (shift > 12)
+		shift = 9;
+
+	//Loop Start Flag sets the Repeat Address
+	voice.blockFlags = block[1];
+	if (voice.blockFlags & 0x4)
+		voice.repeatAddr = static_cast<uint16_t>(voice.currentAddr >> 3);
+
+	int32_t old = voice.samples[2];
+	int32_t older = voice.samples[1];
+
+	for (int i = 0; i < 28; i++)
+	{
+		int32_t nibble = (block[2 + i / 2] >> ((i & 1) * 4)) & 0x0f;
+		int32_t sample = static_cast<int16_t>(nibble << 12) >> shift;
+		sample += (old * adpcmPositive[filter] + older * adpcmNegative[filter] + 32) >> 6;
+		sample = clamp16(sample);
+
+		voice.samples[3 + i] = static_cast<int16_t>(sample);
+		older = old;
+		old = sample;
+	}
+}
+
+void SPU::keyOn(uint32_t bits)
+{
+	for (int v = 0; v < SPU_VOICE_NUMBER; v++)
+	{
+		if (!(bits & (1 << v)))
+			continue;
+
+		spu::Voice& voice = voices[v];
+		voice.phase = spu::AdsrPhase::Attack;
+		voice.adsrVolume = 0;
+		voice.adsrCycles = 0;
+		voice.counter = 0;
+		voice.currentAddr = (voice.startAddr * 8) & (SOUND_RAM_SIZE - 1);
+		memset(voice.samples, 0x00, sizeof(voice.samples));
+		decodeBlock(voice);
+
+		voiceChannelStatus &= ~(1 << v);
+	}
+}
+
+void SPU::keyOff(uint32_t bits)
+{
+	for (int v = 0; v < SPU_VOICE_NUMBER; v++)
+	{
+		spu::Voice& voice = voices[v];
+
+		if ((bits & (1 << v)) && voice.phase != spu::AdsrPhase::Off)
+		{
+			voice.phase = spu::AdsrPhase::Release;
+			voice.adsrCycles = 0;
+		}
+	}
+}
+
+void SPU::updateEnvelope(spu::Voice& voice)
+{
+	spu::adsr& adsr = voice.envelope;
+
+	switch (voice.phase)
+	{
+	case spu::AdsrPhase::Attack:
+		stepEnvelope(voice, adsr.attackMode, false, adsr.attackShift, 7 - adsr.attackStep);
+		if (voice.adsrVolume >= 0x7fff)
+		{
+			voice.phase = spu::AdsrPhase::Decay;
+			voice.adsrCycles = 0;
+		}
 		break;
-	case 0x1f801da6:
-		soundRamDataTransAddr = (uint16_t)data; //Sound RAM Data Transfer Address
+
+	case spu::AdsrPhase::Decay:
+		stepEnvelope(voice, true, true, adsr.decayShift, -8);
+		if (voice.adsrVolume <= (adsr.sustainLevel + 1) * 0x800)
+		{
+			voice.phase = spu::AdsrPhase::Sustain;
+			voice.adsrCycles = 0;
+		}
 		break;
-	case 0x1f801da8:
-		soundRamDataTransFifo = (uint16_t)data;	//Sound RAM Data Transfer Fifo
+
+	case spu::AdsrPhase::Sustain:
+		if (adsr.sustainDirection)
+			stepEnvelope(voice, adsr.sustainMode, true, adsr.sustainShift, -8 + adsr.sustainStep);
+		else
+			stepEnvelope(voice, adsr.sustainMode, false, adsr.sustainShift, 7 - adsr.sustainStep);
 		break;
-	case 0x1f801daa:
-		spuCnt = (uint16_t)data;				//SPU Control Register (SPUCNT)
+
+	case spu::AdsrPhase::Release:
+		stepEnvelope(voice, adsr.releaseMode, true, adsr.releaseShift, -8);
+		if (voice.adsrVolume == 0)
+			voice.phase = spu::AdsrPhase::Off;
 		break;
-	case 0x1f801dac:
-		soundRamDataTransCtrl = (uint16_t)data; //Sound RAM Data Transfer Control
+
+	default:
 		break;
-	case 0x1f801dae:
-		spuStat = (uint16_t)data;				//SPU Status Register (SPUSTAT) (R)
+	}
+}
+
+void SPU::stepEnvelope(spu::Voice& voice, bool exponential, bool decrease, uint8_t shift, int32_t step)
+{
+	if (voice.adsrCycles > 0)
+	{
+		voice.adsrCycles--;
+		return;
+	}
+
+	int32_t cycles = 1 << std::max(0, shift - 11);
+	int32_t delta = step * (1 << std::max(0, 11 - shift));
+
+	//Exponential Increase slows down above 6000h, Exponential Decrease is proportional to the Volume
+	if (exponential && !decrease && voice.adsrVolume > 0x6000)
+		cycles *= 4;
+	if (exponential && decrease)
+		delta = (delta * voice.adsrVolume) >> 15;
+
+	voice.adsrVolume = static_cast<uint16_t>(std::clamp(voice.adsrVolume + delta, 0, 0x7fff));
+	voice.adsrCycles = cycles - 1;
+}
+
+int16_t SPU::updateNoise()
+{
+	int32_t shift = (spuCnt >> 10) & 0x0f;
+	int32_t step = ((spuCnt >> 8) & 0x03) + 4;
+
+	noiseTimer -= step;
+	if (noiseTimer < 0)
+	{
+		uint16_t parity = ((noiseLevel >> 15) ^ (noiseLevel >> 12) ^ (noiseLevel >> 11) ^ (noiseLevel >> 10) ^ 1) & 1;
+		noiseLevel = (noiseLevel << 1) | parity;
+
+		noiseTimer += 0x20000 >> shift;
+		if (noiseTimer < 0)
+			noiseTimer += 0x20000 >> shift;
+	}
+
+	return static_cast<int16_t>(noiseLevel);
+}
+
+void SPU::checkIrq(uint32_t addr, uint32_t size)
+{
+	uint32_t irqAddr = soundRamIrqAddr * 8;
+
+	//IRQ9 is thrown once, until it is acknowledged clearing SPUCNT.6
+	if ((spuCnt & 0x0040) && !(spuStat & 0x0040) && irqAddr >= addr && irqAddr < addr + size)
+	{
+		spuStat |= 0x0040;
+		psx->interrupt->request(static_cast<uint32_t>(interrupt::Cause::spu));
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------
+//
+//                               S O U N D   R A M
+//
+//-----------------------------------------------------------------------------------------------------
+bool SPU::writeRAM(std::span<const uint32_t> data)
+{
+	size_t size = data.size_bytes();
+	const uint8_t* src = reinterpret_cast<const uint8_t*>(data.data());
+
+	while (size > 0)
+	{
+		size_t chunk = std::min<size_t>(size, SOUND_RAM_SIZE - transferAddr);
+		memcpy(soundRam + transferAddr, src, chunk);
+		checkIrq(transferAddr, static_cast<uint32_t>(chunk));
+
+		transferAddr = (transferAddr + chunk) & (SOUND_RAM_SIZE - 1);
+		src += chunk;
+		size -= chunk;
+	}
+
+	return true;
+}
+
+bool SPU::readRAM(std::span<uint32_t> data)
+{
+	size_t size = data.size_bytes();
+	uint8_t* dst = reinterpret_cast<uint8_t*>(data.data());
+
+	while (size > 0)
+	{
+		size_t chunk = std::min<size_t>(size, SOUND_RAM_SIZE - transferAddr);
+		memcpy(dst, soundRam + transferAddr, chunk);
+		checkIrq(transferAddr, static_cast<uint32_t>(chunk));
+
+		transferAddr = (transferAddr + chunk) & (SOUND_RAM_SIZE - 1);
+		dst += chunk;
+		size -= chunk;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------------
+//
+//                               R E G I S T E R S
+//
+//-----------------------------------------------------------------------------------------------------
+bool SPU::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
+{
+	//SPU Registers are 16 bits wide, 32 bits accesses are split in two halves
+	bool result = write16(addr, static_cast<uint16_t>(data));
+	if (bytes == 4)
+		result = write16(addr + 2, static_cast<uint16_t>(data >> 16)) && result;
+
+	LOG_F(3, "SPU - Write to Register:\t\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
+	return result;
+}
+
+uint32_t SPU::readAddr(uint32_t addr, uint8_t bytes)
+{
+	uint32_t data = read16(addr);
+	if (bytes == 4)
+		data |= read16(addr + 2) << 16;
+
+	LOG_F(3, "SPU - Read from Register:\t\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
+	return data;
+}
+
+bool SPU::writeVoice(uint32_t addr, uint16_t data)
+{
+	spu::Voice& voice = voices[(addr - 0x1f801c00) >> 4];
+
+	switch (addr & 0xe)
+	{
+	case 0x0:
+		voice.volumeL = data;					//Volume Left
+		voice.currentVolumeL = fixedVolume(data, voice.currentVolumeL);
 		break;
-	case 0x1f801db0:
-		cdromVolumeL = (uint16_t)data;			//CD Volume Left
+	case 0x2:
+		voice.volumeR = data;					//Volume Right
+		voice.currentVolumeR = fixedVolume(data, voice.currentVolumeR);
 		break;
-	case 0x1f801db2:
-		cdromVolumeR = (uint16_t)data;			//CD Volume Right
+	case 0x4:
+		voice.pitch = data;						//ADPCM Sample Rate
 		break;
-	case 0x1f801db4:
-		externVolumeL = (uint16_t)data;			//Extern Volume Left
+	case 0x6:
+		voice.startAddr = data;					//ADPCM Start Address
 		break;
-	case 0x1f801db6:
-		externVolumeR = (uint16_t)data;			//Extern Volume Right
+	case 0x8:
+		voice.envelope.word = (voice.envelope.word & 0xffff0000) | data;			//ADSR Attack/Decay/Sustain Level
 		break;
-	case 0x1f801db8:
-		currentVolumeL = (uint16_t)data;		//Current Main Volume Left
+	case 0xa:
+		voice.envelope.word = (voice.envelope.word & 0x0000ffff) | (data << 16);	//ADSR Sustain/Release
 		break;
-	case 0x1f801dba:
-		currentVolumeR = (uint16_t)data;		//Current Main Volume Right
+	case 0xc:
+		voice.adsrVolume = data;				//ADSR Current Volume
 		break;
-	case 0x1f801dbc:
-		unknownReg2 = data;						//Unknown
+	case 0xe:
+		voice.repeatAddr = data;				//ADPCM Repeat Address
 		break;
-	
-	default:
-		//LOG_F(ERROR, "SPU - Write Unknown Register:\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
-		return false;
 	}
 
-	LOG_F(3, "SPU - Write to Register:\t\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
 	return true;
 }
 
-uint32_t SPU::readAddr(uint32_t addr, uint8_t bytes)
+uint16_t SPU::readVoice(uint32_t addr)
+{
+	const spu::Voice& voice = voices[(addr - 0x1f801c00) >> 4];
+
+	switch (addr & 0xe)
+	{
+	case 0x0: return voice.volumeL;
+	case 0x2: return voice.volumeR;
+	case 0x4: return voice.pitch;
+	case 0x6: return voice.startAddr;
+	case 0x8: return static_cast<uint16_t>(voice.envelope.word);
+	case 0xa: return static_cast<uint16_t>(voice.envelope.word >> 16);
+	case 0xc: return voice.adsrVolume;
+	default:  return voice.repeatAddr;
+	}
+}
+
+bool SPU::write16(uint32_t addr, uint16_t data)
 {
-	uint32_t data = 0x0;
+	if (addr < 0x1f801d80)
+		return writeVoice(addr, data);
 
-	switch (addr)
+	if (addr >= 0x1f801dc0)
+	{
+		//Reverb Configuration, Voice Current Volumes are Read Only
+		if (addr < 0x1f801e00)
+			reverbConfig[(addr - 0x1f801dc0) >> 1] = data;
+		return true;
+	}
+
+	switch (addr & ~0x1)
 	{
 	case 0x1f801d80:
-		data = mainVolumeL;						//Main Volume Left
+		mainVolumeL = data;						//Main Volume Left
+		currentVolumeL = fixedVolume(data, currentVolumeL);
 		break;
 	case 0x1f801d82:
-		data = mainVolumeR;						//Main Volume Right
+		mainVolumeR = data;						//Main Volume Right
+		currentVolumeR = fixedVolume(data, currentVolumeR);
 		break;
 	case 0x1f801d84:
-		data = reverbVolumeL;					//Reverb Output Volume Left
+		reverbVolumeL = data;					//Reverb Output Volume Left
 		break;
 	case 0x1f801d86:
-		data = reverbVolumeR;					//Reverb Output Volume Right
+		reverbVolumeR = data;					//Reverb Output Volume Right
 		break;
 	case 0x1f801d88:
-		data = voiceKeyOn;						//Voice 0..23 Key ON (Start Attack/Decay/Sustain) (W)
+	case 0x1f801d8a:
+		writeHalf(voiceKeyOn, addr, data);		//Voice 0..23 Key ON (Start Attack/Decay/Sustain) (W)
+		keyOn(data << ((addr & 0x2) * 8));
 		break;
 	case 0x1f801d8c:
-		data = voiceKeyOff;						//Voice 0..23 Key OFF (Start Release) (W)
+	case 0x1f801d8e:
+		writeHalf(voiceKeyOff, addr, data);		//Voice 0..23 Key OFF (Start Release) (W)
+		keyOff(data << ((addr & 0x2) * 8));
 		break;
 	case 0x1f801d90:
-		data = voiceChannelFM;					//Voice 0..23 Channel FM (pitch lfo) mode (R/W)
+	case 0x1f801d92:
+		writeHalf(voiceChannelFM, addr, data);	//Voice 0..23 Channel FM (pitch lfo) mode (R/W)
 		break;
 	case 0x1f801d94:
-		data = voiceChannelNoise;				//Voice 0..23 Channel Noise mode (R/W)
+	case 0x1f801d96:
+		writeHalf(voiceChannelNoise, addr, data);	//Voice 0..23 Channel Noise mode (R/W)
 		break;
 	case 0x1f801d98:
-		data = voiceChannelReverb;				//Voice 0..23 Channel Reverb mode (R/W)
+	case 0x1f801d9a:
+		writeHalf(voiceChannelReverb, addr, data);	//Voice 0..23 Channel Reverb mode (R/W)
 		break;
 	case 0x1f801d9c:
-		data = voiceChannelStatus;				//Voice 0..23 Channel ON/OFF (status) (R)
-		break;
+	case 0x1f801d9e:
+		break;									//Voice 0..23 Channel ON/OFF (status) (R)
 	case 0x1f801da0:
-		data = unknownReg1;						//Unknown
+		unknownReg1 = data;						//Unknown
 		break;
 	case 0x1f801da2:
-		data = soundRamAddr;					//Sound RAM Reverb Work Area Start Address
+		soundRamAddr = data;					//Sound RAM Reverb Work Area Start Address
 		break;
 	case 0x1f801da4:
-		data = soundRamIrqAddr;					//Sound RAM IRQ Address
+		soundRamIrqAddr = data;					//Sound RAM IRQ Address
 		break;
 	case 0x1f801da6:
-		data = soundRamDataTransAddr;			 //Sound RAM Data Transfer Address
+		soundRamDataTransAddr = data;			//Sound RAM Data Transfer Address
+		transferAddr = (data * 8) & (SOUND_RAM_SIZE - 1);
 		break;
 	case 0x1f801da8:
-		data = soundRamDataTransFifo;			//Sound RAM Data Transfer Fifo
+		soundRamDataTransFifo = data;			//Sound RAM Data Transfer Fifo
+		memcpy(soundRam + transferAddr, &data, sizeof(data));
+		checkIrq(transferAddr, sizeof(data));
+		transferAddr = (transferAddr + sizeof(data)) & (SOUND_RAM_SIZE - 1);
 		break;
 	case 0x1f801daa:
-		data = spuCnt;							//SPU Control Register (SPUCNT)
+		spuCnt = data;							//SPU Control Register (SPUCNT)
+
+		//SPUSTAT mirrors the Mode bits and the Transfer Mode, IRQ9 is acknowledged clearing bit 6
+		spuStat = (spuStat & 0x0040) | (spuCnt & 0x003f);
+		if (!(spuCnt & 0x0040))
+			spuStat &= ~0x0040;
+		if ((spuCnt & 0x0030) == 0x0020)
+			spuStat |= 0x0180;					//DMA Write Request
+		if ((spuCnt & 0x0030) == 0x0030)
+			spuStat |= 0x0280;					//DMA Read Request
 		break;
 	case 0x1f801dac:
-		data = soundRamDataTransCtrl;			//Sound RAM Data Transfer Control
+		soundRamDataTransCtrl = data;			//Sound RAM Data Transfer Control
 		break;
 	case 0x1f801dae:
-		data = spuStat;							//SPU Status Register (SPUSTAT) (R)
-		break;
+		break;									//SPU Status Register (SPUSTAT) (R)
 	case 0x1f801db0:
-		data = cdromVolumeL;					//CD Volume Left
+		cdromVolumeL = data;					//CD Volume Left
 		break;
 	case 0x1f801db2:
-		data = cdromVolumeR;					//CD Volume Right
+		cdromVolumeR = data;					//CD Volume Right
 		break;
 	case 0x1f801db4:
-		data = externVolumeL;					//Extern Volume Left
+		externVolumeL = data;					//Extern Volume Left
 		break;
 	case 0x1f801db6:
-		data = externVolumeR;					//Extern Volume Right
+		externVolumeR = data;					//Extern Volume Right
 		break;
 	case 0x1f801db8:
-		data = currentVolumeL;					//Current Main Volume Left
+		currentVolumeL = data;					//Current Main Volume Left
 		break;
 	case 0x1f801dba:
-		data = currentVolumeR;					//Current Main Volume Right
+		currentVolumeR = data;					//Current Main Volume Right
 		break;
 	case 0x1f801dbc:
-		data = unknownReg2;						//Unknown
+	case 0x1f801dbe:
+		writeHalf(unknownReg2, addr, data);		//Unknown
 		break;
 
 	default:
-		//LOG_F(ERROR, "SPU - Read Unknown Register:\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
-		return 0x0;
+		//LOG_F(ERROR, "SPU - Write Unknown Register:\t0x%08x, data: 0x%04x", addr, data);
+		return false;
 	}
 
-	LOG_F(3, "SPU - Read from Register:\t\t0x%08x (%d), data: 0x%08x", addr, bytes, data);
-	return data;
+	return true;
+}
+
+uint16_t SPU::read16(uint32_t addr)
+{
+	if (addr < 0x1f801d80)
+		return readVoice(addr);
+
+	if (addr >= 0x1f801dc0)
+	{
+		if (addr < 0x1f801e00)
+			return reverbConfig[(addr - 0x1f801dc0) >> 1];
+
+		//Voice Current Volumes
+		uint32_t index = (addr - 0x1f801e00) >> 2;
+		if (index >= SPU_VOICE_NUMBER)
+			return 0x0;
+		return (addr & 0x2) ? voices[index].currentVolumeR : voices[index].currentVolumeL;
+	}
+
+	switch (addr & ~0x1)
+	{
+	case 0x1f801d80: return mainVolumeL;
+	case 0x1f801d82: return mainVolumeR;
+	case 0x1f801d84: return static_cast<uint16_t>(reverbVolumeL);
+	case 0x1f801d86: return static_cast<uint16_t>(reverbVolumeR);
+	case 0x1f801d88:
+	case 0x1f801d8a: return readHalf(voiceKeyOn, addr);
+	case 0x1f801d8c:
+	case 0x1f801d8e: return readHalf(voiceKeyOff, addr);
+	case 0x1f801d90:
+	case 0x1f801d92: return readHalf(voiceChannelFM, addr);
+	case 0x1f801d94:
+	case 0x1f801d96: return readHalf(voiceChannelNoise, addr);
+	case 0x1f801d98:
+	case 0x1f801d9a: return readHalf(voiceChannelReverb, addr);
+	case 0x1f801d9c:
+	case 0x1f801d9e: return readHalf(voiceChannelStatus, addr);
+	case 0x1f801da0: return unknownReg1;
+	case 0x1f801da2: return soundRamAddr;
+	case 0x1f801da4: return soundRamIrqAddr;
+	case 0x1f801da6: return soundRamDataTransAddr;
+	case 0x1f801da8: return soundRamDataTransFifo;
+	case 0x1f801daa: return spuCnt;
+	case 0x1f801dac: return soundRamDataTransCtrl;
+	case 0x1f801dae: return spuStat;
+	case 0x1f801db0: return cdromVolumeL;
+	case 0x1f801db2: return cdromVolumeR;
+	case 0x1f801db4: return externVolumeL;
+	case 0x1f801db6: return externVolumeR;
+	case 0x1f801db8: return currentVolumeL;
+	case 0x1f801dba: return currentVolumeR;
+	case 0x1f801dbc:
+	case 0x1f801dbe: return readHalf(unknownReg2, addr);
+
+	default:
+		//LOG_F(ERROR, "SPU - Read Unknown Register:\t0x%08x", addr);
+		return 0x0;
+	}
 }
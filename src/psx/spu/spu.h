@@ -3,20 +3,110 @@
 #include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <array>
+#include <span>
+
+#include "litelib.h"
+#include "device.h"
+
+//SPU Constant Definitions
+constexpr auto SPU_VOICE_NUMBER		= 24;
+constexpr auto SOUND_RAM_SIZE		= 0x80000;		//512 KB
+constexpr auto SPU_SAMPLE_RATE		= 44100;		//Output Sample Rate
+constexpr auto SPU_SAMPLE_CYCLES	= 768;			//CPU Cycles per Sample (33.8688 MHz / 44.1 KHz)
+constexpr auto SPU_BLOCK_SAMPLES	= 32;			//Samples mixed in one pass over all the Voices
+constexpr auto SPU_OUTPUT_SIZE		= 0x4000;		//Output Ring, interleaved Left/Right Samples (power of two)
+
+namespace spu
+{
+	union adsr
+	{
+		uint32_t		word;
+
+		lite::bitfield<0, 4>	sustainLevel;		//Sustain Level ((N+1)*800h)
+		lite::bitfield<4, 4>	decayShift;			//Decay Shift (0..0Fh = Fast..Slow)
+		lite::bitfield<8, 2>	attackStep;			//Attack Step (0..3 = "+7,+6,+5,+4")
+		lite::bitfield<10, 5>	attackShift;		//Attack Shift (0..1Fh = Fast..Slow)
+		lite::bitfield<15, 1>	attackMode;			//Attack Mode (0=Linear, 1=Exponential)
+		lite::bitfield<16, 5>	releaseShift;		//Release Shift (0..1Fh = Fast..Slow)
+		lite::bitfield<21, 1>	releaseMode;		//Release Mode (0=Linear, 1=Exponential)
+		lite::bitfield<22, 2>	sustainStep;		//Sustain Step (0..3 = "+7,+6,+5,+4" or "-8,-7,-6,-5")
+		lite::bitfield<24, 5>	sustainShift;		//Sustain Shift (0..1Fh = Fast..Slow)
+		lite::bitfield<30, 1>	sustainDirection;	//Sustain Direction (0=Increase, 1=Decrease)
+		lite::bitfield<31, 1>	sustainMode;		//Sustain Mode (0=Linear, 1=Exponential)
+	};
+
+	enum class AdsrPhase : uint8_t { Off, Attack, Decay, Sustain, Release };
+
+	struct Voice
+	{
+		//Voice Registers
+		uint16_t	volumeL;		//0x1f801c00+N*10h, Volume Left
+		uint16_t	volumeR;		//0x1f801c02+N*10h, Volume Right
+		uint16_t	pitch;			//0x1f801c04+N*10h, ADPCM Sample Rate
+		uint16_t	startAddr;		//0x1f801c06+N*10h, ADPCM Start Address (8 bytes units)
+		adsr		envelope;		//0x1f801c08+N*10h, ADSR Attack/Decay/Sustain/Release
+		uint16_t	adsrVolume;		//0x1f801c0c+N*10h, ADSR Current Volume
+		uint16_t	repeatAddr;		//0x1f801c0e+N*10h, ADPCM Repeat Address (8 bytes units)
+		int16_t		currentVolumeL;	//0x1f801e00+N*04h, Current Volume Left
+		int16_t		currentVolumeR;	//0x1f801e02+N*04h, Current Volume Right
+
+		//Internal State
+		AdsrPhase	phase;
+		int32_t		adsrCycles;		//Samples left before the next Envelope step
+		uint32_t	currentAddr;	//Sound RAM Address of the ADPCM Block being played
+		uint32_t	counter;		//Pitch Counter, sample index in the Block with 12 bits of fraction
+		uint8_t		blockFlags;		//Loop Flags of the ADPCM Block being played
+		int16_t		samples[31];	//Last 3 Samples of the previous Block followed by the 28 decoded ones
+	};
+}
 
 class Psx;
 
-class SPU
+class SPU : public Device
 {
 public:
 	SPU();
 	~SPU();
 
+	bool reset();
+	bool runTicks(uint32_t cycles) override;
+	bool serialize(SaveState& state) override;
+
 	bool writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes);
 	uint32_t readAddr(uint32_t addr, uint8_t bytes);
 
+	//DMA Channel 4 Bursts, Sound RAM is accessed from the Transfer Address on
+	bool writeRAM(std::span<const uint32_t> data);
+	bool readRAM(std::span<uint32_t> data);
+
+	//Mixed Output, interleaved Left/Right Samples. Called by the Audio thread, returns the number of values read
+	size_t readSamples(int16_t* data, size_t count);
+
+	//Output Ring Status, safe from any thread
+	size_t getOutputLevel() const { return output.length(); }
+	uint64_t getOutputUnderruns() const { return output.underruns(); }
+	uint64_t getOutputOverruns() const { return output.overruns(); }
+
 	//Connect to PSX Instance
-	void link(Psx* instance) { psx = instance; }
+	void link(Psx* instance) override { psx = instance; }
+
+private:
+	bool write16(uint32_t addr, uint16_t data);
+	uint16_t read16(uint32_t addr);
+	bool writeVoice(uint32_t addr, uint16_t data);
+	uint16_t readVoice(uint32_t addr);
+
+	void keyOn(uint32_t voices);
+	void keyOff(uint32_t voices);
+	void mixBlock(uint32_t count);
+	void renderVoice(int v, const int16_t* noise, uint32_t count);
+	void nextBlock(int v);
+	void decodeBlock(spu::Voice& voice);
+	void updateEnvelope(spu::Voice& voice);
+	void stepEnvelope(spu::Voice& voice, bool exponential, bool decrease, uint8_t shift, int32_t step);
+	int16_t updateNoise();
+	void checkIrq(uint32_t addr, uint32_t size);
 
 private:
 	//Link to Bus Object
@@ -48,5 +138,19 @@ private:
 	uint16_t currentVolumeL;		//0x1f801db8
 	uint16_t currentVolumeR;		//0x1f801dba
 	uint32_t unknownReg2;			//0x1f801dbc
-};
+	uint16_t reverbConfig[0x20];	//0x1f801dc0..0x1f801dff
+
+	//Voices and Sound RAM
+	std::array<spu::Voice, SPU_VOICE_NUMBER>	voices;
+	uint8_t		soundRam[SOUND_RAM_SIZE];
+	uint32_t	transferAddr;		//Current Sound RAM Transfer Address
+	uint32_t	sampleCycles;		//CPU Cycles accumulated toward the next Sample
+	int32_t		noiseTimer;
+	uint16_t	noiseLevel;
 
+	//Voice Outputs of the Block being mixed, after the Envelope. Also the source of Pitch Modulation
+	alignas(32) int16_t voiceOutput[SPU_VOICE_NUMBER][SPU_BLOCK_SAMPLES];
+
+	//Filled by the emulation thread and drained by the Audio thread, never blocks either side
+	lite::spscring<int16_t, SPU_OUTPUT_SIZE>	output;
+};
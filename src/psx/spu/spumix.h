@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#include "spu.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SPU_SSE2
+#endif
+
+//Voice Mixing, the scalar version is the reference the SIMD ones have to match bit exact.
+//Samples and Mix buffers hold a whole Block and are 32 bytes aligned
+
+//Accumulate a whole Block of one Voice into the Left/Right Mix, one Sample at a time
+static inline void mixVoiceScalar(const int16_t* samples, int16_t volumeL, int16_t volumeR, int32_t* mixL, int32_t* mixR)
+{
+	for (int i = 0; i < SPU_BLOCK_SAMPLES; i++)
+	{
+		mixL[i] += (samples[i] * volumeL) >> 15;
+		mixR[i] += (samples[i] * volumeR) >> 15;
+	}
+}
+
+#ifdef SPU_SSE2
+//mix += (samples * volume) >> 15 for 8 Samples, full 32 bits products from the 16 bits low and high halves
+static inline void mixProducts(__m128i samples, __m128i volume, int32_t* mix)
+{
+	__m128i lo = _mm_mullo_epi16(samples, volume);
+	__m128i hi = _mm_mulhi_epi16(samples, volume);
+	__m128i* dst = reinterpret_cast<__m128i*>(mix);
+
+	_mm_store_si128(dst, _mm_add_epi32(_mm_load_si128(dst), _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15)));
+	_mm_store_si128(dst + 1, _mm_add_epi32(_mm_load_si128(dst + 1), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15)));
+}
+#endif
+
+//Accumulate a whole Block of one Voice into the Left/Right Mix
+static inline void mixVoice(const int16_t* samples, int16_t volumeL, int16_t volumeR, int32_t* mixL, int32_t* mixR)
+{
+#if defined(__AVX2__)
+	const __m256i volL = _mm256_set1_epi32(volumeL);
+	const __m256i volR = _mm256_set1_epi32(volumeR);
+
+	for (int i = 0; i < SPU_BLOCK_SAMPLES; i += 8)
+	{
+		__m256i s = _mm256_cvtepi16_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(samples + i)));
+		__m256i* l = reinterpret_cast<__m256i*>(mixL + i);
+		__m256i* r = reinterpret_cast<__m256i*>(mixR + i);
+
+		_mm256_store_si256(l, _mm256_add_epi32(_mm256_load_si256(l), _mm256_srai_epi32(_mm256_mullo_epi32(s, volL), 15)));
+		_mm256_store_si256(r, _mm256_add_epi32(_mm256_load_si256(r), _mm256_srai_epi32(_mm256_mullo_epi32(s, volR), 15)));
+	}
+#elif defined(SPU_SSE2)
+	const __m128i volL = _mm_set1_epi16(volumeL);
+	const __m128i volR = _mm_set1_epi16(volumeR);
+
+	for (int i = 0; i < SPU_BLOCK_SAMPLES; i += 8)
+	{
+		__m128i s = _mm_load_si128(reinterpret_cast<const __m128i*>(samples + i));
+
+		mixProducts(s, volL, mixL + i);
+		mixProducts(s, volR, mixR + i);
+	}
+#else
+	mixVoiceScalar(samples, volumeL, volumeR, mixL, mixR);
+#endif
+}
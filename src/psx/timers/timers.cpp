@@ -1,5 +1,7 @@
 #include <loguru.hpp>
+#include <algorithm>
 #include "timers.h"
+#include "profiler.h"
 #include "psx.h"
 #include "gpu.h"
 
@@ -11,12 +13,13 @@ Timers::Timers()
 		e.counterValue = 0x0;
 		e.counterTarget = 0x0;
 		e.counterMode.word = 0x0;
+		e.clockSource = ClockSource::System;
+		e.toTarget = false;
+		e.toOverflow = false;
+		e.irqDone = false;
 	}
 
-	//Init Pulse Duration Counters
-	pulseDuration[0] = PULSE_DURATION;
-	pulseDuration[1] = PULSE_DURATION;
-	pulseDuration[2] = PULSE_DURATION;
+	clockTicks = 0;
 }
 
 Timers::~Timers()
@@ -31,250 +34,272 @@ bool Timers::reset()
 		e.counterValue = 0x0;
 		e.counterTarget = 0x0;
 		e.counterMode.word = 0x0;
+		e.clockSource = ClockSource::System;
+		e.toTarget = false;
+		e.toOverflow = false;
+		e.irqDone = false;
 	}
 
+	clockTicks = 0;
+
 	return true;
 }
 
-bool Timers::execute(ClockSource source)
+bool Timers::serialize(SaveState& state)
 {
-	//Update Timers according to Clock Source
+	state.section("TMR ");
+	serializeSync(state);
+
+	state.value(timerStatus);
+	state.value(clockTicks);
 
-	switch (source)
+	return state.isValid();
+}
+
+bool Timers::execute(ClockSource source, uint32_t ticks)
+{
+	//Dot and hBlank Clocks are delivered by the GPU, possibly many ticks at once
+	for (uint8_t i = 0; i < TIMER_NUMBER; i++)
 	{
-	case ClockSource::System:
-		if (timerStatus[0].clockSource == ClockSource::System) updateTimer0();
-		if (timerStatus[1].clockSource == ClockSource::System) updateTimer1();
-		if (timerStatus[2].clockSource == ClockSource::System) updateTimer2();
-		break;
+		if (timerStatus[i].clockSource == source)
+			advanceTimer(i, ticks);
+	}
 
-	case ClockSource::System8:
-		if (timerStatus[2].clockSource == ClockSource::System8) updateTimer2();
-		break;
+	return true;
+}
 
-	case ClockSource::Dot:
-		if (timerStatus[0].clockSource == ClockSource::Dot) updateTimer0();
-		break;
+bool Timers::runTicks(uint32_t cycles)
+{
+	PROFILE_ZONE(ProfileZone::Timers);
 
-	case ClockSource::hBlank:
-		if (timerStatus[1].clockSource == ClockSource::hBlank) updateTimer1();
-		break;
-		
-	default:
-		LOG_F(ERROR, "TMR - Unknown Clock Source!");
+	//System8 Clock ticks on every 8th System Clock
+	uint32_t ticks8 = static_cast<uint32_t>((clockTicks + cycles + 7) / 8 - (clockTicks + 7) / 8);
+	clockTicks += cycles;
+
+	for (uint8_t i = 0; i < TIMER_NUMBER; i++)
+	{
+		if (timerStatus[i].clockSource == ClockSource::System)
+			advanceTimer(i, cycles);
+		else if (timerStatus[i].clockSource == ClockSource::System8)
+			advanceTimer(i, ticks8);
 	}
 
-	//Update Interrupt Signals
-	updateInterrupt(0);
-	updateInterrupt(1);
-	updateInterrupt(2);
+	//Counters are otherwise evaluated only when read, wake up on the first crossing raising an IRQ
+	uint64_t next = SCHEDULER_NEVER;
+	for (uint8_t i = 0; i < TIMER_NUMBER; i++)
+	{
+		uint64_t ticks = ticksToInterrupt(i);
+		if (ticks == SCHEDULER_NEVER)
+			continue;
+
+		if (timerStatus[i].clockSource == ClockSource::System)
+			next = std::min(next, ticks);
+		else if (timerStatus[i].clockSource == ClockSource::System8)
+			next = std::min(next, (8 - clockTicks % 8) % 8 + (ticks - 1) * 8 + 1);
+	}
+
+	//Counters stand at syncClock, which lags the Master Clock when a blanking edge is reported by the GPU
+	if (next != SCHEDULER_NEVER)
+		psx->scheduler->scheduleAt(SchedulerEvent::Timers, syncClock + next);
+	else
+		psx->scheduler->cancel(SchedulerEvent::Timers);
 
 	return true;
 }
 
-void Timers::updateTimer0()
+bool Timers::usesClock(ClockSource source) const
 {
-	//UPDATE Counter 0
-	if ((bool)timerStatus[0].counterMode.syncEn)
+	for (auto& e : timerStatus)
 	{
-		//Sync Enable
-		// - Counter is update according to selected clock source
-		//			0 or 2 = System Clock
-		//			1 or 3 = Dot Clock
-		// - Counter is Synced according to Sync Mode value:
-		//			0 = Pause counter during hBlank(s)
-		//			1 = Reset counter to 0000h at hBlank(s)
-		//			2 = Reset counter to 0000h at hBlank(s) and pause outside of hBlank
-		//			3 = Pause until hBlank(s) occurs once, then switch to Free Run
-		//  - Counter is reset to 0x0000 according to Reset Zero setting:
-		//			0 = after counter reach 0xfffff, 1 = after counter reach Counter Target
-		//
-		switch (timerStatus[0].counterMode.syncMode)
-		{
-		case 0:
-			if (!psx->gpu->hBlank) timerStatus[0].counterValue++;
-			break;
-		case 1:
-			timerStatus[0].counterValue++;
-			if (psx->gpu->hBlank) timerStatus[0].counterValue = 0x0000;
-			break;
-		case 2:
-			if (psx->gpu->hBlank) timerStatus[0].counterValue++; ///DA VERIFICARE, NON HA SENSO
-			if (psx->gpu->hBlank) timerStatus[0].counterValue = 0x0000; //CHECK - hBlank should be active only at the end of visible area?
-			break;
-		case 3:
-			if (psx->gpu->hBlank) timerStatus[0].counterMode.syncEn = false;
-			break;
+		if (e.clockSource == source)
+			return true;
+	}
+	return false;
+}
 
-		default:
-			LOG_F(ERROR, "TIMER - Unknown Sync Mode!");
-		}
+void Timers::advanceTimer(uint8_t timerNumber, uint32_t ticks)
+{
+	countTicks(timerNumber, syncTicks(timerNumber, ticks));
+}
 
-		if (static_cast<bool>(timerStatus[0].counterMode.resetZero))
-		{
-			if (timerStatus[0].counterValue > timerStatus[0].counterTarget)
-			{
-				timerStatus[0].counterValue = 0x0000;
-				timerStatus[0].counterTarget = true;
-			}
-		}
-		else
-		{
-			if (timerStatus[0].counterValue > 0xffff)
-			{
-				timerStatus[0].counterValue = 0x0000;
-				timerStatus[0].toOverflow = true;
-			}
-		}
+uint32_t Timers::syncTicks(uint8_t timerNumber, uint32_t ticks)
+{
+	TimerStatus& timer = timerStatus[timerNumber];
+
+	//Sync Disabled (aka Free Run)
+	if (!(bool)timer.counterMode.syncEn || ticks == 0)
+		return ticks;
+
+	//Counter 2 Sync Modes:
+	//			0 or 3 = Stop counter at current value (forever, no h/v-blank start)
+	//			1 or 2 = Free Run (same as when Synchronization Disabled)
+	if (timerNumber == 2)
+		return (timer.counterMode.syncMode == 1 || timer.counterMode.syncMode == 2) ? ticks : 0;
+
+	//Counter 0 Sync Modes (Counter 1 same as Counter 0, but using vBlank instead of hBlank):
+	//			0 = Pause counter during hBlank(s)
+	//			1 = Reset counter to 0000h at hBlank(s)
+	//			2 = Reset counter to 0000h at hBlank(s) and pause outside of hBlank
+	//			3 = Pause until hBlank(s) occurs once, then switch to Free Run
+	//The GPU syncs the Counters on every blanking edge, its state is the same for all the ticks since the last sync.
+	//Resets and the switch to Free Run happen on the edge, see blankEdge()
+	bool blank = (timerNumber == 0) ? psx->gpu->hBlank : psx->gpu->vBlank;
+
+	switch (timer.counterMode.syncMode)
+	{
+	case 0:
+		return blank ? 0 : ticks;
+
+	case 1:
+		return ticks;
+
+	case 2:
+		return blank ? ticks : 0;
+
+	case 3:
+		//Mode written during blanking, no edge will be seen before the next one
+		if (!blank)
+			return 0;
+		timer.counterMode.syncEn = false;
+		return ticks;
 	}
-	else
+
+	return ticks;
+}
+
+// Blanking edge (hBlank for Counter 0, vBlank for Counter 1) reported by the GPU at the given Master Clock.
+// Counters are run up to the edge with the old blanking state, then the Sync Mode acts on the new one.
+void Timers::blankEdge(uint8_t timerNumber, bool blank, uint64_t clock)
+{
+	TimerStatus& timer = timerStatus[timerNumber];
+
+	if (!(bool)timer.counterMode.syncEn)
+		return;
+
+	if (clock > syncClock)
+		syncTo(clock);
+
+	if (!blank)
+		return;
+
+	switch (timer.counterMode.syncMode)
 	{
-		//Sync Disabled (aka Free Run)
-		// - Counter is update according to selected clock source
-		//			0 or 2 = System Clock
-		//			1 or 3 = Dot Clock
-		// - Counter if always reset when reach 0xffff
-		timerStatus[0].counterValue++;
-		if (timerStatus[0].counterValue > 0xffff)
-		{
-			timerStatus[0].counterValue = 0x0000;
-			timerStatus[0].toOverflow = true;
-		}
+	case 1:
+	case 2:
+		timer.counterValue = 0x0000;
+		break;
+
+	case 3:
+		timer.counterMode.syncEn = false;
+		break;
 	}
+
+	//Next IRQ moves with the Counter
+	runTicks(0);
 }
 
-void Timers::updateTimer1()
+void Timers::countTicks(uint8_t timerNumber, uint32_t ticks)
 {
-	//UPDATE Counter 1
-	if ((bool)timerStatus[1].counterMode.syncEn)
+	TimerStatus& timer = timerStatus[timerNumber];
+
+	while (ticks > 0)
 	{
-		//Sync Enable
-		// - Counter is update according to selected clock source
-		//			0 or 2 = System Clock
-		//			1 or 3 = hBlank
-		// - Counter is Synced according to Sync Mode value:
-		//			0 = Pause counter during vBlank(s)
-		//			1 = Reset counter to 0000h at vBlank(s)
-		//			2 = Reset counter to 0000h at vBlank(s) and pause outside of vBlank
-		//			3 = Pause until vBlank(s) occurs once, then switch to Free Run
-		//  - Counter is reset to 0x0000 according to Reset Zero setting:
-		//			0 = after counter reach 0xfffff, 1 = after counter reach Counter Target
-		//
-		switch (timerStatus[1].counterMode.syncMode)
+		//Whole laps bring the counter back to the same value, reaching Target (and 0xffff) once per lap.
+		//Each crossing raising an IRQ counts, Toggle Mode depends on how many of them there were
+		bool resetZero = static_cast<bool>(timer.counterMode.resetZero);
+		uint32_t period = resetZero ? timer.counterTarget + 1 : 0x10000;
+		if (ticks >= period && (!resetZero || timer.counterValue <= timer.counterTarget))
 		{
-		case 0:
-			if (!psx->gpu->vBlank) timerStatus[1].counterValue++;
-			break;
-		case 1:
-			timerStatus[1].counterValue++;
-			if (psx->gpu->vBlank) timerStatus[1].counterValue = 0x0000;
-			break;
-		case 2:
-			if (psx->gpu->vBlank) timerStatus[0].counterValue++; ///DA VERIFICARE, NON HA SENSO
-			if (psx->gpu->vBlank) timerStatus[1].counterValue = 0x0000; //CHECK - vBlank shoult be active only at the end of visible area?
-			break;
-		case 3:
-			if (psx->gpu->vBlank) timerStatus[1].counterMode.syncEn = false;
-			break;
+			uint32_t laps = ticks / period;
+			ticks %= period;
 
-		default:
-			LOG_F(ERROR, "TIMER - Unknown Sync Mode!");
-		}
+			bool overflow = (period == 0x10000);
+			bool irqTarget = static_cast<bool>(timer.counterMode.irqTarget);
+			bool irqOverflow = overflow && static_cast<bool>(timer.counterMode.irqOverflow);
+			uint32_t crossings = (irqTarget && irqOverflow && timer.counterTarget == 0xffff) ? 1 : (uint32_t)irqTarget + (uint32_t)irqOverflow;
 
-		if (static_cast<bool>(timerStatus[1].counterMode.resetZero))
-		{
-			if (timerStatus[1].counterValue > timerStatus[1].counterTarget)
+			timer.counterMode.isTarget = true;
+			timer.toTarget = irqTarget;
+			if (overflow)
 			{
-				timerStatus[1].counterValue = 0x0000;
-				timerStatus[1].counterTarget = true;
+				timer.counterMode.isOverflow = true;
+				timer.toOverflow = irqOverflow;
 			}
+			updateInterrupt(timerNumber, laps * crossings);
+			continue;
 		}
-		else
+
+		//Move in bulk up to the next Target, 0xffff or wrap around
+		uint32_t stop = timer.counterValue;
+		uint32_t step = nextStop(timer, stop);
+		if (step > ticks)
 		{
-			if (timerStatus[1].counterValue > 0xffff)
-			{
-				timerStatus[1].counterValue = 0x0000;
-				timerStatus[1].toOverflow = true;
-			}
+			timer.counterValue += ticks;
+			return;
 		}
-	}
-	else
-	{
-		//Sync Disabled (aka Free Run)
-		// - Counter is update according to selected clock source
-		//			0 or 2 = System Clock
-		//			1 or 3 = hBlank
-		// - Counter if always reset when reach 0xffff
-		timerStatus[1].counterValue++;
-		if (timerStatus[1].counterValue > 0xffff)
+		timer.counterValue = stop;
+		ticks -= step;
+
+		if (timer.counterValue == timer.counterTarget)
+		{
+			timer.counterMode.isTarget = true;
+			timer.toTarget = static_cast<bool>(timer.counterMode.irqTarget);
+		}
+		if (timer.counterValue == 0xffff)
 		{
-			timerStatus[1].counterValue = 0x0000;
-			timerStatus[1].toOverflow = true;
+			timer.counterMode.isOverflow = true;
+			timer.toOverflow = static_cast<bool>(timer.counterMode.irqOverflow);
 		}
+		updateInterrupt(timerNumber);
 	}
 }
 
-void Timers::updateTimer2()
+// Moves value to the next one the counter has to stop at: Target, 0xffff or the wrap around to 0x0000.
+// Counter is reset to 0x0000 after Target when Reset Zero is set and it has not already gone past it.
+// Returns the number of ticks to get there.
+uint32_t Timers::nextStop(const TimerStatus& timer, uint32_t& value) const
 {
-	//UPDATE Counter 2
-	if ((bool)timerStatus[2].counterMode.syncEn)
+	uint32_t last = ((bool)timer.counterMode.resetZero && value <= timer.counterTarget) ? timer.counterTarget : 0xffff;
+
+	if (value >= last)
 	{
-		//Sync Enable
-		// - Counter is update according to selected clock source
-		//			0 or 1 = System Clock
-		//			2 or 3 = System Clock / 8
-		// - Counter is Synced according to Sync Mode value:
-		//			0 or 3 = Stop counter at current value (forever, no h/v-blank start)
-		//			1 or 2 = Free Run (same as when Synchronization Disabled)
-		//  - Counter is reset to 0x0000 according to Reset Zero setting:
-		//			0 = after counter reach 0xfffff, 1 = after counter reach Counter Target
-		//
-		switch (timerStatus[2].counterMode.syncMode)
-		{
-		case 0:
-		case 3:
-			break;
+		value = 0x0000;
+		return 1;
+	}
 
-		case 1:
-		case 2:
-			timerStatus[2].counterValue++;
-			break;
-		
-		default:
-			LOG_F(ERROR, "TIMER - Unknown Sync Mode!");
-		}
+	uint32_t stop = (timer.counterTarget > value) ? std::min(timer.counterTarget, last) : last;
+	uint32_t ticks = stop - value;
+	value = stop;
 
-		if (static_cast<bool>(timerStatus[2].counterMode.resetZero))
-		{
-			if (timerStatus[2].counterValue > timerStatus[2].counterTarget)
-			{
-				timerStatus[2].counterValue = 0x0000;
-				timerStatus[2].counterTarget = true;
-			}
-		}
-		else
-		{
-			if (timerStatus[2].counterValue > 0xffff)
-			{
-				timerStatus[2].counterValue = 0x0000;
-				timerStatus[2].toOverflow = true;
-			}
-		}
-	}
-	else
+	return ticks;
+}
+
+// Ticks of the counter clock before the next Target or 0xffff crossing raising an IRQ,
+// SCHEDULER_NEVER if the counter can not raise any.
+uint64_t Timers::ticksToInterrupt(uint8_t timerNumber) const
+{
+	const TimerStatus& timer = timerStatus[timerNumber];
+	bool irqTarget = static_cast<bool>(timer.counterMode.irqTarget);
+	bool irqOverflow = static_cast<bool>(timer.counterMode.irqOverflow);
+
+	if (!(irqTarget || irqOverflow) || (!(bool)timer.counterMode.irqRepeat && timer.irqDone))
+		return SCHEDULER_NEVER;
+
+	//Counter 2 stopped forever by its Sync Mode
+	if (timerNumber == 2 && (bool)timer.counterMode.syncEn && (timer.counterMode.syncMode == 0 || timer.counterMode.syncMode == 3))
+		return SCHEDULER_NEVER;
+
+	//Any value is reached within four stops: Target, 0xffff, wrap around and Target again
+	uint32_t value = timer.counterValue;
+	uint64_t ticks = 0;
+	for (int i = 0; i < 4; i++)
 	{
-		//Sync Disabled (aka Free Run)
-		// - Counter is update according to selected clock source
-		//			0 or 1 = System Clock
-		//			2 or 3 = System Clock / 8
-		// - Counter if always reset when reach 0xffff
-		timerStatus[2].counterValue++;
-		if (timerStatus[2].counterValue > 0xffff)
-		{
-			timerStatus[2].counterValue = 0x0000;
-			timerStatus[2].toOverflow = true;
-		}
+		ticks += nextStop(timer, value);
+		if ((irqTarget && value == timer.counterTarget) || (irqOverflow && value == 0xffff))
+			return ticks;
 	}
+
+	return SCHEDULER_NEVER;
 }
 
 bool Timers::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
@@ -313,7 +338,7 @@ bool Timers::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
 		break;
 
 	case 0x1f801104:	//----------------------------Counter Mode 0
-		timerStatus[0].counterMode.word = data & 0x0000ffff;
+		timerStatus[0].counterMode.word = data & 0x000003ff;		//Bits 10-12 are Read Only
 		timerStatus[0].counterValue = 0x00000000;		//Counter Value is forcefully reset to 0x0000 on any write to Counter Mode 
 		timerStatus[0].counterMode.irqRequest = true;	//Interrupt Request is set at every Write (false = Yes, true = No)
 
@@ -325,6 +350,7 @@ bool Timers::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
 		
 		timerStatus[0].toTarget = false;
 		timerStatus[0].toOverflow = false;
+		timerStatus[0].irqDone = false;
 		break;
 
 	case 0x1f801108:	//----------------------------Counter Target 0
@@ -337,7 +363,7 @@ bool Timers::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
 		break;
 
 	case 0x1f801114:	//----------------------------Counter Mode 1
-		timerStatus[1].counterMode.word = data & 0x0000ffff;
+		timerStatus[1].counterMode.word = data & 0x000003ff;		//Bits 10-12 are Read Only
 		timerStatus[1].counterValue = 0x00000000;		//Counter Value is forcefully reset to 0x0000 on any write to Counter Mode 
 		timerStatus[1].counterMode.irqRequest = true;	//Interrupt Request is set at every Write (false = Yes, true = No)
 
@@ -349,6 +375,7 @@ bool Timers::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
 		
 		timerStatus[1].toTarget = false;
 		timerStatus[1].toOverflow = false;
+		timerStatus[1].irqDone = false;
 		break;
 
 	case 0x1f801118:	//----------------------------Counter Target 1
@@ -361,7 +388,7 @@ bool Timers::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
 		break;
 
 	case 0x1f801124:	//----------------------------Counter Mode 2
-		timerStatus[2].counterMode.word = data & 0x0000ffff;
+		timerStatus[2].counterMode.word = data & 0x000003ff;		//Bits 10-12 are Read Only
 		timerStatus[2].counterValue = 0x00000000;		//Counter Value is forcefully reset to 0x0000 on any write to Counter Mode 
 		timerStatus[2].counterMode.irqRequest = true;	//Interrupt Request is set at every Write (false = Yes, true = No)
 
@@ -373,10 +400,11 @@ bool Timers::writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes)
 		
 		timerStatus[2].toTarget = false;
 		timerStatus[2].toOverflow = false;
+		timerStatus[2].irqDone = false;
 		break;
 
 	case 0x1f801128:	//----------------------------Counter Target 2
-		timerStatus[1].counterTarget = data & 0x0000ffff;
+		timerStatus[2].counterTarget = data & 0x0000ffff;
 		break;
 
 	default:
@@ -401,6 +429,8 @@ uint32_t Timers::readAddr(uint32_t addr, uint8_t bytes)
 
 	case 0x1f801104:
 		data = timerStatus[0].counterMode.word;
+		timerStatus[0].counterMode.isTarget = false;	//Reached flags are reset after Reading
+		timerStatus[0].counterMode.isOverflow = false;
 		break;
 
 	case 0x1f801108:
@@ -414,6 +444,8 @@ uint32_t Timers::readAddr(uint32_t addr, uint8_t bytes)
 
 	case 0x1f801114:
 		data = timerStatus[1].counterMode.word;
+		timerStatus[1].counterMode.isTarget = false;	//Reached flags are reset after Reading
+		timerStatus[1].counterMode.isOverflow = false;
 		break;
 
 	case 0x1f801118:
@@ -427,6 +459,8 @@ uint32_t Timers::readAddr(uint32_t addr, uint8_t bytes)
 
 	case 0x1f801124:
 		data = timerStatus[2].counterMode.word;
+		timerStatus[2].counterMode.isTarget = false;	//Reached flags are reset after Reading
+		timerStatus[2].counterMode.isOverflow = false;
 		break;
 
 	case 0x1f801128:
@@ -442,118 +476,42 @@ uint32_t Timers::readAddr(uint32_t addr, uint8_t bytes)
 	return data;
 }
 
-void Timers::updateInterrupt(uint8_t timerNumber)
+// Applies the given number of IRQ raising crossings, all happened since the last call.
+void Timers::updateInterrupt(uint8_t timerNumber, uint32_t crossings)
 {
-	bool toggleMode = (bool)timerStatus[timerNumber].counterMode.irqToggle;
-	bool repeatMode = (bool)timerStatus[timerNumber].counterMode.irqRepeat;
-	bool isTarget = (bool)timerStatus[timerNumber].counterMode.isTarget;
-	bool isOverflow = (bool)timerStatus[timerNumber].counterMode.isOverflow;
-	bool triggerTarget = timerStatus[timerNumber].toTarget;
-	bool triggerOverflow = timerStatus[timerNumber].toOverflow;
+	TimerStatus& timer = timerStatus[timerNumber];
 	bool throwInterrupt = false;
 
-	if (toggleMode)
-	{
-		//Toggle Mode
-		if (repeatMode)
-		{
-			//Repeat Mode
-			if (isTarget & triggerTarget)
-			{
-				timerStatus[timerNumber].counterMode.irqRequest = (bool)(timerStatus[timerNumber].counterMode.irqRequest) ? false : true;
-				timerStatus[timerNumber].toTarget = false;
-				throwInterrupt = !(bool)timerStatus[timerNumber].counterMode.irqRequest;
-			}
+	if (!timer.toTarget && !timer.toOverflow)
+		return;
 
-			if (isOverflow & triggerOverflow)
-			{
-				timerStatus[timerNumber].counterMode.irqRequest = (bool)(timerStatus[timerNumber].counterMode.irqRequest) ? false : true;
-				timerStatus[timerNumber].toOverflow = false;
-				throwInterrupt = !(bool)timerStatus[timerNumber].counterMode.irqRequest;
-			}
-				
-		}
-		else
-		{
-			//Once Mode
-			if (isTarget & triggerTarget)
-			{
-				timerStatus[timerNumber].counterMode.irqRequest = false;
-				timerStatus[timerNumber].toTarget = false;
-				throwInterrupt = true;
-			}
+	timer.toTarget = false;
+	timer.toOverflow = false;
 
-			if (isOverflow & triggerOverflow)
-			{
-				timerStatus[timerNumber].counterMode.irqRequest = false;
-				timerStatus[timerNumber].toOverflow = false;
-				throwInterrupt = true;
-			}
-		}
+	//One-shot Mode throws a single IRQ after each Counter Mode write
+	if (!(bool)timer.counterMode.irqRepeat)
+	{
+		if (timer.irqDone)
+			return;
+		crossings = 1;
+	}
+
+	if ((bool)timer.counterMode.irqToggle)
+	{
+		//Toggle Mode, IRQ is thrown when bit10 goes to 0, which happens at least once on two or more toggles
+		throwInterrupt = (bool)timer.counterMode.irqRequest || crossings > 1;
+		if (crossings & 1)
+			timer.counterMode.irqRequest = !(bool)timer.counterMode.irqRequest;
 	}
 	else
 	{
-		//Pulse Mode
-		if (repeatMode)
-		{
-			if (timerStatus[timerNumber].counterMode.irqRequest = false)
-			{
-				pulseDuration[timerNumber]--;
-				if (pulseDuration == 0)
-					timerStatus[timerNumber].counterMode.irqRequest = true;
-				return;
-			}
-
-			//Repeat Mode
-			if (isTarget & triggerTarget)
-			{
-				timerStatus[timerNumber].counterMode.irqRequest = false;
-				pulseDuration[timerNumber] = PULSE_DURATION;
-				timerStatus[timerNumber].toTarget = false;
-				throwInterrupt = true;
-			}
-
-			if (isOverflow & triggerOverflow)
-			{
-				timerStatus[timerNumber].counterMode.irqRequest = false;
-				pulseDuration[timerNumber] = PULSE_DURATION;
-				timerStatus[timerNumber].toOverflow = false;
-				throwInterrupt = true;
-			}
-		}
-		else
-		{
-			if (timerStatus[timerNumber].counterMode.irqRequest = false)
-			{
-				pulseDuration[timerNumber]--;
-				if (pulseDuration == 0)
-					timerStatus[timerNumber].counterMode.irqRequest = true;
-				//Hack
-				timerStatus[timerNumber].counterMode.isTarget = false;
-				timerStatus[timerNumber].counterMode.isOverflow = false;
-
-				return;
-			}
-
-			//Once Mode
-			if (isTarget & triggerTarget)
-			{
-				timerStatus[timerNumber].counterMode.irqRequest = false;
-				pulseDuration[timerNumber] = PULSE_DURATION;
-				timerStatus[timerNumber].toTarget = false;
-				throwInterrupt = true;
-			}
-
-			if (isOverflow & triggerOverflow)
-			{
-				timerStatus[timerNumber].counterMode.irqRequest = false;
-				pulseDuration[timerNumber] = PULSE_DURATION;
-				timerStatus[timerNumber].toOverflow = false;
-				throwInterrupt = true;
-			}
-		}
+		//Pulse Mode, bit10 is back to 1 a few cycles later, too short to be seen by a read
+		timer.counterMode.irqRequest = true;
+		throwInterrupt = true;
 	}
 
+	timer.irqDone = true;
+
 	//Throw Interrupt
 	if (throwInterrupt)
 	{
@@ -570,7 +528,5 @@ void Timers::updateInterrupt(uint8_t timerNumber)
 			break;
 			
 		}
-
-		throwInterrupt = false;
 	}
 }
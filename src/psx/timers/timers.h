@@ -7,11 +7,11 @@
 #include <memory>
 
 #include "litelib.h"
+#include "device.h"
 
 class Psx;
 
 constexpr auto TIMER_NUMBER = 3;
-constexpr auto PULSE_DURATION = 1500;
 
 enum class ClockSource { System, System8, Dot, hBlank };
 
@@ -42,6 +42,7 @@ struct TimerStatus
 	ClockSource	clockSource;
 	bool		toTarget;		//Timer Counter has reached Target Value
 	bool		toOverflow;		//Timer Counter has overflowed (0xffff)
+	bool		irqDone;		//One-shot IRQ already thrown, no more IRQs until the next Counter Mode write
 
 	TimerStatus& operator=(const TimerStatus& x)
 	{
@@ -51,25 +52,30 @@ struct TimerStatus
 		this->clockSource = x.clockSource;
 		this->toTarget = x.toTarget;
 		this->toOverflow = x.toOverflow;
+		this->irqDone = x.irqDone;
 
 		return *this;
 	}
 };
 
-class Timers
+class Timers : public Device
 {
 public:
 	Timers();
 	~Timers();
 
 	bool reset();
-	bool execute(ClockSource source);
+	bool execute(ClockSource source, uint32_t ticks = 1);
+	bool runTicks(uint32_t cycles) override;
+	bool serialize(SaveState& state) override;
+	bool usesClock(ClockSource source) const;
+	void blankEdge(uint8_t timerNumber, bool blank, uint64_t clock);
 
 	bool writeAddr(uint32_t addr, uint32_t& data, uint8_t bytes);
 	uint32_t readAddr(uint32_t addr, uint8_t bytes);
 
 	//Connect to PSX Instance
-	void link(Psx* instance) { psx = instance; }
+	void link(Psx* instance) override { psx = instance; }
 
     //Getter & Setters
     TimerStatus getTimerStatus(int timerID) const { return timerStatus[timerID]; }
@@ -79,12 +85,14 @@ private:
 	//Link to Bus Object
 	Psx* psx;
 
-	void updateTimer0();
-	void updateTimer1();
-	void updateTimer2();
-	void updateInterrupt(uint8_t timerNumber);
+	void advanceTimer(uint8_t timerNumber, uint32_t ticks);
+	uint32_t syncTicks(uint8_t timerNumber, uint32_t ticks);
+	void countTicks(uint8_t timerNumber, uint32_t ticks);
+	uint32_t nextStop(const TimerStatus& timer, uint32_t& value) const;
+	uint64_t ticksToInterrupt(uint8_t timerNumber) const;
+	void updateInterrupt(uint8_t timerNumber, uint32_t crossings = 1);
 
-	uint32_t	pulseDuration[TIMER_NUMBER];
+	uint64_t	clockTicks;		//System Clock Ticks, used to derive the System8 Clock
 
 	//Timers Internal Registers
 	std::array<TimerStatus, TIMER_NUMBER>	timerStatus;
@@ -1,4 +1,6 @@
 #include <loguru.hpp>
+#include <cstdlib>
+#include <climits>
 #include "commandline.h"
 
 bool commandline::checkCommand(char** begin, char** end, const std::string &cmd)
@@ -20,7 +22,17 @@ char* commandline::getStringValue(char** begin, char** end, const std::string &c
 
 int commandline::getIntValue(char** begin, char** end, const std::string &cmd)
 {
-    return 0;
+    char* value = getStringValue(begin, end, cmd);
+    if (value == nullptr)
+        return -1;
+
+    //Only plain non negative decimal values are accepted
+    char* last = nullptr;
+    long number = std::strtol(value, &last, 10);
+    if (last == value || *last != '\0' || number < 0 || number > INT_MAX)
+        return -1;
+
+    return static_cast<int>(number);
 }
 
 bool commandline::parse(int argc, char* argv[])
@@ -35,6 +47,12 @@ bool commandline::parse(int argc, char* argv[])
         LOG_F(INFO, "              [--bios <bios filename]");
         LOG_F(INFO, "              [--exe <exe filename]");
         LOG_F(INFO, "              [--bin <bin filename]");
+        LOG_F(INFO, "              [--state <save state filename]");
+        LOG_F(INFO, "              [--cpu <interpreter|cached|jit>]");
+        LOG_F(INFO, "              [--renderer <opengl|software|null>]");
+        LOG_F(INFO, "              [--raster-threads <thread count>]");
+        LOG_F(INFO, "              [--texture-cache]");
+        LOG_F(INFO, "              [--headless --frames <frame count>]");
         return false;
     }
 
@@ -44,6 +62,11 @@ bool commandline::parse(int argc, char* argv[])
         return false;
     }
 
+    if (checkCommand(argv, argv + argc, "--headless"))
+    {
+        headless = true;
+    }
+
     if (checkCommand(argv, argv + argc, "--bios"))
     {
         char *filename = getStringValue(argv, argv + argc, "--bios");
@@ -86,6 +109,87 @@ bool commandline::parse(int argc, char* argv[])
             return false;
         }      
     }
+
+    if (checkCommand(argv, argv + argc, "--state"))
+    {
+        char *filename = getStringValue(argv, argv + argc, "--state");
+        if (filename != nullptr)
+        {
+            stateFilename = std::string(filename);
+        }
+        else
+        {
+            LOG_F(ERROR, "Incorrect Save State filename parameter!");
+            return false;
+        }      
+    }
+
+    if (checkCommand(argv, argv + argc, "--cpu"))
+    {
+        char *mode = getStringValue(argv, argv + argc, "--cpu");
+        if (mode != nullptr && (std::string(mode) == "interpreter" || std::string(mode) == "cached" || std::string(mode) == "jit"))
+        {
+            cpuMode = std::string(mode);
+        }
+        else
+        {
+            LOG_F(ERROR, "Incorrect Cpu mode parameter!");
+            return false;
+        }
+    }
+
+    if (checkCommand(argv, argv + argc, "--renderer"))
+    {
+        char *mode = getStringValue(argv, argv + argc, "--renderer");
+        if (mode != nullptr && (std::string(mode) == "opengl" || std::string(mode) == "software" || std::string(mode) == "null"))
+        {
+            rendererMode = std::string(mode);
+        }
+        else
+        {
+            LOG_F(ERROR, "Incorrect Renderer mode parameter!");
+            return false;
+        }
+    }
+
+    if (checkCommand(argv, argv + argc, "--raster-threads"))
+    {
+        rasterThreads = getIntValue(argv, argv + argc, "--raster-threads");
+        if (rasterThreads <= 0)
+        {
+            LOG_F(ERROR, "Incorrect Raster Threads parameter!");
+            return false;
+        }
+    }
+
+    if (checkCommand(argv, argv + argc, "--texture-cache"))
+    {
+        textureCache = true;
+    }
+
+    if (checkCommand(argv, argv + argc, "--frames"))
+    {
+        frames = getIntValue(argv, argv + argc, "--frames");
+        if (frames <= 0)
+        {
+            LOG_F(ERROR, "Incorrect Frames parameter!");
+            return false;
+        }
+    }
+
+    //Headless runs have no OpenGL Context
+    if (headless && rendererMode == "opengl")
+    {
+        LOG_F(ERROR, "Headless mode supports only software or null renderer!");
+        return false;
+    }
+
+    //Headless runs have no window to close, they must be bounded
+    if (headless && frames == 0)
+    {
+        LOG_F(ERROR, "Headless mode requires --frames parameter!");
+        return false;
+    }
     
     return true;
 };
\ No newline at end of file
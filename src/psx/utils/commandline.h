@@ -16,9 +16,16 @@ public:
     std::string getBiosFileName() { return biosFilename; };
     std::string getBinFileName() { return binFilename; };
     std::string getExeFileName() { return exeFilename; };
+    std::string getStateFileName() { return stateFilename; };
+    std::string getCpuMode() { return cpuMode; };
+    std::string getRendererMode() { return rendererMode; };
+    int getRasterThreads() { return rasterThreads; };
+    bool isTextureCacheEnabled() { return textureCache; };
+    bool isHeadless() { return headless; };
+    int getFrames() { return frames; };
 
 private:
-    commandline() {}
+    commandline() : headless(false), frames(0), rasterThreads(0), textureCache(false) {}
 
     bool checkCommand(char** begin, char** end, const std::string &cmd);
     char* getStringValue(char** begin, char** end, const std::string &cmd);
@@ -27,6 +34,13 @@ private:
     std::string        biosFilename;
     std::string        exeFilename;
     std::string        binFilename;
+    std::string        stateFilename;
+    std::string        cpuMode;
+    std::string        rendererMode;
+    bool               headless;
+    int                frames;
+    int                rasterThreads;
+    bool               textureCache;
 
 
 };
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include <loguru.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "psx.h"
+#include "profiler.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// psxemu_bench - boots BIOS + EXE/BIN headless for a fixed number of frames or cycles
+// and reports guest throughput and host time per subsystem as JSON on stdout.
+//
+// usage: psxemu_bench --bios <file> [--exe <file>] [--bin <file>] [--state <file>] [--cpu <interpreter|cached|jit>]
+//                     [--renderer <software|null>] [--raster-threads <n>] (--frames <n> | --cycles <n>) [--runs <n>] [--json <file>]
+//
+//-------------------------------------------------------------------------------------------------------------
+
+struct BenchResult
+{
+	uint64_t	frames;
+	uint64_t	cycles;
+	uint64_t	stallCycles;
+	double		seconds;
+	uint64_t	zoneTime[static_cast<int>(ProfileZone::Count)];
+};
+
+static char* getArgument(int argc, char* argv[], const std::string& cmd)
+{
+	char** end = argv + argc;
+	char** p = std::find(argv, end, cmd);
+
+	return (p != end && (p + 1) != end) ? *(p + 1) : nullptr;
+}
+
+static std::string jsonString(const std::string& value)
+{
+	std::string out = "\"";
+	for (char c : value)
+	{
+		if (c == '"' || c == '\\')
+			out += '\\';
+		out += c;
+	}
+
+	return out + "\"";
+}
+
+static void writeResult(FILE* out, const BenchResult& result, const char* indent)
+{
+	//CPU retires one instruction per cycle it runs, cycles stalled on DMA retire none
+	double mips = (result.seconds > 0.0) ? (result.cycles - result.stallCycles) / result.seconds / 1e6 : 0.0;
+	double fps = (result.seconds > 0.0) ? result.frames / result.seconds : 0.0;
+	double nsPerCycle = (result.cycles > 0) ? result.seconds * 1e9 / result.cycles : 0.0;
+
+	fprintf(out, "%s\"frames\": %llu,\n", indent, (unsigned long long)result.frames);
+	fprintf(out, "%s\"cycles\": %llu,\n", indent, (unsigned long long)result.cycles);
+	fprintf(out, "%s\"dma_stall_cycles\": %llu,\n", indent, (unsigned long long)result.stallCycles);
+	fprintf(out, "%s\"seconds\": %.6f,\n", indent, result.seconds);
+	fprintf(out, "%s\"guest_mips\": %.3f,\n", indent, mips);
+	fprintf(out, "%s\"fps\": %.3f,\n", indent, fps);
+	fprintf(out, "%s\"ns_per_cycle\": %.3f,\n", indent, nsPerCycle);
+	fprintf(out, "%s\"subsystems\": {", indent);
+	for (int i = 0; i < static_cast<int>(ProfileZone::Count); i++)
+	{
+		fprintf(out, "%s\"%s\": %.6f", (i == 0) ? " " : ", ", Profiler::getName(static_cast<ProfileZone>(i)), result.zoneTime[i] / 1e9);
+	}
+	fprintf(out, " }\n");
+}
+
+int main(int argc, char* argv[])
+{
+	//Init Log Library, stdout is reserved for the JSON report
+	loguru::init(argc, argv);
+	loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+	if (!commandline::instance().parse(argc, argv))
+		return EXIT_FAILURE;
+
+	//Benchmark Parameters
+	char* cycleArg = getArgument(argc, argv, "--cycles");
+	char* runsArg = getArgument(argc, argv, "--runs");
+	char* jsonArg = getArgument(argc, argv, "--json");
+	uint64_t frames = static_cast<uint64_t>(std::max(commandline::instance().getFrames(), 0));
+	uint64_t cycles = (cycleArg != nullptr) ? std::strtoull(cycleArg, nullptr, 10) : 0;
+	int runs = (runsArg != nullptr) ? std::atoi(runsArg) : 1;
+
+	if ((frames == 0 && cycles == 0) || runs <= 0)
+	{
+		LOG_F(ERROR, "BENCH - Either --frames or --cycles is required, --runs must be positive!");
+		return EXIT_FAILURE;
+	}
+
+	//No OpenGL, primitives are either rasterized on the CPU or dropped
+	bool software = (commandline::instance().getRendererMode() == "software");
+	Renderer::SetBackend(software ? RendererBackend::Software : RendererBackend::Null, true);
+	Renderer::SetRasterizerThreads(commandline::instance().getRasterThreads());
+
+	auto psx = std::make_shared<Psx>();
+	if (!psx->bios->isLoaded())
+	{
+		LOG_F(ERROR, "BENCH - A valid Bios image is required!");
+		return EXIT_FAILURE;
+	}
+
+	//Runs start from the Save State when given, from power on otherwise
+	std::vector<uint8_t> startState;
+	if (!commandline::instance().getStateFileName().empty())
+	{
+		if (!psx->loadStateFile(commandline::instance().getStateFileName()) || !psx->saveState(startState))
+			return EXIT_FAILURE;
+	}
+
+	std::vector<BenchResult> results;
+	for (int run = 0; run < runs; run++)
+	{
+		BenchResult result = {};
+
+		//Every run starts from the same point
+		if (run > 0 && !startState.empty())
+			psx->loadState(startState);
+		else if (run > 0)
+			psx->reset();
+		Profiler::reset();
+
+		uint64_t clockStart = psx->masterClock;
+		uint64_t stallStart = psx->stallClock;
+		auto timerStart = std::chrono::steady_clock::now();
+
+		if (cycles > 0)
+		{
+			while (psx->masterClock - clockStart < cycles)
+			{
+				psx->execute();
+				if (Renderer::FrameReady())
+					result.frames++;
+			}
+		}
+		else
+		{
+			while (result.frames < frames)
+			{
+				while (!Renderer::FrameReady())
+					psx->execute();
+				result.frames++;
+			}
+		}
+
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timerStart).count();
+		result.cycles = psx->masterClock - clockStart;
+		result.stallCycles = psx->stallClock - stallStart;
+		for (int i = 0; i < static_cast<int>(ProfileZone::Count); i++)
+			result.zoneTime[i] = Profiler::getNanoseconds(static_cast<ProfileZone>(i));
+
+		LOG_F(WARNING, "BENCH - Run %d: %llu frames, %llu cycles in %.3fs", run + 1, (unsigned long long)result.frames, (unsigned long long)result.cycles, result.seconds);
+		results.push_back(result);
+	}
+
+	//Fastest run is the least disturbed by the host
+	auto best = std::min_element(results.begin(), results.end(), [](const BenchResult& a, const BenchResult& b) { return a.seconds < b.seconds; });
+
+	FILE* out = stdout;
+	if (jsonArg != nullptr)
+	{
+		out = fopen(jsonArg, "w");
+		if (out == nullptr)
+		{
+			LOG_F(ERROR, "BENCH - Unable to write %s!", jsonArg);
+			return EXIT_FAILURE;
+		}
+	}
+
+	fprintf(out, "{\n");
+	fprintf(out, "  \"bios\": %s,\n", jsonString(commandline::instance().getBiosFileName()).c_str());
+	fprintf(out, "  \"exe\": %s,\n", jsonString(commandline::instance().getExeFileName()).c_str());
+	fprintf(out, "  \"bin\": %s,\n", jsonString(commandline::instance().getBinFileName()).c_str());
+	fprintf(out, "  \"state\": %s,\n", jsonString(commandline::instance().getStateFileName()).c_str());
+	fprintf(out, "  \"cpu\": %s,\n", jsonString(commandline::instance().getCpuMode().empty() ? "cached" : commandline::instance().getCpuMode()).c_str());
+	fprintf(out, "  \"renderer\": %s,\n", jsonString(software ? "software" : "null").c_str());
+	fprintf(out, "  \"runs\": [\n");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		fprintf(out, "    {\n");
+		writeResult(out, results[i], "      ");
+		fprintf(out, "    }%s\n", (i + 1 < results.size()) ? "," : "");
+	}
+	fprintf(out, "  ],\n");
+	fprintf(out, "  \"best\": {\n");
+	writeResult(out, *best, "    ");
+	fprintf(out, "  }\n");
+	fprintf(out, "}\n");
+
+	if (out != stdout)
+		fclose(out);
+
+	//An EXE was requested but never reached, the numbers do not measure it
+	if (!commandline::instance().getExeFileName().empty() && !psx->exeFile->isPresent())
+	{
+		LOG_F(ERROR, "BENCH - EXE not loaded!");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
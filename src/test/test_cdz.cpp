@@ -0,0 +1,131 @@
+#include <loguru.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <random>
+#include <fstream>
+#include <filesystem>
+
+#include "tests.h"
+#include "cdzimage.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// CdzImage - compress, open and read back a raw image, refuse corrupted ones
+//
+//-------------------------------------------------------------------------------------------------------------
+
+//Odd number of sectors, the last hunk is a partial one
+constexpr uint32_t CDZ_TEST_SECTORS = 3 * cdz_hunk_sectors + 5;
+
+// Raw image alternating compressible and random sectors, so both stored and deflated hunks are read.
+static std::vector<uint8_t> makeImage()
+{
+	std::vector<uint8_t> image(static_cast<size_t>(CDZ_TEST_SECTORS) * sector_size);
+	std::mt19937 random(2352);
+
+	for (uint32_t sector = 0; sector < CDZ_TEST_SECTORS; sector++)
+	{
+		uint8_t* data = image.data() + static_cast<size_t>(sector) * sector_size;
+		bool noise = (sector / cdz_hunk_sectors) % 2 == 1;
+		for (uint32_t i = 0; i < sector_size; i++)
+			data[i] = noise ? static_cast<uint8_t>(random()) : static_cast<uint8_t>(sector + i / 16);
+	}
+
+	return image;
+}
+
+static void writeFile(const std::filesystem::path& path, const std::vector<uint8_t>& data)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+static std::vector<uint8_t> readFile(const std::filesystem::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST_CASE(cdz_round_trip)
+{
+	auto dir = std::filesystem::temp_directory_path();
+	auto binFile = dir / "psxemu_test.bin";
+	auto cdzFile = dir / "psxemu_test.cdz";
+	std::vector<uint8_t> source = makeImage();
+	writeFile(binFile, source);
+
+	CHECK(CdzImage::convert(binFile.string(), cdzFile.string()));
+	CHECK(std::filesystem::file_size(cdzFile) < source.size());
+
+	CdzImage image;
+	CHECK(image.open(cdzFile.string()));
+	CHECK(image.getSectorCount() == CDZ_TEST_SECTORS);
+
+	//Backwards first, every hunk is loaded again once evicted
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (uint32_t i = 0; i < CDZ_TEST_SECTORS; i++)
+		{
+			uint32_t sector = pass ? i : CDZ_TEST_SECTORS - 1 - i;
+			auto data = image.readSector(sector);
+			CHECK(data.size() == sector_size);
+			CHECK(data.size() == sector_size && std::memcmp(data.data(), source.data() + static_cast<size_t>(sector) * sector_size, sector_size) == 0);
+		}
+	}
+	CHECK(image.readSector(CDZ_TEST_SECTORS).empty());
+
+	image.close();
+	std::filesystem::remove(binFile);
+	std::filesystem::remove(cdzFile);
+}
+
+TEST_CASE(cdz_corrupted)
+{
+	auto dir = std::filesystem::temp_directory_path();
+	auto binFile = dir / "psxemu_corrupted.bin";
+	auto cdzFile = dir / "psxemu_corrupted.cdz";
+	writeFile(binFile, makeImage());
+	CHECK(CdzImage::convert(binFile.string(), cdzFile.string()));
+
+	std::vector<uint8_t> valid = readFile(cdzFile);
+	CdzHeader header;
+	std::memcpy(&header, valid.data(), sizeof(header));
+	CdzImage image;
+
+	//Patches a copy of the valid image and checks it is refused
+	auto refused = [&](size_t offset, const void* value, size_t size, size_t length)
+	{
+		std::vector<uint8_t> data(valid.begin(), valid.begin() + length);
+		std::memcpy(data.data() + offset, value, size);
+		writeFile(cdzFile, data);
+		return !image.open(cdzFile.string());
+	};
+
+	uint32_t hunkSectors = 0;
+	CHECK(refused(offsetof(CdzHeader, hunkSectors), &hunkSectors, sizeof(hunkSectors), valid.size()));
+
+	//Hunk count still matching the sector count, hunks are just too large
+	uint32_t large[2] = { 1 << 20, 1 };
+	CHECK(refused(offsetof(CdzHeader, hunkSectors), large, sizeof(large), valid.size()));
+
+	//Index larger than the file
+	uint32_t sectorCount[4] = { 0xffffffff, 1, 0xffffffff, 0 };
+	CHECK(refused(offsetof(CdzHeader, sectorCount), sectorCount, sizeof(sectorCount), valid.size()));
+
+	//Hunk data past the end of the file
+	CHECK(refused(0, valid.data(), 0, valid.size() - 1));
+
+	//Hunk data overlapping the index
+	uint64_t first = sizeof(CdzHeader);
+	CHECK(refused(sizeof(CdzHeader), &first, sizeof(first), valid.size()));
+
+	//Untouched copy still opens
+	CHECK(!refused(0, valid.data(), 0, valid.size()));
+
+	image.close();
+	std::filesystem::remove(binFile);
+	std::filesystem::remove(cdzFile);
+}
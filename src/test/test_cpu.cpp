@@ -0,0 +1,88 @@
+#include <loguru.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tests.h"
+#include "psx.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// CPU - Recompiled blocks reach I/O registers at the same Master Clock cycle as the Cached interpreter
+//
+//-------------------------------------------------------------------------------------------------------------
+
+//MIPS Encoding, registers used are t0 (8) to t7 (15)
+constexpr uint32_t opLui(uint32_t rt, uint32_t imm) { return (0x0f << 26) | (rt << 16) | (imm & 0xffff); }
+constexpr uint32_t opOri(uint32_t rt, uint32_t rs, uint32_t imm) { return (0x0d << 26) | (rs << 21) | (rt << 16) | (imm & 0xffff); }
+constexpr uint32_t opAndi(uint32_t rt, uint32_t rs, uint32_t imm) { return (0x0c << 26) | (rs << 21) | (rt << 16) | (imm & 0xffff); }
+constexpr uint32_t opLw(uint32_t rt, uint32_t rs, uint32_t imm) { return (0x23 << 26) | (rs << 21) | (rt << 16) | (imm & 0xffff); }
+constexpr uint32_t opSw(uint32_t rt, uint32_t rs, uint32_t imm) { return (0x2b << 26) | (rs << 21) | (rt << 16) | (imm & 0xffff); }
+constexpr uint32_t opSubu(uint32_t rd, uint32_t rs, uint32_t rt) { return (rs << 21) | (rt << 16) | (rd << 11) | 0x23; }
+constexpr uint32_t opJ(uint32_t addr) { return (0x02 << 26) | ((addr & 0x0fffffff) >> 2); }
+constexpr uint32_t opNop = 0x00000000;
+
+constexpr uint32_t T0 = 8, T1 = 9, T2 = 10, T3 = 11, T5 = 13, T6 = 14, T7 = 15;
+constexpr uint32_t PROGRAM_ADDR = 0x80010000;
+
+// Appends the read of Timer 0 into t6, t7 = t6 - t5 and the final idle loop
+static void endProgram(std::vector<uint32_t>& program)
+{
+	program.insert(program.end(), { opLw(T6, T0, 0x1100), opNop, opSubu(T7, T6, T5), opAndi(T7, T7, 0xffff) });
+	uint32_t loop = PROGRAM_ADDR + static_cast<uint32_t>(program.size()) * 4;
+	program.insert(program.end(), { opJ(loop), opNop });
+}
+
+// Runs the program from RAM in the given mode up to its idle loop, returns t7
+static uint32_t runProgram(const std::shared_ptr<Psx>& psx, CpuMode mode, const std::vector<uint32_t>& program)
+{
+	psx->reset();
+	psx->cpu->setMode(mode);
+	for (size_t i = 0; i < program.size(); i++)
+	{
+		uint32_t word = program[i];
+		psx->mem->write((PROGRAM_ADDR & 0x001fffff) + static_cast<uint32_t>(i) * 4, word, 4);
+	}
+
+	uint32_t loop = PROGRAM_ADDR + static_cast<uint32_t>(program.size() - 2) * 4;
+	psx->cpu->set_pc(PROGRAM_ADDR);
+	while (psx->cpu->get_pc() != loop && psx->cpu->get_pc() != loop + 4 && psx->masterClock < 1000000)
+		psx->execute();
+
+	return psx->cpu->get_gpr(T7);
+}
+
+TEST_CASE(cpu_jit_io_clock)
+{
+	auto psx = std::make_shared<Psx>();
+
+	//Two Timer 0 reads in one block, eleven instructions apart
+	std::vector<uint32_t> program = { opLui(T0, 0x1f80), opLw(T5, T0, 0x1100) };
+	program.insert(program.end(), 10, opNop);
+	endProgram(program);
+
+	uint32_t cached = runProgram(psx, CpuMode::Cached, program);
+	uint32_t jit = runProgram(psx, CpuMode::Recompiler, program);
+	CHECK(cached == 11);
+	CHECK(jit == cached);
+}
+
+TEST_CASE(cpu_jit_dma_stall)
+{
+	auto psx = std::make_shared<Psx>();
+
+	//OTC of 4000h words started by a store, the next Timer 0 read happens once the bus is released
+	std::vector<uint32_t> program = {
+		opLui(T0, 0x1f80), opLw(T5, T0, 0x1100),
+		opLui(T1, 0x0800), opSw(T1, T0, 0x10f0),					//DPCR, Channel 6 enabled
+		opLui(T1, 0x8002), opOri(T1, T1, 0xfffc), opSw(T1, T0, 0x10e0),
+		opOri(T2, 0, 0x4000), opSw(T2, T0, 0x10e4),
+		opLui(T3, 0x1100), opOri(T3, T3, 0x0002), opSw(T3, T0, 0x10e8),
+	};
+	endProgram(program);
+
+	uint32_t cached = runProgram(psx, CpuMode::Cached, program);
+	uint32_t jit = runProgram(psx, CpuMode::Recompiler, program);
+	CHECK(cached >= 0x4000);
+	CHECK(jit == cached);
+}
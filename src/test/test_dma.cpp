@@ -0,0 +1,81 @@
+#include <loguru.hpp>
+#include <cstdint>
+#include <memory>
+
+#include "tests.h"
+#include "psx.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// DMA - a GPU Linked List longer than one burst, the CPU gets the bus between bursts only when chopping
+//
+//-------------------------------------------------------------------------------------------------------------
+
+//DMA Registers
+constexpr uint32_t DMA_GPU_MADR = 0x1f8010a0;
+constexpr uint32_t DMA_GPU_CHCR = 0x1f8010a8;
+constexpr uint32_t DMA_DPCR = 0x1f8010f0;
+
+//Linked List of GP0 NOP packets, long enough to take more than one burst
+constexpr uint32_t LIST_ADDR = 0x00010000;
+constexpr uint32_t LIST_PACKETS = 300;
+constexpr uint32_t PACKET_WORDS = 255;
+
+struct ListRun
+{
+	bool		finished;		//Whole list walked, MADR at the end marker
+	uint64_t	cpuCycles;		//Master Clock cycles with the bus released to the CPU
+};
+
+// Starts Channel 2 on the list in Linked List mode and runs the system until the Channel stops.
+static ListRun runList(const std::shared_ptr<Psx>& psx, uint32_t chcr)
+{
+	ListRun run = {};
+	uint32_t data;
+
+	psx->reset();
+	for (uint32_t i = 0; i < LIST_PACKETS; i++)
+	{
+		uint32_t header = LIST_ADDR + i * (PACKET_WORDS + 1) * 4;
+		uint32_t next = (i + 1 < LIST_PACKETS) ? header + (PACKET_WORDS + 1) * 4 : 0x00ffffff;
+		data = (PACKET_WORDS << 24) | next;
+		psx->mem->write(header, data, 4);
+		data = 0x00000000;
+		for (uint32_t w = 1; w <= PACKET_WORDS; w++)
+			psx->mem->write(header + w * 4, data, 4);
+	}
+
+	data = 0x00000800;		//Channel 2 enabled
+	psx->wrMem(DMA_DPCR, data);
+	data = LIST_ADDR;
+	psx->wrMem(DMA_GPU_MADR, data);
+	psx->wrMem(DMA_GPU_CHCR, chcr);
+
+	uint64_t clockEnd = psx->masterClock + 4 * LIST_PACKETS * (PACKET_WORDS + 1);
+	while ((psx->rdMem(DMA_GPU_CHCR) & 0x01000000) && psx->masterClock < clockEnd)
+	{
+		uint64_t clock = psx->masterClock;
+		bool busy = psx->dataBusBusy;
+		psx->execute();
+		if (!busy)
+			run.cpuCycles += psx->masterClock - clock;
+	}
+
+	run.finished = (psx->rdMem(DMA_GPU_MADR) & 0x00ffffff) == 0x00ffffff;
+	return run;
+}
+
+TEST_CASE(dma_list_chopping)
+{
+	auto psx = std::make_shared<Psx>();
+
+	//Linked List from RAM, no chopping: the CPU is stalled until the end of the list
+	ListRun run = runList(psx, 0x01000401);
+	CHECK(run.finished);
+	CHECK(run.cpuCycles == 0);
+
+	//Same list with chopping, CPU Windows of 2^7 cycles between bursts
+	run = runList(psx, 0x01700501);
+	CHECK(run.finished);
+	CHECK(run.cpuCycles > 0);
+}
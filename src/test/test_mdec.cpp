@@ -0,0 +1,249 @@
+#include <loguru.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "tests.h"
+#include "mdec.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// MDEC - a fixed Macroblock decoded through the Command interface against a plain per-Block reference:
+// Run Length decoding, dequantization, IDCT as two 8x8 products and YUV to RGB one Pixel at a time
+//
+//-------------------------------------------------------------------------------------------------------------
+
+constexpr uint8_t refZigzag[MDEC_BLOCK_SIZE] = {
+	 0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+	12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+struct RefTables
+{
+	uint8_t		quantLuma[MDEC_BLOCK_SIZE];
+	uint8_t		quantChroma[MDEC_BLOCK_SIZE];
+	int16_t		scale[MDEC_BLOCK_SIZE];
+};
+
+static int32_t refSigned10(uint16_t value)
+{
+	return (value & 0x200) ? static_cast<int32_t>(value & 0x3ff) - 0x400 : (value & 0x3ff);
+}
+
+// One Block of the stream, returns the Coefficients after dequantization in natural order.
+static void refDequant(const std::vector<uint16_t>& stream, size_t& pos, const uint8_t* quant, int32_t* coef)
+{
+	std::fill(coef, coef + MDEC_BLOCK_SIZE, 0);
+	while (stream[pos] == 0xfe00)
+		pos++;
+
+	uint16_t n = stream[pos++];
+	int32_t scale = n >> 10;
+	int32_t k = 0;
+	int32_t value = (scale == 0) ? refSigned10(n) * 2 : refSigned10(n) * quant[0];
+
+	while (k < MDEC_BLOCK_SIZE)
+	{
+		coef[(scale == 0) ? k : refZigzag[k]] = std::clamp(value, -0x400, 0x3ff);
+		n = stream[pos++];
+		k += (n >> 10) + 1;
+		if (k < MDEC_BLOCK_SIZE)
+			value = (scale == 0) ? refSigned10(n) * 2 : (refSigned10(n) * quant[k] * scale + 4) / 8;
+	}
+}
+
+// out[y][x] = sum(S[u][y] * sum(coef[u][v] * S[v][x])) with the column pass rounded to 15 bits and the row pass to 17.
+static void refIdct(const int32_t* coef, const int16_t* s, int32_t* out)
+{
+	int32_t tmp[MDEC_BLOCK_SIZE];
+
+	for (int y = 0; y < 8; y++)
+	{
+		for (int x = 0; x < 8; x++)
+		{
+			int64_t sum = 0;
+			for (int u = 0; u < 8; u++)
+				sum += static_cast<int64_t>(s[u * 8 + y]) * coef[u * 8 + x];
+			tmp[y * 8 + x] = std::clamp<int32_t>(static_cast<int32_t>((sum + (1 << 14)) >> 15), -0x8000, 0x7fff);
+		}
+	}
+
+	for (int y = 0; y < 8; y++)
+	{
+		for (int x = 0; x < 8; x++)
+		{
+			int64_t sum = 0;
+			for (int u = 0; u < 8; u++)
+				sum += static_cast<int64_t>(tmp[y * 8 + u]) * s[u * 8 + x];
+			out[y * 8 + x] = std::clamp<int32_t>(static_cast<int32_t>((sum + (1 << 16)) >> 17), -0x8000, 0x7fff);
+		}
+	}
+}
+
+static uint8_t refPixel(int32_t value, bool isSigned)
+{
+	return static_cast<uint8_t>(std::clamp(value, -128, 127) + (isSigned ? 0 : 128));
+}
+
+// Decodes a whole color Macroblock into 24 bits or 15 bits Pixels, as bytes.
+static std::vector<uint8_t> refColor(const std::vector<uint16_t>& stream, const RefTables& tables, bool depth24, bool isSigned, bool bit15)
+{
+	int32_t coef[MDEC_BLOCK_SIZE];
+	int32_t blocks[6][MDEC_BLOCK_SIZE];
+	size_t pos = 0;
+
+	for (int b = 0; b < 6; b++)
+	{
+		refDequant(stream, pos, (b < 2) ? tables.quantChroma : tables.quantLuma, coef);
+		refIdct(coef, tables.scale, blocks[b]);
+	}
+
+	std::vector<uint8_t> out;
+	for (int py = 0; py < 16; py++)
+	{
+		for (int px = 0; px < 16; px++)
+		{
+			//Y1 Y2 on top, Y3 Y4 below
+			int32_t l = blocks[2 + (py / 8) * 2 + (px / 8)][(py % 8) * 8 + (px % 8)];
+			int32_t cr = blocks[0][(py / 2) * 8 + (px / 2)];
+			int32_t cb = blocks[1][(py / 2) * 8 + (px / 2)];
+
+			uint8_t r = refPixel(l + static_cast<int32_t>(std::floor(cr * 359 / 256.0)), isSigned);
+			uint8_t g = refPixel(l + static_cast<int32_t>(std::floor((-cb * 88 - cr * 183) / 256.0)), isSigned);
+			uint8_t b = refPixel(l + static_cast<int32_t>(std::floor(cb * 454 / 256.0)), isSigned);
+
+			if (depth24)
+			{
+				out.push_back(r);
+				out.push_back(g);
+				out.push_back(b);
+			}
+			else
+			{
+				uint16_t pixel = (bit15 ? 0x8000 : 0) | ((b >> 3) << 10) | ((g >> 3) << 5) | (r >> 3);
+				out.push_back(static_cast<uint8_t>(pixel));
+				out.push_back(static_cast<uint8_t>(pixel >> 8));
+			}
+		}
+	}
+
+	return out;
+}
+
+// Decodes one monochrome Block into 8 bits or 4 bits Pixels.
+static std::vector<uint8_t> refMono(const std::vector<uint16_t>& stream, const RefTables& tables, bool depth8, bool isSigned)
+{
+	int32_t coef[MDEC_BLOCK_SIZE];
+	int32_t block[MDEC_BLOCK_SIZE];
+	size_t pos = 0;
+
+	refDequant(stream, pos, tables.quantLuma, coef);
+	refIdct(coef, tables.scale, block);
+
+	std::vector<uint8_t> out;
+	for (int i = 0; i < MDEC_BLOCK_SIZE; i += depth8 ? 1 : 2)
+	{
+		if (depth8)
+			out.push_back(refPixel(block[i], isSigned));
+		else
+			out.push_back((refPixel(block[i], isSigned) >> 4) | (refPixel(block[i + 1], isSigned) & 0xf0));
+	}
+
+	return out;
+}
+
+// Fixed Macroblock: DC and a few AC Coefficients per Block, with long and short runs, saturating
+// Coefficients and one Block stored in natural order (Quantization Scale 0).
+static std::vector<uint16_t> makeStream(int blockCount)
+{
+	std::vector<uint16_t> stream;
+
+	for (int b = 0; b < blockCount; b++)
+	{
+		uint16_t scale = (b == 3) ? 0 : static_cast<uint16_t>(4 + b * 5);
+		stream.push_back(static_cast<uint16_t>((scale << 10) | ((b * 97 + 0x3c0) & 0x3ff)));
+
+		for (int i = 0; i < 6 + b * 3; i++)
+		{
+			uint16_t run = static_cast<uint16_t>((i * 3 + b) % 4);
+			uint16_t value = static_cast<uint16_t>((i & 1) ? (0x400 - 20 * (i + 1)) : (i * 37 + b * 11 + 5));
+			if (i == 2)
+				value = 0x1ff;
+			stream.push_back(static_cast<uint16_t>((run << 10) | (value & 0x3ff)));
+		}
+		stream.push_back(0xfe00);
+	}
+
+	//Whole Parameter Words, padded like the Blocks
+	if (stream.size() & 1)
+		stream.push_back(0xfe00);
+
+	return stream;
+}
+
+static std::vector<uint8_t> decode(MDEC& mdec, uint32_t command, const std::vector<uint16_t>& stream, size_t bytes)
+{
+	std::vector<uint32_t> words(stream.size() / 2);
+	std::memcpy(words.data(), stream.data(), words.size() * sizeof(uint32_t));
+
+	uint32_t word = command | static_cast<uint32_t>(words.size());
+	mdec.writeData(std::span<const uint32_t>(&word, 1));
+	mdec.writeData(words);
+
+	std::vector<uint32_t> data(bytes / sizeof(uint32_t));
+	CHECK(mdec.getOutputWords() == data.size());
+	mdec.readData(data);
+
+	std::vector<uint8_t> out(bytes);
+	std::memcpy(out.data(), data.data(), bytes);
+	return out;
+}
+
+TEST_CASE(mdec_macroblock)
+{
+	MDEC mdec;
+	RefTables tables;
+
+	//Quant Tables, Luminance and Color
+	for (int i = 0; i < MDEC_BLOCK_SIZE; i++)
+	{
+		tables.quantLuma[i] = static_cast<uint8_t>(2 + i);
+		tables.quantChroma[i] = static_cast<uint8_t>(3 + (i * 5) % 60);
+	}
+	std::vector<uint32_t> quant(1 + 2 * MDEC_BLOCK_SIZE / 4);
+	quant[0] = 0x40000001;
+	std::memcpy(quant.data() + 1, tables.quantLuma, MDEC_BLOCK_SIZE);
+	std::memcpy(quant.data() + 1 + MDEC_BLOCK_SIZE / 4, tables.quantChroma, MDEC_BLOCK_SIZE);
+	mdec.writeData(quant);
+
+	//Standard Scale Table, as uploaded by the BIOS
+	for (int u = 0; u < 8; u++)
+	{
+		for (int x = 0; x < 8; x++)
+		{
+			double c = (u == 0) ? std::sqrt(0.5) : std::cos((2 * x + 1) * u * 3.14159265358979323846 / 16.0);
+			tables.scale[u * 8 + x] = static_cast<int16_t>(std::lround(c * 0x8000));
+		}
+	}
+	std::vector<uint32_t> scale(1 + MDEC_BLOCK_SIZE / 2);
+	scale[0] = 0x60000000;
+	std::memcpy(scale.data() + 1, tables.scale, sizeof(tables.scale));
+	mdec.writeData(scale);
+
+	std::vector<uint16_t> color = makeStream(6);
+	std::vector<uint16_t> mono = makeStream(1);
+
+	//24 bits unsigned and signed, 15 bits with and without bit 15
+	CHECK(decode(mdec, 0x30000000, color, 16 * 16 * 3) == refColor(color, tables, true, false, false));
+	CHECK(decode(mdec, 0x34000000, color, 16 * 16 * 3) == refColor(color, tables, true, true, false));
+	CHECK(decode(mdec, 0x38000000, color, 16 * 16 * 2) == refColor(color, tables, false, false, false));
+	CHECK(decode(mdec, 0x3a000000, color, 16 * 16 * 2) == refColor(color, tables, false, false, true));
+
+	//8 bits and 4 bits monochrome
+	CHECK(decode(mdec, 0x28000000, mono, 64) == refMono(mono, tables, true, false));
+	CHECK(decode(mdec, 0x20000000, mono, 32) == refMono(mono, tables, false, false));
+}
@@ -0,0 +1,222 @@
+#include <loguru.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "tests.h"
+#include "renderer.h"
+#include "rasterizer.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// Rasterizer - every Span Kernel against the same span drawn one Pixel at a time through plotPixel:
+// gouraud, textured (CLUT 4bit, CLUT 8bit, 15bit, raw and blended) and semi transparent spans
+//
+//-------------------------------------------------------------------------------------------------------------
+
+constexpr size_t VRAM_PIXELS = 1024 * 512;
+
+class RasterizerTest
+{
+public:
+	RasterizerTest() : random(1024), kernelVram(VRAM_PIXELS), pixelVram(VRAM_PIXELS), kernel(kernelVram.data()), pixel(pixelVram.data())
+	{
+	}
+
+	// Random background, about one pixel in four has the mask bit set. Texture Page and CLUT live in it as well.
+	void fill()
+	{
+		for (auto& p : kernelVram)
+		{
+			p = static_cast<uint16_t>(random());
+			if (p & 0x4000)
+				p &= 0x7fff;
+		}
+		pixelVram = kernelVram;
+	}
+
+	// Draws the span with the Kernel picked by setupPipeline and again pixel by pixel, true when VRAM matches.
+	bool compare(const RendererState& state, bool textured, bool dither, int32_t x, int32_t y, int32_t count, int32_t start[5], int32_t step[5], bool wrapUV)
+	{
+		Rasterizer::SpanAttributes span;
+		std::copy(start, start + 5, span.start);
+		std::copy(step, step + 5, span.step);
+		span.wrapUV = wrapUV;
+
+		kernel.setupPipeline(state, textured, dither);
+		(kernel.*kernel.pipeline.spanKernel)(x, y, count, span);
+
+		pixel.setupPipeline(state, textured, dither);
+		for (int32_t i = 0; i < count; i++)
+			plotSpanPixel(span, x, y, i);
+
+		return kernelVram == pixelVram;
+	}
+
+	std::mt19937			random;
+
+private:
+	static int32_t attribute(const Rasterizer::SpanAttributes& span, int a, int32_t i)
+	{
+		return static_cast<int32_t>(static_cast<uint32_t>(span.start[a]) + static_cast<uint32_t>(i) * static_cast<uint32_t>(span.step[a])) >> 16;
+	}
+
+	// Texel lookup written out from the VRAM layout, CLUT 4bit, CLUT 8bit or Raw 1-5-5-5
+	uint16_t fetchTexel(uint32_t u, uint32_t v) const
+	{
+		const auto& p = pixel.pipeline;
+		const uint16_t* vram = pixelVram.data();
+		uint32_t line = ((p.texPageY + v) & 0x1ff) * 1024;
+		uint32_t clut = (p.clutY & 0x1ff) * 1024;
+
+		switch (p.texColorMode)
+		{
+		case 0:
+			return vram[clut + ((p.clutX + ((vram[line + ((p.texPageX + u / 4) & 0x3ff)] >> ((u % 4) * 4)) & 0x0f)) & 0x3ff)];
+		case 1:
+			return vram[clut + ((p.clutX + ((vram[line + ((p.texPageX + u / 2) & 0x3ff)] >> ((u % 2) * 8)) & 0xff)) & 0x3ff)];
+		default:
+			return vram[line + ((p.texPageX + u) & 0x3ff)];
+		}
+	}
+
+	// Texture fetch, window and blending as documented for the GPU, the rest is plotPixel.
+	void plotSpanPixel(const Rasterizer::SpanAttributes& span, int32_t x, int32_t y, int32_t i)
+	{
+		auto base = pixel.pipeline;
+		int32_t r = std::clamp(attribute(span, 0, i), 0, 255);
+		int32_t g = std::clamp(attribute(span, 1, i), 0, 255);
+		int32_t b = std::clamp(attribute(span, 2, i), 0, 255);
+
+		if (base.textured)
+		{
+			uint32_t u = span.wrapUV ? (attribute(span, 3, i) & 0xff) : std::clamp(attribute(span, 3, i), 0, 255);
+			uint32_t v = span.wrapUV ? (attribute(span, 4, i) & 0xff) : std::clamp(attribute(span, 4, i), 0, 255);
+			u = (u & ~base.texWindowMaskX) | base.texWindowOffsetX;
+			v = (v & ~base.texWindowMaskY) | base.texWindowOffsetY;
+
+			uint16_t texel = fetchTexel(u & 0xff, v & 0xff);
+			if (texel == 0x0000)
+				return;
+
+			int32_t tr = texel & 0x1f;
+			int32_t tg = (texel >> 5) & 0x1f;
+			int32_t tb = (texel >> 10) & 0x1f;
+			r = base.texBlending ? std::min((tr * r) >> 4, 255) : tr << 3;
+			g = base.texBlending ? std::min((tg * g) >> 4, 255) : tg << 3;
+			b = base.texBlending ? std::min((tb * b) >> 4, 255) : tb << 3;
+
+			//Texel bit 15 selects semi transparency and sets the mask bit
+			pixel.pipeline.semiTransparent = base.semiTransparent && (texel & 0x8000);
+			pixel.pipeline.forceMask = base.forceMask | (texel & 0x8000);
+		}
+
+		pixel.plotPixel(x + i, y, r, g, b);
+		pixel.pipeline = base;
+	}
+
+	std::vector<uint16_t>	kernelVram;
+	std::vector<uint16_t>	pixelVram;
+	Rasterizer				kernel;
+	Rasterizer				pixel;
+};
+
+static RendererState makeState()
+{
+	RendererState state{};
+	state.drawingArea = glm::ivec4(0, 0, 1023, 511);
+	state.texPageCoords = glm::ivec2(512, 256);
+	state.clutTableCoords = glm::ivec2(320, 480);
+	return state;
+}
+
+// A few spans of every length class, aligned and not, colors and UV going a bit out of range to check the clamps.
+static void compareSpans(RasterizerTest& test, const RendererState& state, bool textured, bool dither, bool wrapUV)
+{
+	const int32_t counts[] = { 1, 3, 8, 15, 16, 17, 37, 100 };
+
+	for (int32_t count : counts)
+	{
+		test.fill();
+		int32_t x = 5 + static_cast<int32_t>(test.random() % 200);
+		int32_t y = static_cast<int32_t>(test.random() % 200);
+		int32_t start[5], step[5];
+		for (int a = 0; a < 5; a++)
+		{
+			start[a] = static_cast<int32_t>(test.random() % (260 << 16)) - (4 << 16);
+			step[a] = static_cast<int32_t>(test.random() % (6 << 16)) - (3 << 16);
+		}
+
+		CHECK(test.compare(state, textured, dither, x, y, count, start, step, wrapUV));
+	}
+}
+
+TEST_CASE(rasterizer_gouraud_span)
+{
+	RasterizerTest test;
+	RendererState state = makeState();
+
+	compareSpans(test, state, false, false, false);
+	compareSpans(test, state, false, true, false);
+
+	//Mask Bit Check and Force
+	state.checkMask = true;
+	state.forceMask = true;
+	compareSpans(test, state, false, true, false);
+}
+
+TEST_CASE(rasterizer_textured_span)
+{
+	RasterizerTest test;
+	RendererState state = makeState();
+	state.textured = true;
+
+	for (int mode = 0; mode < 3; mode++)
+	{
+		state.texColorMode = mode;
+		for (int blend = 0; blend < 2; blend++)
+		{
+			state.texBlending = blend;
+			compareSpans(test, state, true, false, false);
+			compareSpans(test, state, true, blend == 1, true);
+		}
+	}
+
+	//Texture Window
+	state.texColorMode = 2;
+	state.texMask = glm::ivec2(0x1c, 0x03);
+	state.texOffset = glm::ivec2(0x0a, 0x11);
+	compareSpans(test, state, true, false, true);
+
+	//Span reading the Texture Page it draws to, drawn one pixel at a time by the Kernel as well
+	state.texMask = glm::ivec2(0, 0);
+	state.texPageCoords = glm::ivec2(0, 0);
+	state.clutTableCoords = glm::ivec2(0, 100);
+	for (int mode = 0; mode < 3; mode++)
+	{
+		state.texColorMode = mode;
+		compareSpans(test, state, true, false, true);
+	}
+}
+
+TEST_CASE(rasterizer_semi_transparent_span)
+{
+	RasterizerTest test;
+	RendererState state = makeState();
+	state.semiTranparent = true;
+
+	for (int mode = 0; mode < 4; mode++)
+	{
+		state.semiTransparentMode = mode;
+		state.textured = false;
+		compareSpans(test, state, false, mode & 1, false);
+
+		state.textured = true;
+		state.texColorMode = mode % 3;
+		state.texBlending = mode < 2;
+		compareSpans(test, state, true, false, true);
+		state.checkMask = (mode == 3);
+		compareSpans(test, state, true, mode == 2, false);
+	}
+}
@@ -0,0 +1,58 @@
+#include <loguru.hpp>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "tests.h"
+#include "spscring.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// spscring - drain() racing with pop() on another thread. Every record is its own write index, once drain()
+// has returned a pop starting afterwards must not return anything pushed before it
+//
+//-------------------------------------------------------------------------------------------------------------
+
+constexpr size_t RING_SIZE = 256;
+constexpr int DRAIN_ROUNDS = 200000;
+
+TEST_CASE(spscring_drain_race)
+{
+	lite::spscring<uint64_t, RING_SIZE> ring;
+	std::atomic<uint64_t> drained{ 0 };		//Write index of the last drain() that returned
+	std::atomic<bool> done{ false };
+	std::atomic<uint64_t> stale{ 0 };
+
+	//Consumer pops one record at a time as the audio callback does with small buffers
+	std::thread consumer([&]()
+	{
+		uint64_t value;
+		while (!done.load(std::memory_order_acquire))
+		{
+			uint64_t limit = drained.load(std::memory_order_acquire);
+			if (ring.pop(&value, 1) == 1 && value < limit)
+				stale.fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	//Producer pushes a few records and drains them right away, as SPU reset and save state load do
+	uint64_t next = 0;
+	for (int round = 0; round < DRAIN_ROUNDS; round++)
+	{
+		uint64_t values[4];
+		size_t count = 1 + (round & 3);
+		for (size_t i = 0; i < count; i++)
+			values[i] = next + i;
+		if (ring.push(values, count))
+			next += count;
+
+		ring.drain();
+		drained.store(next, std::memory_order_release);
+	}
+
+	done.store(true, std::memory_order_release);
+	consumer.join();
+
+	CHECK(stale.load() == 0);
+}
@@ -0,0 +1,43 @@
+#include <loguru.hpp>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "tests.h"
+#include "spumix.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// SPU - SIMD Voice mixing against the scalar reference
+//
+//-------------------------------------------------------------------------------------------------------------
+
+TEST_CASE(spu_mix_voice)
+{
+	alignas(32) int16_t voiceOutput[SPU_VOICE_NUMBER][SPU_BLOCK_SAMPLES];
+	alignas(32) int32_t mixL[SPU_BLOCK_SAMPLES] = {};
+	alignas(32) int32_t mixR[SPU_BLOCK_SAMPLES] = {};
+	alignas(32) int32_t refL[SPU_BLOCK_SAMPLES] = {};
+	alignas(32) int32_t refR[SPU_BLOCK_SAMPLES] = {};
+	std::mt19937 random(44100);
+
+	//Full scale Samples and Volumes, extremes included, all the Voices summed like in a Block
+	const int16_t extremes[] = { -0x8000, -0x7fff, -1, 0, 1, 0x7fff };
+	for (int round = 0; round < 64; round++)
+	{
+		for (int v = 0; v < SPU_VOICE_NUMBER; v++)
+		{
+			for (int i = 0; i < SPU_BLOCK_SAMPLES; i++)
+				voiceOutput[v][i] = (round % 4 == 0) ? extremes[random() % 6] : static_cast<int16_t>(random());
+
+			int16_t volumeL = (round % 2 == 0) ? extremes[random() % 6] : static_cast<int16_t>(random());
+			int16_t volumeR = static_cast<int16_t>(random());
+
+			mixVoice(voiceOutput[v], volumeL, volumeR, mixL, mixR);
+			mixVoiceScalar(voiceOutput[v], volumeL, volumeR, refL, refR);
+		}
+
+		CHECK(std::memcmp(mixL, refL, sizeof(mixL)) == 0);
+		CHECK(std::memcmp(mixR, refR, sizeof(mixR)) == 0);
+	}
+}
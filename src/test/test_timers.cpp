@@ -0,0 +1,177 @@
+#include <loguru.hpp>
+#include <cstdint>
+#include <memory>
+#include <functional>
+
+#include "tests.h"
+#include "psx.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// Timers - Counters read lazily across blanking edges in every Sync Mode
+//
+//-------------------------------------------------------------------------------------------------------------
+
+//Counter Registers
+constexpr uint32_t TMR_VALUE[3] = { 0x1f801100, 0x1f801110, 0x1f801120 };
+constexpr uint32_t TMR_MODE[3] = { 0x1f801104, 0x1f801114, 0x1f801124 };
+
+//Edges are reported at the GPU Tick, within a couple of CPU cycles from the probed ones
+constexpr int EDGE_TOLERANCE = 2;
+
+struct BlankEdges
+{
+	uint64_t	start;		//First Master Clock in blanking
+	uint64_t	end;		//First Master Clock out of it
+};
+
+// Runs the GPU alone one CPU cycle at a time and returns the first blanking period after clock.
+static BlankEdges probeBlank(const std::shared_ptr<Psx>& psx, uint64_t clock, const std::function<bool()>& blank)
+{
+	BlankEdges edges = {};
+	psx->masterClock = clock;
+	psx->syncDevice(SchedulerEvent::Gpu);
+
+	while (blank())
+	{
+		psx->masterClock++;
+		psx->syncDevice(SchedulerEvent::Gpu);
+	}
+	while (!blank())
+	{
+		psx->masterClock++;
+		psx->syncDevice(SchedulerEvent::Gpu);
+	}
+	edges.start = psx->masterClock;
+	while (blank())
+	{
+		psx->masterClock++;
+		psx->syncDevice(SchedulerEvent::Gpu);
+	}
+	edges.end = psx->masterClock;
+
+	return edges;
+}
+
+// Writes Counter Mode at clock and reads the Counter back at read, with nothing in between.
+static uint32_t runCounter(const std::shared_ptr<Psx>& psx, int timer, uint32_t mode, uint64_t clock, uint64_t read, uint32_t* modeRead = nullptr)
+{
+	psx->reset();
+
+	psx->masterClock = clock;
+	psx->wrMem(TMR_MODE[timer], mode);
+
+	psx->masterClock = read;
+	uint32_t value = psx->rdMem(TMR_VALUE[timer]) & 0xffff;
+	if (modeRead != nullptr)
+		*modeRead = psx->rdMem(TMR_MODE[timer]);
+
+	return value;
+}
+
+TEST_CASE(timers_hblank_sync)
+{
+	auto psx = std::make_shared<Psx>();
+	BlankEdges h = probeBlank(psx, 0, [&]() { return psx->gpu->hBlank; });
+	uint64_t read = h.end + 100;
+	uint32_t modeRead = 0;
+
+	CHECK(h.start > 0 && h.end > h.start);
+
+	//Free Run
+	CHECK_NEAR(runCounter(psx, 0, 0x0000, 0, read), read, 0);
+
+	//0 = Pause during hBlank
+	CHECK_NEAR(runCounter(psx, 0, 0x0001, 0, read), read - (h.end - h.start), 2 * EDGE_TOLERANCE);
+
+	//1 = Reset at hBlank
+	CHECK_NEAR(runCounter(psx, 0, 0x0003, 0, read), read - h.start, EDGE_TOLERANCE);
+
+	//2 = Reset at hBlank, pause outside of it
+	CHECK_NEAR(runCounter(psx, 0, 0x0005, 0, read), h.end - h.start, 2 * EDGE_TOLERANCE);
+
+	//3 = Pause until hBlank, then Free Run
+	CHECK_NEAR(runCounter(psx, 0, 0x0007, 0, read, &modeRead), read - h.start, EDGE_TOLERANCE);
+	CHECK((modeRead & 0x0001) == 0);
+}
+
+TEST_CASE(timers_vblank_sync)
+{
+	auto psx = std::make_shared<Psx>();
+	BlankEdges v = probeBlank(psx, 0, [&]() { return psx->gpu->vBlank; });
+	uint64_t write = v.start - 3000;
+	uint64_t read = v.end + 500;
+	uint32_t modeRead = 0;
+
+	CHECK(v.start > 3000 && v.end > v.start);
+
+	//0 = Pause during vBlank
+	CHECK_NEAR(runCounter(psx, 1, 0x0001, write, read), 3500, 2 * EDGE_TOLERANCE);
+
+	//1 = Reset at vBlank
+	CHECK_NEAR(runCounter(psx, 1, 0x0003, write, read), read - v.start, EDGE_TOLERANCE);
+
+	//2 = Reset at vBlank, pause outside of it
+	CHECK_NEAR(runCounter(psx, 1, 0x0005, write, read), v.end - v.start, 2 * EDGE_TOLERANCE);
+
+	//3 = Pause until vBlank, then Free Run
+	CHECK_NEAR(runCounter(psx, 1, 0x0007, write, read, &modeRead), read - v.start, EDGE_TOLERANCE);
+	CHECK((modeRead & 0x0001) == 0);
+}
+
+TEST_CASE(timers_lazy_read)
+{
+	auto psx = std::make_shared<Psx>();
+
+	//Counters are evaluated only when read, whatever the time elapsed since the last access
+	CHECK_NEAR(runCounter(psx, 1, 0x0000, 1000, 61000), 60000, 0);
+	CHECK_NEAR(runCounter(psx, 2, 0x0200, 0, 8000), 1000, 1);
+	CHECK_NEAR(runCounter(psx, 2, 0x0200, 0, 8 * 0x10000 + 800), 100, 1);
+}
+
+TEST_CASE(timers_toggle_laps)
+{
+	auto psx = std::make_shared<Psx>();
+	uint32_t target = 0x00ff;
+	uint32_t mode = 0x00d8;		//Reset at Target, IRQ on Target, Repeat, Toggle
+
+	//Counter 2 reaches Target on every 256 cycles, several laps go by between two reads
+	for (uint32_t laps = 1; laps <= 4; laps++)
+	{
+		psx->reset();
+		psx->wrMem(0x1f801128, target);
+		psx->wrMem(TMR_MODE[2], mode);
+
+		psx->masterClock = laps * 0x100 + 0x10;
+		uint32_t modeRead = psx->rdMem(TMR_MODE[2]);
+		uint32_t irqStatus = psx->rdMem(0x1f801070);
+
+		//Bit 10 flips on every lap, the IRQ is thrown whenever it goes to 0
+		CHECK(((modeRead >> 10) & 1) == (laps & 1 ? 0u : 1u));
+		CHECK((irqStatus & (1 << 6)) != 0);
+		CHECK_NEAR(psx->rdMem(TMR_VALUE[2]) & 0xffff, 0x10, 1);
+	}
+}
+
+TEST_CASE(timers_irq_after_edge)
+{
+	auto psx = std::make_shared<Psx>();
+	BlankEdges v = probeBlank(psx, 0, [&]() { return psx->gpu->vBlank; });
+	uint32_t target = 100;
+	uint32_t mode = 0x0015;		//Reset at vBlank and pause outside of it, IRQ on Target
+
+	CHECK(v.start > 3000 && v.end > v.start + 1000);
+
+	psx->reset();
+	psx->masterClock = v.start - 3000;
+	psx->wrMem(0x1f801118, target);
+	psx->wrMem(TMR_MODE[1], mode);
+
+	//The GPU catches up well past the edge, Counter 1 hits Target on the way and its event is already due
+	psx->masterClock = v.start + 1000;
+	psx->syncDevice(SchedulerEvent::Gpu);
+	while (psx->scheduler->nextTimestamp() <= psx->masterClock)
+		psx->syncDevice(psx->scheduler->nextEvent());
+
+	CHECK((psx->rdMem(0x1f801070) & (1 << 5)) != 0);
+}
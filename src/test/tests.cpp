@@ -0,0 +1,54 @@
+#include <loguru.hpp>
+#include <cstdlib>
+#include <cstring>
+
+#include "tests.h"
+#include "renderer.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// psxemu_tests - runs the test cases named on the command line, all of them when none is given.
+// Exit code is non zero when any check fails.
+//
+//-------------------------------------------------------------------------------------------------------------
+
+int testFailures = 0;
+
+std::vector<TestCase>& testCases()
+{
+	static std::vector<TestCase> cases;
+	return cases;
+}
+
+int main(int argc, char* argv[])
+{
+	//Init Log Library, only errors are of interest
+	loguru::init(argc, argv);
+	loguru::g_stderr_verbosity = loguru::Verbosity_ERROR;
+
+	//No OpenGL, primitives are rasterized on the CPU
+	Renderer::SetBackend(RendererBackend::Software, true);
+
+	int run = 0;
+	for (auto& test : testCases())
+	{
+		bool selected = (argc < 2);
+		for (int i = 1; i < argc; i++)
+			selected |= (std::strcmp(argv[i], test.name) == 0);
+		if (!selected)
+			continue;
+
+		int failures = testFailures;
+		test.run();
+		printf("%s: %s\n", test.name, (testFailures == failures) ? "passed" : "FAILED");
+		run++;
+	}
+
+	if (run == 0)
+	{
+		LOG_F(ERROR, "TEST - No test case matches the command line!");
+		return EXIT_FAILURE;
+	}
+
+	return (testFailures > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// Minimal self registering test cases for psxemu_tests, each one can be run alone by name.
+//
+//-------------------------------------------------------------------------------------------------------------
+
+struct TestCase
+{
+	const char*	name;
+	void		(*run)();
+};
+
+std::vector<TestCase>& testCases();
+extern int testFailures;
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static const bool name##Registered = (testCases().push_back({ #name, name }), true); \
+	static void name()
+
+#define CHECK(cond) \
+	do { if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); testFailures++; } } while (0)
+
+#define CHECK_NEAR(value, expected, tolerance) \
+	do { int64_t v_ = static_cast<int64_t>(value), e_ = static_cast<int64_t>(expected); \
+		if (v_ < e_ - (tolerance) || v_ > e_ + (tolerance)) { fprintf(stderr, "%s:%d: CHECK_NEAR(%s) failed, %lld expected %lld\n", __FILE__, __LINE__, #value, (long long)v_, (long long)e_); testFailures++; } } while (0)
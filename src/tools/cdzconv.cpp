@@ -0,0 +1,97 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "libcdimage.h"
+#include "cdzimage.h"
+
+//-------------------------------------------------------------------------------------------------------------
+//
+// cdzconv - compresses a .bin/.cue CD image into the block compressed .cdz format read by CdImage.
+// With --verify the result is read back sector by sector against the source, and the mean hunk
+// load time is compared with one sector period at 2x speed (1/150 s). The worst one is only
+// reported, it mostly measures the disk.
+//
+// usage: cdzconv <source .bin|.cue> <output .cdz> [--level <0-9>] [--verify]
+//
+//-------------------------------------------------------------------------------------------------------------
+
+static char* getArgument(int argc, char* argv[], const std::string& cmd)
+{
+	char** end = argv + argc;
+	char** p = std::find(argv, end, cmd);
+
+	return (p != end && (p + 1) != end) ? *(p + 1) : nullptr;
+}
+
+static bool verify(const std::string& sourceFile, const std::string& cdzFile)
+{
+	CdImage source;
+	CdzImage compressed;
+	if (!source.openImage(sourceFile) || !compressed.open(cdzFile))
+	{
+		fprintf(stderr, "CDZCONV - Unable to open images for verification!\n");
+		return false;
+	}
+
+	//Every hunk is decompressed once, sectors are read in order
+	double totalHunks = 0.0;
+	double worstHunk = 0.0;
+	uint32_t lba = source.getSectorInfo().lba;
+	for (uint32_t i = 0; i < compressed.getSectorCount(); i++)
+	{
+		uint64_t misses = compressed.getCacheMisses();
+		auto start = std::chrono::steady_clock::now();
+		std::span<const uint8_t> sector = compressed.readSector(i);
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (compressed.getCacheMisses() != misses)
+		{
+			totalHunks += elapsed;
+			worstHunk = std::max(worstHunk, elapsed);
+		}
+
+		std::span<const uint8_t> expected = source.getSectorRaw(lba + i);
+		if (sector.empty() || expected.empty() || std::memcmp(sector.data(), expected.data(), sector_size) != 0)
+		{
+			fprintf(stderr, "CDZCONV - Sector %u doesn't match the source!\n", i);
+			return false;
+		}
+	}
+
+	constexpr double sectorPeriod = 1.0 / 150.0;
+	double meanHunk = totalHunks / std::max<uint64_t>(compressed.getCacheMisses(), 1);
+	printf("verified %u sectors, hunk load mean %.1f us, worst %.1f us (sector period at 2x %.1f us)\n",
+		compressed.getSectorCount(), meanHunk * 1e6, worstHunk * 1e6, sectorPeriod * 1e6);
+
+	return meanHunk < sectorPeriod;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: cdzconv <source .bin|.cue> <output .cdz> [--level <0-9>] [--verify]\n");
+		return EXIT_FAILURE;
+	}
+
+	std::string sourceFile = argv[1];
+	std::string cdzFile = argv[2];
+	char* levelArg = getArgument(argc, argv, "--level");
+	int level = (levelArg != nullptr) ? std::clamp(std::atoi(levelArg), 0, 9) : 9;
+
+	if (!CdzImage::convert(sourceFile, cdzFile, level))
+	{
+		fprintf(stderr, "CDZCONV - Unable to convert %s!\n", sourceFile.c_str());
+		return EXIT_FAILURE;
+	}
+
+	if (std::find(argv, argv + argc, std::string("--verify")) != argv + argc && !verify(sourceFile, cdzFile))
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}